@@ -0,0 +1,31 @@
+/* JTAG stream on an Intel virtual JTAG instance: add jtagStream.v to
+ * the design. Must be the only virtual JTAG instance (same hub
+ * configuration as spiOverJtag), stream is selected when
+ * ir_in[8] is set (virtual IR 0x100)
+ * host: Altera::open_stream()
+ */
+module altera_jtagStream ();
+	wire       tdi, tdo, tck;
+	wire [8:0] ir_in;
+	wire       vs_cdr, vs_sdr;
+
+	sld_virtual_jtag #(.sld_auto_instance_index("YES"),
+		.sld_instance_index(0), .sld_ir_width (9)
+	) jtag_ctrl (
+		.tdi(tdi), .tdo(tdo), .tck(tck), .ir_in(ir_in),
+		.virtual_state_cdr(vs_cdr), .virtual_state_sdr(vs_sdr));
+
+	/* virtual state are updated on rising edge
+	 *                and sampled at falling edge
+	 *  => latch on negedge to use after on rising edge
+	 */
+	reg sdr_d, cdr_d;
+	always @(negedge tck) begin
+		sdr_d <= vs_sdr && ir_in[8];
+		cdr_d <= vs_cdr && ir_in[8];
+	end
+
+	jtagStream_loopback loopback (
+		.tck(tck), .capture(cdr_d), .shift(sdr_d),
+		.tdi(tdi), .tdo(tdo));
+endmodule
@@ -0,0 +1,114 @@
+/* JTAG stream: byte stream between host and FPGA through a USER data
+ * register (host side: src/jtagStream.hpp).
+ * The register is a sequence of 10 bits slots, LSB first, restarting at
+ * Capture-DR:
+ *  - TDI: valid, data[7:0], reserved
+ *  - TDO: ready, valid, data[7:0]
+ * A host byte sent when ready is low is dropped and all following bytes
+ * are dropped until next Capture-DR (host sends them again). The first
+ * slot after Capture-DR is ignored (delay from bypassed devices).
+ * Everything is in TCK domain: use asynchronous FIFOs to exchange data
+ * with the user clock domain.
+ */
+module jtagStream (
+	input            tck,
+	input            capture,   // Capture-DR, register selected
+	input            shift,     // Shift-DR, register selected
+	input            tdi,
+	output           tdo,
+	/* host -> FPGA */
+	output reg [7:0] rx_data,
+	output reg       rx_valid,  // one TCK cycle
+	input            rx_ready,  // room for 2 Bytes at least
+	/* FPGA -> host */
+	input      [7:0] tx_data,
+	input            tx_valid,
+	output           tx_ready   // tx_data consumed
+);
+	reg [3:0] cnt;
+	reg       first, stall;
+	reg       slot_ready, slot_valid;
+	reg [7:0] slot_data;
+	reg [8:0] in_s;
+
+	initial begin
+		slot_valid = 1'b0;
+		rx_valid   = 1'b0;
+	end
+
+	wire slot_end = shift && (cnt == 4'd9);
+	/* byte in flight is kept until its slot is complete:
+	 * an interrupted slot is sent again after next Capture-DR
+	 */
+	wire load = (capture && !slot_valid) || slot_end;
+	assign tx_ready = load && tx_valid;
+
+	always @(posedge tck) begin
+		rx_valid <= 1'b0;
+		if (capture) begin
+			cnt        <= 4'd0;
+			first      <= 1'b1;
+			stall      <= 1'b0;
+			slot_ready <= rx_ready;
+		end else if (shift) begin
+			if (cnt <= 4'd8)
+				in_s[cnt] <= tdi;
+			/* refused byte: drop all next ones */
+			if (cnt == 4'd0 && tdi && !first && !slot_ready)
+				stall <= 1'b1;
+			if (cnt == 4'd9) begin
+				if (!first && in_s[0] && slot_ready) begin
+					rx_data  <= in_s[8:1];
+					rx_valid <= 1'b1;
+				end
+				slot_ready <= rx_ready && !stall;
+				first      <= 1'b0;
+				cnt        <= 4'd0;
+			end else begin
+				cnt <= cnt + 4'd1;
+			end
+		end
+		if (load) begin
+			slot_valid <= tx_valid;
+			slot_data  <= tx_data;
+		end
+	end
+
+	assign tdo = (cnt == 4'd0) ? slot_ready :
+	             (cnt == 4'd1) ? slot_valid : slot_data[cnt - 4'd2];
+endmodule
+
+/* reference use: bytes sent by the host are sent back */
+module jtagStream_loopback #(
+	parameter DEPTH_LOG2 = 4
+) (
+	input  tck,
+	input  capture,
+	input  shift,
+	input  tdi,
+	output tdo
+);
+	localparam DEPTH = 1 << DEPTH_LOG2;
+	reg [7:0]          fifo [0:DEPTH-1];
+	reg [DEPTH_LOG2:0] wr_ptr = 0, rd_ptr = 0;
+	wire [DEPTH_LOG2:0] level = wr_ptr - rd_ptr;
+
+	wire [7:0] rx_data;
+	wire       rx_valid, tx_ready;
+
+	jtagStream stream (
+		.tck(tck), .capture(capture), .shift(shift), .tdi(tdi), .tdo(tdo),
+		.rx_data(rx_data), .rx_valid(rx_valid),
+		.rx_ready(level <= DEPTH - 2),
+		.tx_data(fifo[rd_ptr[DEPTH_LOG2-1:0]]), .tx_valid(level != 0),
+		.tx_ready(tx_ready));
+
+	always @(posedge tck) begin
+		if (rx_valid) begin
+			fifo[wr_ptr[DEPTH_LOG2-1:0]] <= rx_data;
+			wr_ptr <= wr_ptr + 1'b1;
+		end
+		if (tx_ready)
+			rd_ptr <= rd_ptr + 1'b1;
+	end
+endmodule
@@ -0,0 +1,33 @@
+/* JTAG stream on a Xilinx USER register (USER3 by default, USER1/USER2
+ * are used by spiOverJtag): add jtagStream.v to the design
+ * host: Xilinx::open_stream(3)
+ */
+module xilinx_jtagStream #(
+	parameter JTAG_CHAIN = 3
+) ();
+	wire capture, sel, shift, tck, tdi, tdo;
+
+`ifdef spartan6
+	BSCAN_SPARTAN6 #(
+`else
+	BSCANE2 #(
+`endif
+		.JTAG_CHAIN(JTAG_CHAIN)  // Value for USER command.
+	) bscan_inst (
+		.CAPTURE(capture), // 1-bit output: CAPTURE output from TAP controller.
+		.DRCK   (),        // 1-bit output: Gated TCK output.
+		.RESET  (),        // 1-bit output: Reset output for TAP controller.
+		.RUNTEST(),        // 1-bit output: TAP controller in Run Test/Idle.
+		.SEL    (sel),     // 1-bit output: USER instruction active output.
+		.SHIFT  (shift),   // 1-bit output: SHIFT output from TAP controller.
+		.TCK    (tck),     // 1-bit output: Test Clock output.
+		.TDI    (tdi),     // 1-bit output: Test Data Input (TDI) output.
+		.TMS    (),        // 1-bit output: Test Mode Select output.
+		.UPDATE (),        // 1-bit output: UPDATE output from TAP controller
+		.TDO    (tdo)      // 1-bit input: Test Data Output (TDO) input.
+	);
+
+	jtagStream_loopback loopback (
+		.tck(tck), .capture(capture && sel), .shift(shift && sel),
+		.tdi(tdi), .tdo(tdo));
+endmodule
@@ -7,12 +7,16 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <string>
 
+#include "bufferPool.hpp"
 #include "common.hpp"
 #include "jtag.hpp"
+#include "jtagStream.hpp"
 #include "device.hpp"
 #include "epcq.hpp"
+#include "pofParser.hpp"
 #include "progressBar.hpp"
 #include "rawParser.hpp"
 #if defined (_WIN64) || defined (_WIN32)
@@ -22,8 +26,12 @@
 #define IDCODE 6
 #define USER0  0x0C
 #define USER1  0x0E
+/* virtual IR selecting spiOverJtag/altera_jtagStream.v */
+#define STREAM_VIR 0x100
 #define BYPASS 0x3FF
 #define IRLENGTH 10
+/* max Bytes shifted in one JTAG access by spi_put */
+#define SPI_CHUNK_LEN 0x10000
 
 Altera::Altera(Jtag *jtag, const std::string &filename,
 	const std::string &file_type, Device::prog_type_t prg_type,
@@ -48,6 +56,10 @@ Altera::Altera(Jtag *jtag, const std::string &filename,
 					_mode = Device::MEM_MODE;
 				else
 					_mode = Device::SPI_MODE;
+			} else if (_file_extension == "jic" ||
+					_file_extension == "pof") {
+				/* flash image: always written to the flash */
+				_mode = Device::SPI_MODE;
 			} else { // unknown type -> sanity check
 				if (prg_type == Device::WR_SRAM) {
 					printError("file has an unknown type:");
@@ -210,10 +222,10 @@ bool Altera::load_bridge()
 	return true;
 }
 
-void Altera::program(unsigned int offset, bool unprotect_flash)
+bool Altera::program(unsigned int offset, bool unprotect_flash)
 {
 	if (_mode == Device::NONE_MODE)
-		return;
+		return true;
 	/* in all case we consider svf is mandatory
 	 * MEM_MODE : svf file provided for constructor
 	 *            is the bitstream to use
@@ -231,23 +243,51 @@ void Altera::program(unsigned int offset, bool unprotect_flash)
 		if (_file_extension == "rbf" || _file_extension == "rpd")
 			reverseOrder = true;
 
-		/* prepare data to write */
-		uint8_t *data = NULL;
-		int length = 0;
+		const bool is_pof = (_file_extension == "jic" ||
+				_file_extension == "pof");
 
-		RawParser bit(_filename, reverseOrder);
+		ConfigBitstreamParser *bit = NULL;
 		try {
-			bit.parse();
-			data = bit.getData();
-			length = bit.getLength() / 8;
+			if (is_pof)
+				bit = new POFParser(_filename, _verbose > 0);
+			else
+				bit = new RawParser(_filename, reverseOrder);
 		} catch (std::exception &e) {
 			printError(e.what());
 			throw std::runtime_error(e.what());
 		}
 
-		if (!SPIInterface::write(offset, data, length, unprotect_flash))
-			throw std::runtime_error("Fail to write data");
+		/* prepare data to write */
+		uint8_t *data = NULL;
+		int length = 0;
+		if (bit->parse() == EXIT_FAILURE) {
+			delete bit;
+			throw std::runtime_error("Failed to parse " + _filename);
+		}
+		if (!is_pof) {
+			data = bit->getData();
+			length = bit->getLength() / 8;
+		} else {
+			/* flash content is stored in the cfg data packet
+			 * with the byte order expected by the FPGA: same as rbf
+			 */
+			data = static_cast<POFParser *>(bit)->getFlashData(&length);
+			if (!data) {
+				delete bit;
+				throw std::runtime_error("no flash data in " + _filename);
+			}
+			for (int i = 0; i < length; i++)
+				data[i] = RawParser::reverseByte(data[i]);
+		}
+
+		bool ret = SPIInterface::write(offset, data, length, unprotect_flash);
+		delete bit;
+		if (!ret) {
+			printError("Fail to write data");
+			return false;
+		}
 	}
+	return true;
 }
 
 int Altera::idCode()
@@ -266,27 +306,52 @@ int Altera::idCode()
 
 /* SPI interface */
 
+SPIFlash *Altera::new_flash(bool unprotect)
+{
+	return new EPCQ(this, unprotect, _verbose);
+}
+
 int Altera::spi_put(uint8_t cmd, uint8_t *tx, uint8_t *rx, uint32_t len)
 {
 	/* +1 because send first cmd + len byte + 1 for rx due to a delay of
 	 * one bit
 	 */
-	int xfer_len = len + 1 + ((rx == NULL) ? 0 : 1);
-	uint8_t jtx[xfer_len];
-	uint8_t jrx[xfer_len];
-
-	if (tx != NULL) {
-		for (uint32_t i = 0; i < len; i++)
-			jtx[i] = RawParser::reverseByte(tx[i]);
-	}
+	const uint32_t xfer_len = len + 1 + ((rx == NULL) ? 0 : 1);
+	/* large transfers (full flash read) are shifted by chunks: TAP
+	 * stays in Shift-DR between chunks so the SPI transaction continues
+	 */
+	const uint32_t chunk_len = std::min(xfer_len, (uint32_t)SPI_CHUNK_LEN);
+	BufferPool::Buffer jtx(chunk_len);
+	/* jrx[0]: last Byte of previous chunk (rx Bytes are one bit late) */
+	BufferPool::Buffer jrx(chunk_len + 1);
 
 	shiftVIR(RawParser::reverseByte(cmd));
-	shiftVDR(jtx, (rx) ? jrx : NULL, 8 * xfer_len);
 
-	if (rx) {
-		for (uint32_t i = 0; i < len; i++) {
-			rx[i] = RawParser::reverseByte(jrx[i+1] >> 1) | (jrx[i+2] & 0x01);
+	for (uint32_t pos = 0; pos < xfer_len; pos += chunk_len) {
+		const uint32_t n = std::min(chunk_len, xfer_len - pos);
+		const int end_state = (pos + n == xfer_len) ? Jtag::UPDATE_DR :
+			Jtag::SHIFT_DR;
+
+		for (uint32_t i = 0; i < n; i++) {
+			jtx[i] = (tx != NULL && pos + i < len) ?
+				RawParser::reverseByte(tx[pos + i]) : 0;
+		}
+
+		if (pos == 0)
+			shiftVDR(jtx, (rx) ? &jrx[1] : NULL, 8 * n, end_state);
+		else
+			_jtag->shiftDR(jtx, (rx) ? &jrx[1] : NULL, 8 * n, end_state);
+
+		if (!rx)
+			continue;
+		/* rx[i] is built with received Bytes i+1 and i+2 */
+		for (uint32_t b = std::max(pos, (uint32_t)2); b < pos + n; b++) {
+			if (b - 2 >= len)
+				break;
+			rx[b - 2] = RawParser::reverseByte(jrx[b - pos] >> 1) |
+				(jrx[b - pos + 1] & 0x01);
 		}
+		jrx[0] = jrx[n];
 	}
 
 	return 0;
@@ -335,6 +400,17 @@ int Altera::spi_wait(uint8_t cmd, uint8_t mask, uint8_t cond,
 	return 0;
 }
 
+JtagStream *Altera::open_stream(int channel)
+{
+	(void)channel;
+	/* virtual IR is kept by the hub: only USER0 is needed next */
+	shiftVIR(STREAM_VIR);
+	return new JtagStream(_jtag, [this]() {
+			uint8_t tx_ir[2] = {USER0, 0};
+			_jtag->shiftIR_cached(tx_ir, IRLENGTH, Jtag::UPDATE_IR);
+		}, _verbose);
+}
+
 /* VIrtual Jtag Access */
 void Altera::shiftVIR(uint32_t reg)
 {
@@ -346,7 +422,7 @@ void Altera::shiftVIR(uint32_t reg)
 
 	_jtag->set_state(Jtag::RUN_TEST_IDLE);
 
-	_jtag->shiftIR(tx_ir, NULL, IRLENGTH, Jtag::UPDATE_IR);
+	_jtag->shiftIR_cached(tx_ir, IRLENGTH, Jtag::UPDATE_IR);
 	/* len + 1 + 1 => IRLENGTH + Slave ID + 1 (ASMI/SFL) */
 	_jtag->shiftDR(tx, NULL, len/* + 2*/, Jtag::UPDATE_DR);
 }
@@ -356,6 +432,6 @@ void Altera::shiftVDR(uint8_t * tx, uint8_t * rx, uint32_t len,
 {
 	(void) debug;
 	uint8_t tx_ir[2] = {USER0, 0};
-	_jtag->shiftIR(tx_ir, NULL, IRLENGTH, Jtag::UPDATE_IR);
+	_jtag->shiftIR_cached(tx_ir, IRLENGTH, Jtag::UPDATE_IR);
 	_jtag->shiftDR(tx, rx, len, end_state);
 }
@@ -26,7 +26,7 @@ class Altera: public Device, SPIInterface {
 		~Altera();
 
 		void programMem(RawParser &_bit);
-		void program(unsigned int offset, bool unprotect_flash) override;
+		bool program(unsigned int offset, bool unprotect_flash) override;
 		/*!
 		 * \brief read len Byte starting at base_addr and store
 		 *        into filename
@@ -42,10 +42,27 @@ class Altera: public Device, SPIInterface {
 		int idCode() override;
 		void reset() override;
 
+		/*!
+		 * \brief open a byte stream through virtual JTAG instance
+		 *        (channel is not used)
+		 */
+		JtagStream *open_stream(int channel) override;
+
 		/*************************/
 		/*     spi interface     */
 		/*************************/
 
+		/*!
+		 * \brief write partitions with a content different
+		 *        from SPI flash
+		 */
+		bool program_layout(FlashLayout &layout,
+				bool unprotect_flash) override {
+			return SPIInterface::write(layout, unprotect_flash);
+		}
+		void set_verify_repair(bool repair) override {
+			set_spif_repair(repair);
+		}
 		/*!
 		 * \brief protect SPI flash blocks
 		 */
@@ -74,6 +91,10 @@ class Altera: public Device, SPIInterface {
 	protected:
 		bool prepare_flash_access() override;
 		bool post_flash_access() override;
+		/*!
+		 * \brief active serial flash (EPCS/EPCQ) driver
+		 */
+		SPIFlash *new_flash(bool unprotect) override;
 
 	private:
 		/*!
@@ -9,6 +9,7 @@
 
 #include "anlogic.hpp"
 #include "anlogicBitParser.hpp"
+#include "bufferPool.hpp"
 #include "jtag.hpp"
 #include "device.hpp"
 #include "display.hpp"
@@ -59,17 +60,17 @@ void Anlogic::reset()
 	_jtag->toggleClk(200000);
 }
 
-void Anlogic::program(unsigned int offset, bool unprotect_flash)
+bool Anlogic::program(unsigned int offset, bool unprotect_flash)
 {
 	if (_mode == Device::NONE_MODE)
-		return;
+		return true;
 
 	AnlogicBitParser bit(_filename, (_mode == Device::MEM_MODE), _verbose);
 
 	printInfo("Parse file ", false);
 	if (bit.parse() == EXIT_FAILURE) {
 		printError("FAIL");
-		return;
+		return false;
 	}
 
 	printSuccess("DONE");
@@ -80,10 +81,9 @@ void Anlogic::program(unsigned int offset, bool unprotect_flash)
 	uint8_t *data = bit.getData();
 	int len = bit.getLength() / 8;
 
-	if (_mode == Device::SPI_MODE) {
-		SPIInterface::write(offset, data, len, unprotect_flash);
-		return;
-	}
+	if (_mode == Device::SPI_MODE)
+		return SPIInterface::write(offset, data, len, unprotect_flash);
+
 
 	if (_mode == Device::MEM_MODE) {
 
@@ -141,6 +141,7 @@ void Anlogic::program(unsigned int offset, bool unprotect_flash)
 		_jtag->shiftIR(BYPASS, IRLENGTH);
 		_jtag->toggleClk(15);
 	}
+	return true;
 }
 
 int Anlogic::idCode()
@@ -189,8 +190,8 @@ int Anlogic::spi_put(uint8_t cmd, uint8_t *tx, uint8_t *rx, uint32_t len)
 	int xfer_len = len + 1;
 	if (rx)
 		xfer_len++;
-	uint8_t jtx[xfer_len];
-	uint8_t jrx[xfer_len];
+	BufferPool::Buffer jtx(xfer_len);
+	BufferPool::Buffer jrx(xfer_len);
 
 	jtx[0] = AnlogicBitParser::reverseByte(cmd);
 	if (tx != NULL) {
@@ -202,7 +203,7 @@ int Anlogic::spi_put(uint8_t cmd, uint8_t *tx, uint8_t *rx, uint32_t len)
 	uint8_t op = 0x60;
 	_jtag->shiftDR(&op, NULL, 8);
 
-	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx, 8*xfer_len);
+	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx.data(), 8*xfer_len);
 	if (rx != NULL) {
 		for (uint32_t i=0; i < len; i++)
 			rx[i] = AnlogicBitParser::reverseByte(jrx[i+1]>>1)
@@ -215,8 +216,8 @@ int Anlogic::spi_put(uint8_t *tx, uint8_t *rx, uint32_t len)
 	int xfer_len = len;
 	if (rx)
 		xfer_len++;
-	uint8_t jtx[xfer_len];
-	uint8_t jrx[xfer_len];
+	BufferPool::Buffer jtx(xfer_len);
+	BufferPool::Buffer jrx(xfer_len);
 
 	if (tx != NULL) {
 		for (uint32_t i = 0; i < len; i++)
@@ -227,7 +228,7 @@ int Anlogic::spi_put(uint8_t *tx, uint8_t *rx, uint32_t len)
 	uint8_t op = 0x60;
 	_jtag->shiftDR(&op, NULL, 8);
 
-	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx, 8*xfer_len);
+	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx.data(), 8*xfer_len);
 	if (rx != NULL) {
 		for (uint32_t i=0; i < len; i++)
 			rx[i] = AnlogicBitParser::reverseByte(jrx[i]>>1) |
@@ -21,11 +21,22 @@ class Anlogic: public Device, SPIInterface {
 			Device::prog_type_t prg_type, bool verify, int8_t verbose);
 		~Anlogic();
 
-		void program(unsigned int offset, bool unprotect_flash) override;
+		bool program(unsigned int offset, bool unprotect_flash) override;
 		int idCode() override;
 		void reset() override;
 
 		/* spi interface */
+		/*!
+		 * \brief write partitions with a content different
+		 *        from SPI flash
+		 */
+		bool program_layout(FlashLayout &layout,
+				bool unprotect_flash) override {
+			return SPIInterface::write(layout, unprotect_flash);
+		}
+		void set_verify_repair(bool repair) override {
+			set_spif_repair(repair);
+		}
 		/*!
 		 * \brief protect SPI flash blocks
 		 */
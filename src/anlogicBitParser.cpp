@@ -80,39 +80,47 @@ int AnlogicBitParser::parse()
 	if ((end_header = parseHeader()) == -1)
 		return EXIT_FAILURE;
 
-	unsigned int pos = end_header;
-	std::vector<std::vector<uint8_t>> blocks;
+	/* data are a list of blocks: length (16bits, big endian, in bits)
+	 * followed by content. First pass: check headers and compute
+	 * total size
+	 */
+	const uint8_t *raw = reinterpret_cast<const uint8_t *>(_raw_data.data());
+	const size_t raw_size = _raw_data.size();
+	size_t total = 0;
+	size_t pos = end_header;
 	do {
-		uint16_t len = (((uint16_t)_raw_data[pos]) << 8) |
-			(0xff & (uint16_t)_raw_data[pos + 1]);
-
+		if (pos + 2 > raw_size) {
+			printError("Error: truncated block length");
+			return EXIT_FAILURE;
+		}
+		uint16_t len = (static_cast<uint16_t>(raw[pos]) << 8) | raw[pos + 1];
 		pos += 2;
 		if ((len & 7) != 0) {
-			printf("error\n");
+			printError("Error: block length not a multiple of 8 bits");
 			return EXIT_FAILURE;
 		}
 		len >>= 3;
-		if ((pos + len) > _raw_data.size()) {
-			printf("error\n");
+		if ((pos + len) > raw_size) {
+			printError("Error: truncated block");
 			return EXIT_FAILURE;
 		}
-
-		std::vector<uint8_t> block = std::vector<uint8_t>(_raw_data.begin() + pos,
-			_raw_data.begin() + pos + len);
-		blocks.push_back(block);
-
+		total += len;
+		pos += len;
+	} while (pos < raw_size);
+
+	/* second pass: copy (or reverse) blocks content in place */
+	_bit_data.resize(total);
+	uint8_t *out = reinterpret_cast<uint8_t *>(&_bit_data[0]);
+	pos = end_header;
+	while (pos < raw_size) {
+		size_t len = ((static_cast<size_t>(raw[pos]) << 8) | raw[pos + 1]) >> 3;
+		pos += 2;
+		if (_reverseOrder)
+			reverseBytes(raw + pos, out, len);
+		else
+			memcpy(out, raw + pos, len);
+		out += len;
 		pos += len;
-	} while (pos < _raw_data.size());
-
-
-	_bit_data.clear();
-	for (auto it = blocks.begin(); it != blocks.end(); it++) {
-		for (size_t xpos = 0; xpos < it->size(); xpos++) {
-			if (_reverseOrder == true)
-				_bit_data += reverseByte(((*it)[xpos]));
-			else
-				_bit_data += ((*it)[xpos]);
-		}
 	}
 	_bit_length = _bit_data.size() * 8;
 
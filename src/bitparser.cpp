@@ -66,19 +66,32 @@ int BitParser::parseHeader()
 		pos_data += length;
 
 		switch (type) {
-			case 'a': /* design name:userid:synthesize tool version */
+			case 'a': /* design name;[PARTIAL=TRUE;]UserID=xx;Version=xx */
 				prev_pos = 0;
 				pos = tmp.find(";");
 				_hdr["design_name"] = tmp.substr(prev_pos, pos);
-				prev_pos = pos+1;
 
-				pos = tmp.find(";", prev_pos);
-				prev_pos = tmp.find("=", prev_pos) + 1;
-				_hdr["userID"] = tmp.substr(prev_pos, pos-prev_pos);
-				prev_pos = pos+1;
-
-				prev_pos = tmp.find("=", prev_pos) + 1;
-				_hdr["toolVersion"] = tmp.substr(prev_pos, length-prev_pos);
+				/* next fields are key=value */
+				while (pos != -1) {
+					prev_pos = pos + 1;
+					pos = tmp.find(";", prev_pos);
+					string field = tmp.substr(prev_pos,
+						(pos == -1) ? string::npos : pos - prev_pos);
+					size_t eq = field.find("=");
+					if (eq == string::npos)
+						continue;
+					string key = field.substr(0, eq);
+					string val = field.substr(eq + 1);
+					val = val.substr(0, val.find('\0'));
+					if (key == "UserID")
+						_hdr["userID"] = val;
+					else if (key == "Version")
+						_hdr["toolVersion"] = val;
+					else if (key == "PARTIAL")
+						_hdr["partial"] = val;
+					else
+						_hdr[key] = val;
+				}
 				break;
 			case 'b': /* FPGA model */
 				_hdr["part_name"] = tmp.substr(0, length);
@@ -126,9 +139,8 @@ int BitParser::parse()
 	std::move(_raw_data.begin() + pos, _raw_data.begin() + pos + _bit_length, _bit_data.begin());
 
 	if (_reverseOrder) {
-		for (int i = 0; i < _bit_length; i++) {
-			_bit_data[i] = reverseByte(_bit_data[i]);
-		}
+		uint8_t *data = reinterpret_cast<uint8_t *>(&_bit_data[0]);
+		reverseBytes(data, data, _bit_length);
 	}
 
 	/* convert size to bit */
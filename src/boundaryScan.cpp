@@ -0,0 +1,296 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#include <string.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "boundaryScan.hpp"
+#include "bsdlParser.hpp"
+#include "display.hpp"
+#include "jtag.hpp"
+#include "jtagInterface.hpp"
+
+/* TCK cycles sent by writeTMSTDI call in continuous sampling */
+#define BS_BATCH_CYCLES 32768
+
+static inline uint8_t get_bit(const uint8_t *buf, uint32_t pos)
+{
+	return (buf[pos >> 3] >> (pos & 0x07)) & 0x01;
+}
+
+static inline void set_bit(uint8_t *buf, uint32_t pos, uint8_t val)
+{
+	if (val)
+		buf[pos >> 3] |= (1 << (pos & 0x07));
+	else
+		buf[pos >> 3] &= ~(1 << (pos & 0x07));
+}
+
+BoundaryScan::BoundaryScan(Jtag *jtag, const std::vector<BsdlParser *> &bsdl,
+		int8_t verbose): _jtag(jtag), _verbose(verbose), _dr_len(0),
+		_ir_len(0)
+{
+	std::vector<int> idcodes = _jtag->get_devices_list();
+	std::vector<int16_t> irlengths = _jtag->get_irlength_list();
+	int nb_dev = idcodes.size();
+	int nb_described = 0;
+
+	_devices.resize(nb_dev);
+	for (int i = 0; i < nb_dev; i++) {
+		bs_device_t &dev = _devices[i];
+		dev.index = i;
+		dev.bsdl = NULL;
+		for (const BsdlParser *b : bsdl) {
+			if (b->match(static_cast<uint32_t>(idcodes[i]))) {
+				dev.bsdl = b;
+				break;
+			}
+		}
+		if (dev.bsdl) {
+			if (dev.bsdl->irlength() != irlengths[i])
+				throw std::runtime_error("Error: BSDL " +
+					dev.bsdl->entity() + " irlength mismatch with device " +
+					std::to_string(i));
+			nb_described++;
+		}
+	}
+	if (nb_described == 0)
+		throw std::runtime_error("Error: no device in JTAG chain matches "
+			"BSDL idcode");
+
+	/* first bits shifted out come from the device near TDO
+	 * (last in the chain list)
+	 */
+	for (int i = nb_dev - 1; i >= 0; i--) {
+		bs_device_t &dev = _devices[i];
+		dev.dr_pos = _dr_len;
+		dev.ir_pos = _ir_len;
+		_dr_len += (dev.bsdl) ? dev.bsdl->boundary_length() : 1;
+		_ir_len += irlengths[i];
+	}
+
+	/* default driven values: safe values */
+	_drive.assign((_dr_len + 7) / 8, 0);
+	_capture.assign((_dr_len + 7) / 8, 0);
+	for (const bs_device_t &dev : _devices) {
+		if (!dev.bsdl)
+			continue;
+		const std::vector<BsdlParser::bs_cell_t> &cells = dev.bsdl->cells();
+		for (size_t c = 0; c < cells.size(); c++)
+			set_bit(_drive.data(), dev.dr_pos + c, cells[c].safe == 1);
+	}
+
+	if (_verbose > 0) {
+		for (const bs_device_t &dev : _devices) {
+			char mess[256];
+			snprintf(mess, sizeof(mess), "boundary scan: device %d %s "
+				"(%d bits at %d)", dev.index,
+				(dev.bsdl) ? dev.bsdl->entity().c_str() : "BYPASS",
+				(dev.bsdl) ? dev.bsdl->boundary_length() : 1, dev.dr_pos);
+			printInfo(mess);
+		}
+	}
+}
+
+bool BoundaryScan::find_pin(const std::string &name, int *dev,
+		int *pin) const
+{
+	std::string pin_name = name;
+	int index = -1;
+	size_t sep = name.find(':');
+	if (sep != std::string::npos) {
+		try {
+			index = std::stoi(name.substr(0, sep));
+		} catch (std::exception &e) {
+			return false;
+		}
+		pin_name = name.substr(sep + 1);
+		if (index < 0 || index >= static_cast<int>(_devices.size()))
+			return false;
+	}
+
+	for (const bs_device_t &d : _devices) {
+		if (!d.bsdl || (index != -1 && d.index != index))
+			continue;
+		int p = d.bsdl->pin_index(pin_name);
+		if (p != -1) {
+			*dev = d.index;
+			*pin = p;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool BoundaryScan::set_pin(int dev, int pin, int val)
+{
+	const bs_device_t &d = _devices[dev];
+	const BsdlParser::bs_pin_t &p = d.bsdl->pins()[pin];
+
+	if (p.output == -1) {
+		printError("boundary scan: " + p.name + " is not an output");
+		return false;
+	}
+	if (p.ctrl == -1) {
+		/* output2: always driven */
+		if (val == -1) {
+			printError("boundary scan: " + p.name +
+				" can't be set in high impedance");
+			return false;
+		}
+	} else {
+		/* control cells may be shared by several pins */
+		set_bit(_drive.data(), d.dr_pos + p.ctrl,
+			(val == -1) ? p.disval : !p.disval);
+	}
+	if (val != -1)
+		set_bit(_drive.data(), d.dr_pos + p.output, val);
+	return true;
+}
+
+int BoundaryScan::get_pin(int dev, int pin, const uint8_t *capture) const
+{
+	const bs_device_t &d = _devices[dev];
+	const BsdlParser::bs_pin_t &p = d.bsdl->pins()[pin];
+	if (p.input == -1)
+		return -1;
+	return get_bit((capture) ? capture : _capture.data(), d.dr_pos + p.input);
+}
+
+bool BoundaryScan::load_ir(const std::string &instr)
+{
+	std::vector<uint8_t> ir((_ir_len + 7) / 8, 0xff);
+	std::vector<uint8_t> code;
+
+	for (const bs_device_t &dev : _devices) {
+		if (!dev.bsdl)
+			continue;
+		if (!dev.bsdl->opcode(instr, code)) {
+			printError("boundary scan: " + dev.bsdl->entity() + " has no " +
+				instr + " instruction");
+			return false;
+		}
+		for (int i = 0; i < dev.bsdl->irlength(); i++)
+			set_bit(ir.data(), dev.ir_pos + i, get_bit(code.data(), i));
+	}
+
+	/* IR shadow is invalidated when passing through Capture-IR */
+	_jtag->set_state(Jtag::SHIFT_IR);
+	_jtag->read_write(ir.data(), NULL, _ir_len, 1);
+	_jtag->set_state(Jtag::RUN_TEST_IDLE);
+	return true;
+}
+
+void BoundaryScan::scan_dr(uint8_t *tdi, uint8_t *tdo)
+{
+	_jtag->set_state(Jtag::SHIFT_DR);
+	_jtag->read_write(tdi, tdo, _dr_len, 1);
+	_jtag->set_state(Jtag::RUN_TEST_IDLE);
+}
+
+bool BoundaryScan::sample()
+{
+	if (!load_ir("SAMPLE"))
+		return false;
+	scan_dr(_drive.data(), _capture.data());
+	return true;
+}
+
+bool BoundaryScan::extest()
+{
+	/* boundary registers must hold driven values before EXTEST
+	 * is applied (Update-IR)
+	 */
+	if (!load_ir("PRELOAD"))
+		return false;
+	scan_dr(_drive.data(), NULL);
+	if (!load_ir("EXTEST"))
+		return false;
+	scan_dr(_drive.data(), _capture.data());
+	return true;
+}
+
+bool BoundaryScan::sample_stream(uint32_t nb, std::vector<uint8_t> &captures)
+{
+	const uint32_t stride = (_dr_len + 7) / 8;
+	captures.assign(static_cast<size_t>(nb) * stride, 0);
+	if (nb == 0)
+		return true;
+
+	if (!load_ir("SAMPLE"))
+		return false;
+	/* everything queued before must be sent before raw sequences */
+	_jtag->flush();
+
+	/* one capture from Run-Test/Idle or Update-DR:
+	 * Select-DR (1), Capture-DR (0), Shift-DR (0), dr_len bits with TMS
+	 * high for the last one (Exit1-DR), Update-DR (1)
+	 */
+	const uint32_t cycles = _dr_len + 4;
+	uint32_t batch = BS_BATCH_CYCLES / cycles;
+	if (batch == 0)
+		batch = 1;
+
+	JtagInterface *ll = _jtag->get_ll_class();
+	std::vector<uint8_t> tms, tdi, tdo;
+	uint32_t seq_batch = 0;
+	bool raw = true;
+
+	for (uint32_t done = 0; done < nb;) {
+		uint32_t count = (nb - done < batch) ? nb - done : batch;
+
+		if (raw) {
+			/* one more cycle to return to Run-Test/Idle */
+			uint32_t len = count * cycles + 1;
+			if (count != seq_batch) {
+				tms.assign((len + 7) / 8, 0);
+				tdi.assign((len + 7) / 8, 0);
+				for (uint32_t k = 0; k < count; k++) {
+					uint32_t base = k * cycles;
+					set_bit(tms.data(), base, 1);
+					for (int i = 0; i < _dr_len; i++)
+						set_bit(tdi.data(), base + 3 + i,
+							get_bit(_drive.data(), i));
+					set_bit(tms.data(), base + 2 + _dr_len, 1);
+					set_bit(tms.data(), base + 3 + _dr_len, 1);
+				}
+				tdo.resize(tms.size());
+				seq_batch = count;
+			}
+
+			if (ll->writeTMSTDI(tms.data(), tdi.data(), tdo.data(), len)) {
+				/* data register bits start after Shift-DR entry */
+				for (uint32_t k = 0; k < count; k++) {
+					uint8_t *cap = &captures[(done + k) * stride];
+					uint32_t base = k * cycles + 3;
+					for (int i = 0; i < _dr_len; i++)
+						set_bit(cap, i, get_bit(tdo.data(), base + i));
+				}
+				done += count;
+				continue;
+			}
+			/* probe without TMS/TDI sequences: nothing sent */
+			if (done != 0) {
+				printError("boundary scan: sampling sequence failed");
+				return false;
+			}
+			if (_verbose > 0)
+				printInfo("boundary scan: probe without TMS/TDI sequences, "
+					"one capture per scan");
+			raw = false;
+		}
+
+		for (uint32_t k = 0; k < count; k++)
+			scan_dr(_drive.data(), &captures[(done + k) * stride]);
+		done += count;
+	}
+
+	memcpy(_capture.data(), &captures[(nb - 1) * static_cast<size_t>(stride)],
+		stride);
+	return true;
+}
@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#ifndef SRC_BOUNDARYSCAN_HPP_
+#define SRC_BOUNDARYSCAN_HPP_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "bsdlParser.hpp"
+#include "jtag.hpp"
+
+/*!
+ * \file boundaryScan.hpp
+ * \class BoundaryScan
+ * \brief boundary-scan access to the whole JTAG chain: each device
+ *        described by a BSDL (matched by idcode) exposes its boundary
+ *        register, others are kept in BYPASS. All devices are scanned
+ *        together so a pin driven by a device (EXTEST) may be read by
+ *        another one in the same operation (interconnect test).
+ *        Chain data register is stored as one bit array (LSB first):
+ *        TDO side device first, cell 0 of each boundary register first
+ */
+class BoundaryScan {
+ public:
+	typedef struct {
+		int index;               /**< position in the chain */
+		const BsdlParser *bsdl;  /**< NULL: device in BYPASS */
+		int dr_pos;              /**< first bit in chain data register */
+		int ir_pos;              /**< first bit in chain instruction */
+	} bs_device_t;
+
+	/*!
+	 * \brief build chain layout
+	 * \param[in] jtag: JTAG chain already detected
+	 * \param[in] bsdl: device descriptions
+	 * \param[in] verbose: verbose level
+	 */
+	BoundaryScan(Jtag *jtag, const std::vector<BsdlParser *> &bsdl,
+			int8_t verbose);
+
+	const std::vector<bs_device_t> &devices() const {return _devices;}
+	int dr_length() const {return _dr_len;}
+
+	/*!
+	 * \brief search a pin
+	 * \param[in] name: "pin" (first device with this pin) or "index:pin"
+	 * \param[out] dev: index in devices list
+	 * \param[out] pin: index in device pins list
+	 * \return false if not found
+	 */
+	bool find_pin(const std::string &name, int *dev, int *pin) const;
+	/*!
+	 * \brief set value driven by a pin with next preload/extest
+	 * \param[in] val: 0, 1 or -1 for high impedance
+	 * \return false if pin can't be driven to this value
+	 */
+	bool set_pin(int dev, int pin, int val);
+	/*!
+	 * \brief pin state in a capture
+	 * \param[in] capture: chain data register bits, NULL for last
+	 *            sample/extest capture
+	 * \return 0, 1 or -1 when the pin has no input cell
+	 */
+	int get_pin(int dev, int pin, const uint8_t *capture = NULL) const;
+
+	/*!
+	 * \brief SAMPLE/PRELOAD: capture pins state and load driven
+	 *        values (without any effect on pins)
+	 * \return false if a device has no SAMPLE instruction
+	 */
+	bool sample();
+	/*!
+	 * \brief PRELOAD driven values then EXTEST: pins are driven by
+	 *        boundary registers and captured. Devices stay in EXTEST
+	 *        until TAP reset
+	 * \return false if a device has no EXTEST instruction
+	 */
+	bool extest();
+	/*!
+	 * \brief continuous sampling: nb SAMPLE captures back-to-back.
+	 *        When the probe supports it, captures are sent by batches
+	 *        with a single TMS/TDI sequence (Update-DR to Capture-DR
+	 *        without going through Run-Test/Idle) and TDO is only read
+	 *        at the end of each batch
+	 * \param[in] nb: number of captures
+	 * \param[out] captures: nb chain data registers, each one
+	 *             starting on a Byte boundary ((dr_length() + 7) / 8)
+	 * \return false on error
+	 */
+	bool sample_stream(uint32_t nb, std::vector<uint8_t> &captures);
+
+ private:
+	/*!
+	 * \brief load instruction in all described devices (BYPASS for
+	 *        others) and go to Run-Test/Idle
+	 */
+	bool load_ir(const std::string &instr);
+	/*!
+	 * \brief full chain data register scan, ends in Run-Test/Idle
+	 */
+	void scan_dr(uint8_t *tdi, uint8_t *tdo);
+
+	Jtag *_jtag;
+	int8_t _verbose;
+	std::vector<bs_device_t> _devices;
+	int _dr_len;                  /**< chain data register length */
+	int _ir_len;                  /**< chain instruction length */
+	std::vector<uint8_t> _drive;  /**< data register shifted in */
+	std::vector<uint8_t> _capture;/**< last data register shifted out */
+};
+
+#endif  // SRC_BOUNDARYSCAN_HPP_
@@ -0,0 +1,525 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "bsdlParser.hpp"
+#include "display.hpp"
+
+#define BSDL_CACHE_MAGIC   "OBSC"
+#define BSDL_CACHE_VERSION 1
+#define BSDL_NONE          0xffff
+
+static std::string to_upper(const std::string &in)
+{
+	std::string out(in);
+	std::transform(out.begin(), out.end(), out.begin(), ::toupper);
+	return out;
+}
+
+static std::string trim(const std::string &in)
+{
+	size_t first = in.find_first_not_of(" \t\r\n");
+	if (first == std::string::npos)
+		return "";
+	size_t last = in.find_last_not_of(" \t\r\n");
+	return in.substr(first, last - first + 1);
+}
+
+/* remove VHDL comments ("--" to end of line) outside strings */
+static std::string strip_comments(const std::string &in)
+{
+	std::string out;
+	out.reserve(in.size());
+	bool in_str = false;
+	for (size_t i = 0; i < in.size(); i++) {
+		char c = in[i];
+		if (c == '"') {
+			in_str = !in_str;
+		} else if (!in_str && c == '-' && i + 1 < in.size() &&
+				in[i + 1] == '-') {
+			while (i < in.size() && in[i] != '\n')
+				i++;
+			c = '\n';
+		} else if (c == '\n') {
+			/* strings never span lines */
+			in_str = false;
+		}
+		out += c;
+	}
+	return out;
+}
+
+/* split on ';' outside strings */
+static std::vector<std::string> split_statements(const std::string &in)
+{
+	std::vector<std::string> stmts;
+	std::string curr;
+	bool in_str = false;
+	for (char c : in) {
+		if (c == '"')
+			in_str = !in_str;
+		if (c == ';' && !in_str) {
+			stmts.push_back(curr);
+			curr.clear();
+		} else {
+			curr += (c == '\t' || c == '\r' || c == '\n') ? ' ' : c;
+		}
+	}
+	stmts.push_back(curr);
+	return stmts;
+}
+
+/* split on ',' outside parenthesis */
+static std::vector<std::string> split_fields(const std::string &in)
+{
+	std::vector<std::string> fields;
+	std::string curr;
+	int depth = 0;
+	for (char c : in) {
+		if (c == '(')
+			depth++;
+		else if (c == ')')
+			depth--;
+		if (c == ',' && depth == 0) {
+			fields.push_back(trim(curr));
+			curr.clear();
+		} else {
+			curr += c;
+		}
+	}
+	if (!trim(curr).empty())
+		fields.push_back(trim(curr));
+	return fields;
+}
+
+/* attribute value: concatenation of all string literals ("a" & "b")
+ * or the raw value when not a string
+ */
+static std::string attr_value(const std::string &raw)
+{
+	if (raw.find('"') == std::string::npos)
+		return trim(raw);
+	std::string val;
+	bool in_str = false;
+	for (char c : raw) {
+		if (c == '"')
+			in_str = !in_str;
+		else if (in_str)
+			val += c;
+	}
+	return val;
+}
+
+static int to_int(const std::string &name, const std::string &val)
+{
+	try {
+		return std::stoi(val);
+	} catch (std::exception &e) {
+		throw std::runtime_error("Error: BSDL invalid " + name + " value");
+	}
+}
+
+BsdlParser::BsdlParser(const std::string &filename, int8_t verbose):
+	_verbose(verbose), _from_cache(false), _irlength(0), _idcode(0),
+	_idcode_mask(0)
+{
+	struct stat st;
+	if (stat(filename.c_str(), &st) != 0)
+		throw std::runtime_error("Error: can't open BSDL " + filename);
+
+	/* foo.bsd -> foo.bsdc */
+	std::string cache = filename;
+	size_t dot = cache.find_last_of('.');
+	size_t sep = cache.find_last_of("/\\");
+	if (dot != std::string::npos &&
+			(sep == std::string::npos || dot > sep))
+		cache.resize(dot);
+	cache += ".bsdc";
+
+	uint64_t size = st.st_size, mtime = st.st_mtime;
+	if (load_cache(cache, size, mtime)) {
+		_from_cache = true;
+	} else {
+		std::ifstream fd(filename, std::ios::binary);
+		if (!fd.good())
+			throw std::runtime_error("Error: can't open BSDL " + filename);
+		std::string content((std::istreambuf_iterator<char>(fd)),
+				std::istreambuf_iterator<char>());
+		try {
+			parse(content);
+		} catch (std::exception &e) {
+			throw std::runtime_error(std::string(e.what()) + " (" +
+				filename + ")");
+		}
+		save_cache(cache, size, mtime);
+	}
+
+	if (_verbose > 0) {
+		char mess[256];
+		snprintf(mess, sizeof(mess), "BSDL %s: irlength %d, %d cells, "
+			"%zu pins, idcode 0x%08x/0x%08x%s", _entity.c_str(), _irlength,
+			boundary_length(), _pins.size(), _idcode, _idcode_mask,
+			(_from_cache) ? " (cached)" : "");
+		printInfo(mess);
+	}
+}
+
+void BsdlParser::parse(const std::string &content)
+{
+	int boundary_length = -1;
+	std::string boundary_register;
+
+	for (const std::string &stmt : split_statements(strip_comments(content))) {
+		std::string s = trim(stmt);
+		/* keywords are case insensitive, only the part before
+		 * the first string is upper cased
+		 */
+		std::string head = to_upper(s.substr(0, s.find('"')));
+
+		if (head.compare(0, 7, "ENTITY ") == 0 && _entity.empty()) {
+			size_t end = head.find(' ', 7);
+			_entity = trim(s.substr(7, end - 7));
+			continue;
+		}
+		if (head.compare(0, 10, "ATTRIBUTE ") != 0)
+			continue;
+
+		/* attribute NAME of ENTITY : entity is VALUE */
+		size_t name_end = head.find(' ', 10);
+		size_t colon = head.find(':');
+		size_t is = head.find(" IS ", colon);
+		if (name_end == std::string::npos || colon == std::string::npos ||
+				is == std::string::npos)
+			continue;
+		std::string name = head.substr(10, name_end - 10);
+		std::string value = attr_value(s.substr(is + 4));
+
+		if (name == "INSTRUCTION_LENGTH") {
+			_irlength = to_int(name, value);
+		} else if (name == "INSTRUCTION_OPCODE") {
+			/* "NAME (code[, code]), NAME (code)..." first code is kept */
+			for (const std::string &op : split_fields(value)) {
+				size_t open = op.find('('), close = op.find(')');
+				if (open == std::string::npos || close == std::string::npos)
+					throw std::runtime_error("Error: BSDL invalid opcode " +
+						op);
+				std::string code = op.substr(open + 1, close - open - 1);
+				code = trim(code.substr(0, code.find(',')));
+				_opcodes[to_upper(trim(op.substr(0, open)))] = code;
+			}
+		} else if (name == "IDCODE_REGISTER") {
+			value.erase(std::remove(value.begin(), value.end(), ' '),
+				value.end());
+			if (value.size() != 32)
+				throw std::runtime_error("Error: BSDL invalid IDCODE_REGISTER");
+			for (int i = 0; i < 32; i++) {
+				char c = value[31 - i];
+				if (c == '1' || c == '0')
+					_idcode_mask |= (1u << i);
+				if (c == '1')
+					_idcode |= (1u << i);
+			}
+		} else if (name == "BOUNDARY_LENGTH") {
+			boundary_length = to_int(name, value);
+		} else if (name == "BOUNDARY_REGISTER") {
+			boundary_register = value;
+		}
+	}
+
+	if (_irlength <= 0)
+		throw std::runtime_error("Error: BSDL without INSTRUCTION_LENGTH");
+	for (auto &op : _opcodes) {
+		if (static_cast<int>(op.second.size()) != _irlength ||
+				op.second.find_first_not_of("01") != std::string::npos)
+			throw std::runtime_error("Error: BSDL invalid opcode for " +
+				op.first);
+	}
+	if (boundary_length <= 0 || boundary_register.empty())
+		throw std::runtime_error("Error: BSDL without boundary register");
+
+	parse_cells(boundary_register, boundary_length);
+	build_pins();
+}
+
+void BsdlParser::parse_cells(const std::string &value, int length)
+{
+	static const std::map<std::string, uint8_t> functions = {
+		{"INPUT", BS_INPUT}, {"OUTPUT2", BS_OUTPUT2},
+		{"OUTPUT3", BS_OUTPUT3}, {"CONTROL", BS_CONTROL},
+		{"CONTROLR", BS_CONTROLR}, {"INTERNAL", BS_INTERNAL},
+		{"BIDIR", BS_BIDIR}, {"CLOCK", BS_CLOCK},
+		{"OBSERVE_ONLY", BS_OBSERVE_ONLY}};
+
+	if (length >= BSDL_NONE)
+		throw std::runtime_error("Error: BSDL boundary register too long");
+	bs_cell_t undef = {-1, BS_INTERNAL, -1, -1, -1};
+	_cells.assign(length, undef);
+	std::vector<bool> defined(length, false);
+	std::map<std::string, int16_t> port_index;
+
+	/* "num (cell, port, function, safe[, ccell, disval, rslt])," */
+	for (const std::string &entry : split_fields(value)) {
+		size_t open = entry.find('('), close = entry.find_last_of(')');
+		if (open == std::string::npos || close == std::string::npos)
+			throw std::runtime_error("Error: BSDL invalid cell " + entry);
+		int num = to_int("cell number", trim(entry.substr(0, open)));
+		std::vector<std::string> f = split_fields(
+			entry.substr(open + 1, close - open - 1));
+		if (num < 0 || num >= length || defined[num] ||
+				(f.size() != 4 && f.size() != 7))
+			throw std::runtime_error("Error: BSDL invalid cell " + entry);
+		defined[num] = true;
+
+		bs_cell_t &cell = _cells[num];
+		auto func = functions.find(to_upper(f[2]));
+		if (func == functions.end())
+			throw std::runtime_error("Error: BSDL unknown cell function " +
+				f[2]);
+		cell.function = func->second;
+		cell.safe = (f[3] == "0") ? 0 : (f[3] == "1") ? 1 : -1;
+
+		std::string port = to_upper(f[1]);
+		port.erase(std::remove(port.begin(), port.end(), ' '), port.end());
+		if (port != "*") {
+			auto p = port_index.find(port);
+			if (p == port_index.end()) {
+				if (port.size() > 255 || _ports.size() >= BSDL_NONE)
+					throw std::runtime_error("Error: BSDL invalid port " +
+						port);
+				p = port_index.insert({port,
+					static_cast<int16_t>(_ports.size())}).first;
+				_ports.push_back(port);
+			}
+			cell.port = p->second;
+		}
+
+		if (f.size() == 7) {
+			int ctrl = to_int("control cell", f[4]);
+			if (ctrl < 0 || ctrl >= length)
+				throw std::runtime_error("Error: BSDL invalid cell " + entry);
+			cell.ctrl = ctrl;
+			cell.disval = (f[5] == "1") ? 1 : 0;
+		}
+	}
+
+	if (std::find(defined.begin(), defined.end(), false) != defined.end())
+		throw std::runtime_error("Error: BSDL boundary register shorter "
+			"than BOUNDARY_LENGTH");
+}
+
+void BsdlParser::build_pins()
+{
+	_pins.clear();
+	for (const std::string &port : _ports)
+		_pins.push_back({port, -1, -1, -1, -1});
+
+	for (size_t i = 0; i < _cells.size(); i++) {
+		const bs_cell_t &cell = _cells[i];
+		if (cell.port < 0)
+			continue;
+		bs_pin_t &pin = _pins[cell.port];
+		switch (cell.function) {
+		case BS_INPUT:
+		case BS_CLOCK:
+		case BS_OBSERVE_ONLY:
+			pin.input = i;
+			break;
+		case BS_BIDIR:
+			/* a dedicated input cell is preferred */
+			if (pin.input == -1)
+				pin.input = i;
+			/* fall through */
+		case BS_OUTPUT2:
+		case BS_OUTPUT3:
+			pin.output = i;
+			pin.ctrl = cell.ctrl;
+			pin.disval = cell.disval;
+			break;
+		}
+	}
+}
+
+bool BsdlParser::opcode(const std::string &name,
+		std::vector<uint8_t> &code) const
+{
+	std::string key = to_upper(name);
+	auto op = _opcodes.find(key);
+	if (op == _opcodes.end() && key == "PRELOAD")
+		op = _opcodes.find("SAMPLE");
+	if (op == _opcodes.end())
+		return false;
+
+	const std::string &bits = op->second;
+	code.assign((_irlength + 7) / 8, 0);
+	for (int i = 0; i < _irlength; i++)
+		if (bits[_irlength - 1 - i] == '1')
+			code[i >> 3] |= (1 << (i & 0x07));
+	return true;
+}
+
+int BsdlParser::pin_index(const std::string &name) const
+{
+	std::string key = to_upper(name);
+	for (size_t i = 0; i < _pins.size(); i++)
+		if (_pins[i].name == key)
+			return i;
+	return -1;
+}
+
+/* binary cache helpers */
+
+static void put_int(std::vector<uint8_t> &buf, uint64_t val, int len)
+{
+	for (int i = 0; i < len; i++)
+		buf.push_back((val >> (8 * i)) & 0xff);
+}
+
+static void put_str(std::vector<uint8_t> &buf, const std::string &str)
+{
+	buf.push_back(static_cast<uint8_t>(str.size()));
+	buf.insert(buf.end(), str.begin(), str.end());
+}
+
+namespace {
+/* bounded reader: any access beyond the end sets error */
+class CacheReader {
+ public:
+	explicit CacheReader(const std::vector<uint8_t> &buf): _buf(buf),
+		_pos(0), error(false) {}
+	uint64_t get_int(int len) {
+		if (_pos + len > _buf.size()) {
+			error = true;
+			return 0;
+		}
+		uint64_t val = 0;
+		for (int i = 0; i < len; i++)
+			val |= static_cast<uint64_t>(_buf[_pos++]) << (8 * i);
+		return val;
+	}
+	std::string get_str() {
+		size_t len = get_int(1);
+		if (_pos + len > _buf.size()) {
+			error = true;
+			return "";
+		}
+		std::string str(_buf.begin() + _pos, _buf.begin() + _pos + len);
+		_pos += len;
+		return str;
+	}
+	bool end() const {return _pos == _buf.size();}
+
+ private:
+	const std::vector<uint8_t> &_buf;
+	size_t _pos;
+
+ public:
+	bool error;
+};
+}  // namespace
+
+bool BsdlParser::load_cache(const std::string &filename, uint64_t size,
+		uint64_t mtime)
+{
+	std::ifstream fd(filename, std::ios::binary);
+	if (!fd.good())
+		return false;
+	std::vector<uint8_t> buf((std::istreambuf_iterator<char>(fd)),
+			std::istreambuf_iterator<char>());
+
+	if (buf.size() < 21 || memcmp(buf.data(), BSDL_CACHE_MAGIC, 4) ||
+			buf[4] != BSDL_CACHE_VERSION)
+		return false;
+
+	std::vector<uint8_t> body(buf.begin() + 5, buf.end());
+	CacheReader rd(body);
+	if (rd.get_int(8) != size || rd.get_int(8) != mtime)
+		return false;
+
+	_entity = rd.get_str();
+	_irlength = rd.get_int(2);
+	_idcode = rd.get_int(4);
+	_idcode_mask = rd.get_int(4);
+	for (int nb = rd.get_int(2); nb > 0 && !rd.error; nb--) {
+		std::string name = rd.get_str();
+		_opcodes[name] = rd.get_str();
+	}
+	for (int nb = rd.get_int(2); nb > 0 && !rd.error; nb--)
+		_ports.push_back(rd.get_str());
+	int length = rd.get_int(2);
+	if (rd.error)
+		return false;
+	_cells.resize(length);
+	for (bs_cell_t &cell : _cells) {
+		cell.port = static_cast<int16_t>(rd.get_int(2));
+		cell.function = rd.get_int(1);
+		cell.safe = static_cast<int8_t>(rd.get_int(1));
+		cell.ctrl = static_cast<int16_t>(rd.get_int(2));
+		cell.disval = static_cast<int8_t>(rd.get_int(1));
+		if (cell.port < -1 || cell.port >= static_cast<int>(_ports.size()) ||
+				cell.ctrl < -1 || cell.ctrl >= length ||
+				cell.function > BS_OBSERVE_ONLY)
+			rd.error = true;
+	}
+
+	if (rd.error || !rd.end()) {
+		/* corrupted: parse BSDL again */
+		_opcodes.clear();
+		_ports.clear();
+		_cells.clear();
+		return false;
+	}
+
+	build_pins();
+	return true;
+}
+
+void BsdlParser::save_cache(const std::string &filename, uint64_t size,
+		uint64_t mtime)
+{
+	std::vector<uint8_t> buf(BSDL_CACHE_MAGIC, BSDL_CACHE_MAGIC + 4);
+	buf.reserve(64 + _cells.size() * 7);
+	buf.push_back(BSDL_CACHE_VERSION);
+	put_int(buf, size, 8);
+	put_int(buf, mtime, 8);
+	put_str(buf, _entity.substr(0, 255));
+	put_int(buf, _irlength, 2);
+	put_int(buf, _idcode, 4);
+	put_int(buf, _idcode_mask, 4);
+	put_int(buf, _opcodes.size(), 2);
+	for (auto &op : _opcodes) {
+		put_str(buf, op.first.substr(0, 255));
+		put_str(buf, op.second);
+	}
+	put_int(buf, _ports.size(), 2);
+	for (const std::string &port : _ports)
+		put_str(buf, port);
+	put_int(buf, _cells.size(), 2);
+	for (const bs_cell_t &cell : _cells) {
+		put_int(buf, static_cast<uint16_t>(cell.port), 2);
+		put_int(buf, cell.function, 1);
+		put_int(buf, static_cast<uint8_t>(cell.safe), 1);
+		put_int(buf, static_cast<uint16_t>(cell.ctrl), 2);
+		put_int(buf, static_cast<uint8_t>(cell.disval), 1);
+	}
+
+	/* not fatal: BSDL directory may be read only */
+	FILE *fd = fopen(filename.c_str(), "wb");
+	if (!fd || fwrite(buf.data(), 1, buf.size(), fd) != buf.size()) {
+		if (_verbose > 0)
+			printWarn("BSDL: can't write cache " + filename);
+	}
+	if (fd)
+		fclose(fd);
+}
@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#ifndef SRC_BSDLPARSER_HPP_
+#define SRC_BSDLPARSER_HPP_
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*!
+ * \file bsdlParser.hpp
+ * \class BsdlParser
+ * \brief boundary-scan description (BSDL) of one device: only the
+ *        attributes required for SAMPLE/PRELOAD/EXTEST are kept
+ *        (INSTRUCTION_LENGTH, INSTRUCTION_OPCODE, IDCODE_REGISTER,
+ *        BOUNDARY_LENGTH and BOUNDARY_REGISTER).
+ *        The result is cached next to the BSDL file (same name with
+ *        .bsdc extension) in a compact binary form, reused as long as
+ *        BSDL size and modification time are unchanged:
+ *        "OBSC", version (1B), BSDL size (8B), BSDL mtime (8B), entity,
+ *        irlength (2B), idcode (4B), idcode mask (4B),
+ *        opcodes count (2B) + (name, bits) list,
+ *        ports count (2B) + names list,
+ *        boundary length (2B) + cells (port (2B), function (1B),
+ *        safe (1B), control cell (2B), disable value (1B))
+ *        integers are little endian, strings are length (1B) + chars
+ */
+class BsdlParser {
+ public:
+	/* BOUNDARY_REGISTER cell function */
+	enum cell_function {
+		BS_INPUT = 0,
+		BS_OUTPUT2,
+		BS_OUTPUT3,
+		BS_CONTROL,
+		BS_CONTROLR,
+		BS_INTERNAL,
+		BS_BIDIR,
+		BS_CLOCK,
+		BS_OBSERVE_ONLY
+	};
+
+	typedef struct {
+		int16_t port;      /**< index in ports list, -1: none ('*') */
+		uint8_t function;  /**< cell_function */
+		int8_t safe;       /**< safe value: 0, 1, -1 (X) */
+		int16_t ctrl;      /**< control cell, -1: none */
+		int8_t disval;     /**< control value disabling output */
+	} bs_cell_t;
+
+	typedef struct {
+		std::string name;
+		int16_t input;     /**< cell capturing pin state, -1: none */
+		int16_t output;    /**< cell driving the pin, -1: none */
+		int16_t ctrl;      /**< output enable cell, -1: none */
+		int8_t disval;     /**< ctrl value for high impedance */
+	} bs_pin_t;
+
+	/*!
+	 * \brief load a BSDL file (or its cache)
+	 * \param[in] filename: BSDL file
+	 * \param[in] verbose: verbose level
+	 */
+	BsdlParser(const std::string &filename, int8_t verbose);
+
+	const std::string &entity() const {return _entity;}
+	int irlength() const {return _irlength;}
+	uint32_t idcode() const {return _idcode;}
+	uint32_t idcode_mask() const {return _idcode_mask;}
+	/*!
+	 * \brief check idcode against IDCODE_REGISTER (X bits ignored)
+	 */
+	bool match(uint32_t idcode) const {
+		return _idcode_mask != 0 &&
+			(idcode & _idcode_mask) == (_idcode & _idcode_mask);
+	}
+	/*!
+	 * \brief instruction code
+	 * \param[in] name: instruction name (EXTEST, SAMPLE, ...), PRELOAD
+	 *            falls back to SAMPLE when not described (1149.1-1990)
+	 * \param[out] code: irlength bits, LSB first
+	 * \return false if instruction is not described
+	 */
+	bool opcode(const std::string &name, std::vector<uint8_t> &code) const;
+	int boundary_length() const {return static_cast<int>(_cells.size());}
+	const std::vector<bs_cell_t> &cells() const {return _cells;}
+	const std::vector<bs_pin_t> &pins() const {return _pins;}
+	/*!
+	 * \brief search a pin (case insensitive)
+	 * \return index in pins list, -1 if not found
+	 */
+	int pin_index(const std::string &name) const;
+	/*!
+	 * \brief true when loaded from binary cache
+	 */
+	bool from_cache() const {return _from_cache;}
+
+ private:
+	/*!
+	 * \brief parse BSDL content
+	 */
+	void parse(const std::string &content);
+	/*!
+	 * \brief decode BOUNDARY_REGISTER value
+	 */
+	void parse_cells(const std::string &value, int length);
+	/*!
+	 * \brief build pins list from cells
+	 */
+	void build_pins();
+	/*!
+	 * \brief load binary cache
+	 * \return false if cache is missing, outdated or corrupted
+	 */
+	bool load_cache(const std::string &filename, uint64_t size,
+			uint64_t mtime);
+	void save_cache(const std::string &filename, uint64_t size,
+			uint64_t mtime);
+
+	int8_t _verbose;
+	bool _from_cache;
+	std::string _entity;
+	int _irlength;
+	uint32_t _idcode;
+	uint32_t _idcode_mask;
+	std::map<std::string, std::string> _opcodes; /**< name: bits (MSB first) */
+	std::vector<std::string> _ports;
+	std::vector<bs_cell_t> _cells;
+	std::vector<bs_pin_t> _pins;
+};
+
+#endif  // SRC_BSDLPARSER_HPP_
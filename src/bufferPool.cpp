@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#include "bufferPool.hpp"
+
+BufferPool::Buffer::Buffer(size_t size)
+{
+	_data = BufferPool::local().get(size, &_capacity);
+}
+
+BufferPool::Buffer::~Buffer()
+{
+	BufferPool::local().put(_data, _capacity);
+}
+
+BufferPool::~BufferPool()
+{
+	for (int i = 0; i < kNbClass; i++)
+		for (uint8_t *buf : _free[i])
+			delete[] buf;
+}
+
+BufferPool &BufferPool::local()
+{
+	static thread_local BufferPool pool;
+	return pool;
+}
+
+int BufferPool::size_class(size_t size)
+{
+	size_t class_size = 64;
+	for (int i = 0; i < kNbClass; i++, class_size <<= 1)
+		if (size <= class_size)
+			return i;
+	return -1;
+}
+
+uint8_t *BufferPool::get(size_t size, size_t *capacity)
+{
+	int cl = size_class(size);
+	/* larger than biggest class: not pooled */
+	if (cl < 0) {
+		*capacity = size;
+		return new uint8_t[size];
+	}
+
+	*capacity = (size_t)64 << cl;
+	if (_free[cl].empty())
+		return new uint8_t[*capacity];
+
+	uint8_t *buf = _free[cl].back();
+	_free[cl].pop_back();
+	return buf;
+}
+
+void BufferPool::put(uint8_t *buf, size_t capacity)
+{
+	int cl = size_class(capacity);
+	if (cl < 0 || ((size_t)64 << cl) != capacity ||
+			_free[cl].size() >= kMaxFree) {
+		delete[] buf;
+		return;
+	}
+	_free[cl].push_back(buf);
+}
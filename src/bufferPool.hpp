@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#ifndef SRC_BUFFERPOOL_HPP_
+#define SRC_BUFFERPOOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*!
+ * \file bufferPool.hpp
+ * \class BufferPool
+ * \brief per thread pool of transfer buffers, by power of two size
+ *        classes from a USB packet (64B) to a 1MB flash burst. Replaces
+ *        variable length arrays (stack overflow with large transfers) and
+ *        per call allocations in drivers and vendor code: a cable is
+ *        driven by one thread, so buffers are reused without lock
+ */
+class BufferPool {
+ public:
+	/*!
+	 * \brief scoped buffer taken from calling thread pool and
+	 *        released at end of scope. Content is not initialized
+	 */
+	class Buffer {
+	 public:
+		explicit Buffer(size_t size);
+		~Buffer();
+		uint8_t *data() {return _data;}
+		operator uint8_t *() {return _data;}
+
+	 private:
+		Buffer(const Buffer &) = delete;
+		Buffer &operator=(const Buffer &) = delete;
+
+		uint8_t *_data;
+		size_t _capacity;
+	};
+
+	~BufferPool();
+
+	/*!
+	 * \brief pool of calling thread
+	 */
+	static BufferPool &local();
+
+	/*!
+	 * \brief get a buffer of at least size bytes
+	 * \param[in] size: requested size
+	 * \param[out] capacity: real buffer size, to give back to put
+	 * \return buffer
+	 */
+	uint8_t *get(size_t size, size_t *capacity);
+	/*!
+	 * \brief give back a buffer obtained with get
+	 */
+	void put(uint8_t *buf, size_t capacity);
+
+ private:
+	BufferPool() {}
+
+	/* 64B << i */
+	static const int kNbClass = 15;
+	/* free buffers kept by class */
+	static const size_t kMaxFree = 4;
+
+	/*!
+	 * \brief size class for size, -1 if larger than biggest class
+	 */
+	static int size_class(size_t size);
+
+	std::vector<uint8_t *> _free[kNbClass];
+};
+
+#endif  // SRC_BUFFERPOOL_HPP_
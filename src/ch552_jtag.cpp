@@ -12,6 +12,7 @@
 #include <vector>
 #include <string>
 
+#include "bufferPool.hpp"
 #include "display.hpp"
 #include "ch552_jtag.hpp"
 #include "ftdipp_mpsse.hpp"
@@ -120,7 +121,7 @@ int CH552_jtag::writeTMS(uint8_t *tms, uint32_t len, bool flush_buffer)
 
 		mpsse_store(buf, 3);
 		if (pos >= iter) {
-			uint8_t tmp[_to_read];
+			BufferPool::Buffer tmp(_to_read);
 			pos = 0;
 			if (-1 == mpsse_read(tmp, _to_read))
 				printError("writeTMS: Fail to read/write");
@@ -131,7 +132,7 @@ int CH552_jtag::writeTMS(uint8_t *tms, uint32_t len, bool flush_buffer)
 
 	if (flush_buffer) {
 		if (_to_read > 0) {
-			uint8_t tmp[_to_read];
+			BufferPool::Buffer tmp(_to_read);
 			if (mpsse_read(tmp, _to_read) == -1)
 				printError("writeTMS: fail to flush");
 			_to_read = 0;
@@ -149,7 +150,7 @@ int CH552_jtag::toggleClk(uint8_t tms, uint8_t tdi, uint32_t clk_len)
 	(void) tdi;
 
 	int byteLen = (clk_len+7)/8;
-	uint8_t buf_tms[byteLen];
+	BufferPool::Buffer buf_tms(byteLen);
 
 	memset(buf_tms, (tms) ? 0xff : 0x00, byteLen);
 	return writeTMS(buf_tms, clk_len, false);
@@ -163,7 +164,7 @@ int CH552_jtag::flush()
 		if (ret == -1)
 			printError("flush: fails to write");
 	} else {
-		uint8_t tmp[_to_read];
+		BufferPool::Buffer tmp(_to_read);
 		ret = mpsse_read(tmp, _to_read);
 		if (ret == -1)
 			printError("flush: fails to read/write");
@@ -199,7 +200,7 @@ int CH552_jtag::writeTDI(uint8_t *tdi, uint8_t *tdo, uint32_t len, bool last)
 	uint8_t oneshot_buf[3] = {rd_cmd, 0, 0};
 
 	if (_to_read != 0) {
-		uint8_t tmp_[_to_read];
+		BufferPool::Buffer tmp_(_to_read);
 		if (mpsse_read(tmp_, _to_read) == -1)
 			printError("writeTDI: fails to flush read");
 		_to_read = 0;
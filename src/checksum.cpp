@@ -0,0 +1,339 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#include "checksum.hpp"
+
+/* ---------------------- */
+/*         CRC-32         */
+/* ---------------------- */
+
+/* table[0] is the classic Byte table, table[k][n] is the CRC of
+ * n followed by k null Bytes: 8 lookups process 8 Bytes
+ */
+static const uint32_t (*crc32_tables())[256]
+{
+	static uint32_t table[8][256];
+	static bool init = [](){
+		for (uint32_t n = 0; n < 256; n++) {
+			uint32_t c = n;
+			for (int k = 0; k < 8; k++)
+				c = (c & 1) ? 0xedb88320 ^ (c >> 1) : c >> 1;
+			table[0][n] = c;
+		}
+		for (uint32_t n = 0; n < 256; n++)
+			for (int k = 1; k < 8; k++)
+				table[k][n] = (table[k - 1][n] >> 8) ^
+					table[0][table[k - 1][n] & 0xff];
+		return true;
+	}();
+	(void)init;
+	return table;
+}
+
+uint32_t CRC32::compute(uint32_t crc, const uint8_t *data, size_t len)
+{
+	const uint32_t (*t)[256] = crc32_tables();
+
+	/* Byte access: endianness independent (merged into a single
+	 * load by the compiler on little endian CPUs)
+	 */
+	for (; len >= 8; len -= 8, data += 8) {
+		uint32_t lo = crc ^ ((uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+			((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+		crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^
+			t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+			t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+	}
+	while (len--)
+		crc = t[0][(crc ^ *data++) & 0xff] ^ (crc >> 8);
+
+	return crc;
+}
+
+/* ---------------------- */
+/*         CRC-16         */
+/* ---------------------- */
+
+/* MSB first table for 0x1021 and LSB first table for 0x8005 (0xa001
+ * reflected)
+ */
+static const uint16_t *crc16_table(bool reflected)
+{
+	static uint16_t table[2][256];
+	static bool init = [](){
+		for (uint32_t n = 0; n < 256; n++) {
+			uint16_t c = n << 8;
+			for (int k = 0; k < 8; k++)
+				c = (c & 0x8000) ? (c << 1) ^ 0x1021 : c << 1;
+			table[0][n] = c;
+			c = n;
+			for (int k = 0; k < 8; k++)
+				c = (c & 1) ? (c >> 1) ^ 0xa001 : c >> 1;
+			table[1][n] = c;
+		}
+		return true;
+	}();
+	(void)init;
+	return table[(reflected) ? 1 : 0];
+}
+
+CRC16::CRC16(crc16_variant variant): _variant(variant),
+	_reflected(variant == CRC16_MODBUS || variant == CRC16_ARC),
+	_table(crc16_table(_reflected)), _crc(0)
+{
+	reset();
+}
+
+void CRC16::reset()
+{
+	_crc = (_variant == CRC16_CCITT_FALSE || _variant == CRC16_MODBUS) ?
+		0xffff : 0x0000;
+}
+
+void CRC16::update(const uint8_t *data, size_t len)
+{
+	uint16_t crc = _crc;
+	if (_reflected) {
+		while (len--)
+			crc = _table[(crc ^ *data++) & 0xff] ^ (crc >> 8);
+	} else {
+		while (len--)
+			crc = _table[((crc >> 8) ^ *data++) & 0xff] ^ (crc << 8);
+	}
+	_crc = crc;
+}
+
+uint16_t CRC16::crc(const uint8_t *data, size_t len, crc16_variant variant)
+{
+	CRC16 crc(variant);
+	crc.update(data, len);
+	return crc.value();
+}
+
+/* ---------------------- */
+/*   Adler-32/Fletcher-16 */
+/* ---------------------- */
+
+/* largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1 */
+#define ADLER_NMAX 5552
+#define ADLER_BASE 65521
+/* largest n such that 254 + 254n + 255n(n+1)/2 <= 2^32-1 (sums are < 255
+ * before each block)
+ */
+#define FLETCHER_NMAX 5802
+
+void Adler32::update(const uint8_t *data, size_t len)
+{
+	uint32_t a = _a, b = _b;
+	while (len > 0) {
+		size_t n = (len < ADLER_NMAX) ? len : ADLER_NMAX;
+		len -= n;
+		while (n--) {
+			a += *data++;
+			b += a;
+		}
+		a %= ADLER_BASE;
+		b %= ADLER_BASE;
+	}
+	_a = a;
+	_b = b;
+}
+
+void Fletcher16::update(const uint8_t *data, size_t len)
+{
+	uint32_t sum1 = _sum1, sum2 = _sum2;
+	while (len > 0) {
+		size_t n = (len < FLETCHER_NMAX) ? len : FLETCHER_NMAX;
+		len -= n;
+		while (n--) {
+			sum1 += *data++;
+			sum2 += sum1;
+		}
+		sum1 %= 255;
+		sum2 %= 255;
+	}
+	_sum1 = sum1;
+	_sum2 = sum2;
+}
+
+/* ---------------------- */
+/*         Sum16          */
+/* ---------------------- */
+
+void Sum16::update(const uint8_t *data, size_t len)
+{
+	uint32_t sum = _sum;
+
+	if (!_words) {
+		while (len--)
+			sum += *data++;
+		_sum = sum & 0xffff;
+		return;
+	}
+
+	if (_pending && len > 0) {
+		sum += (_msb << 8) | *data++;
+		len--;
+		_pending = false;
+	}
+	for (; len >= 2; len -= 2, data += 2)
+		sum += (data[0] << 8) | data[1];
+	if (len) {
+		_msb = *data;
+		_pending = true;
+	}
+	_sum = sum & 0xffff;
+}
+
+/* ---------------------- */
+/*        SHA-256         */
+/* ---------------------- */
+
+static const uint32_t sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+SHA256::SHA256()
+{
+	reset();
+}
+
+void SHA256::reset()
+{
+	static const uint32_t init[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+		0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+	};
+	memcpy(_state, init, sizeof(_state));
+	_length = 0;
+	_buffer_len = 0;
+}
+
+void SHA256::transform(const uint8_t *block)
+{
+	uint32_t w[64];
+	for (int i = 0; i < 16; i++)
+		w[i] = ((uint32_t)block[4 * i] << 24) |
+			((uint32_t)block[4 * i + 1] << 16) |
+			((uint32_t)block[4 * i + 2] << 8) |
+			((uint32_t)block[4 * i + 3]);
+	for (int i = 16; i < 64; i++) {
+		uint32_t s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^
+			(w[i - 15] >> 3);
+		uint32_t s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^
+			(w[i - 2] >> 10);
+		w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+	}
+
+	uint32_t a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+	uint32_t e = _state[4], f = _state[5], g = _state[6], h = _state[7];
+
+	for (int i = 0; i < 64; i++) {
+		uint32_t s1 = ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25);
+		uint32_t ch = (e & f) ^ (~e & g);
+		uint32_t t1 = h + s1 + ch + sha256_k[i] + w[i];
+		uint32_t s0 = ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22);
+		uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+		uint32_t t2 = s0 + maj;
+		h = g;
+		g = f;
+		f = e;
+		e = d + t1;
+		d = c;
+		c = b;
+		b = a;
+		a = t1 + t2;
+	}
+
+	_state[0] += a; _state[1] += b; _state[2] += c; _state[3] += d;
+	_state[4] += e; _state[5] += f; _state[6] += g; _state[7] += h;
+}
+
+void SHA256::update(const uint8_t *data, size_t len)
+{
+	_length += len;
+
+	/* complete previous partial block */
+	if (_buffer_len > 0) {
+		size_t xfer = 64 - _buffer_len;
+		if (xfer > len)
+			xfer = len;
+		memcpy(_buffer + _buffer_len, data, xfer);
+		_buffer_len += xfer;
+		data += xfer;
+		len -= xfer;
+		if (_buffer_len < 64)
+			return;
+		transform(_buffer);
+		_buffer_len = 0;
+	}
+
+	/* full blocks directly from user buffer */
+	for (; len >= 64; len -= 64, data += 64)
+		transform(data);
+
+	memcpy(_buffer, data, len);
+	_buffer_len = len;
+}
+
+void SHA256::final(uint8_t digest[32])
+{
+	uint64_t bit_len = _length * 8;
+	uint8_t pad[72];
+	size_t pad_len = (_buffer_len < 56) ? 56 - _buffer_len :
+		120 - _buffer_len;
+	memset(pad, 0, sizeof(pad));
+	pad[0] = 0x80;
+	for (int i = 0; i < 8; i++)
+		pad[pad_len + i] = (uint8_t)(bit_len >> (56 - 8 * i));
+	update(pad, pad_len + 8);
+
+	for (int i = 0; i < 8; i++) {
+		digest[4 * i]     = (uint8_t)(_state[i] >> 24);
+		digest[4 * i + 1] = (uint8_t)(_state[i] >> 16);
+		digest[4 * i + 2] = (uint8_t)(_state[i] >> 8);
+		digest[4 * i + 3] = (uint8_t)(_state[i]);
+	}
+}
+
+std::string SHA256::hexdigest()
+{
+	uint8_t digest[32];
+	char hex[65];
+	final(digest);
+	for (int i = 0; i < 32; i++)
+		snprintf(hex + 2 * i, 3, "%02x", digest[i]);
+	return std::string(hex, 64);
+}
+
+std::string SHA256::hash(const uint8_t *data, size_t len)
+{
+	SHA256 sha;
+	sha.update(data, len);
+	return sha.hexdigest();
+}
@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#ifndef SRC_CHECKSUM_HPP_
+#define SRC_CHECKSUM_HPP_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <string>
+
+/*!
+ * \file checksum.hpp
+ * \brief integrity helpers shared by parsers and flash access.
+ *        Each algorithm is a streaming class: update() may be called
+ *        as many time as required with successive chunks
+ */
+
+/*!
+ * \class CRC32
+ * \brief CRC-32 (IEEE 802.3, reflected polynomial 0xedb88320) computed
+ *        8 Bytes at a time (slicing-by-8)
+ */
+class CRC32 {
+ public:
+	/*!
+	 * \param[in] init: register initial value
+	 */
+	explicit CRC32(uint32_t init = 0xffffffff): _crc(init) {}
+	/*!
+	 * \brief restart a new computation
+	 */
+	void reset(uint32_t init = 0xffffffff) {_crc = init;}
+	/*!
+	 * \brief add len Bytes from data
+	 */
+	void update(const uint8_t *data, size_t len) {_crc = compute(_crc, data, len);}
+	/*!
+	 * \brief register content, without final inversion (DFU suffix)
+	 */
+	uint32_t value() const {return _crc;}
+	/*!
+	 * \brief standard CRC-32 (register inverted)
+	 */
+	uint32_t final() const {return ~_crc;}
+
+	/*!
+	 * \brief update a CRC register with len Bytes
+	 * \param[in] crc: current register value
+	 * \return new register value
+	 */
+	static uint32_t compute(uint32_t crc, const uint8_t *data, size_t len);
+	/*!
+	 * \brief one shot standard CRC-32
+	 */
+	static uint32_t crc(const uint8_t *data, size_t len) {
+		return ~compute(0xffffffff, data, len);
+	}
+
+ private:
+	uint32_t _crc;
+};
+
+/*!
+ * \class CRC16
+ * \brief 16 bits CRC, Byte table driven
+ */
+class CRC16 {
+ public:
+	enum crc16_variant {
+		CRC16_CCITT_FALSE = 0, /**< poly 0x1021, init 0xffff, MSB first */
+		CRC16_XMODEM,          /**< poly 0x1021, init 0x0000, MSB first */
+		CRC16_MODBUS,          /**< poly 0x8005, init 0xffff, LSB first */
+		CRC16_ARC              /**< poly 0x8005, init 0x0000, LSB first */
+	};
+
+	explicit CRC16(crc16_variant variant = CRC16_CCITT_FALSE);
+	/*!
+	 * \brief restart a new computation
+	 */
+	void reset();
+	/*!
+	 * \brief add len Bytes from data
+	 */
+	void update(const uint8_t *data, size_t len);
+	uint16_t value() const {return _crc;}
+
+	/*!
+	 * \brief one shot CRC
+	 */
+	static uint16_t crc(const uint8_t *data, size_t len,
+			crc16_variant variant = CRC16_CCITT_FALSE);
+
+ private:
+	crc16_variant _variant;
+	bool _reflected;
+	const uint16_t *_table;
+	uint16_t _crc;
+};
+
+/*!
+ * \class Adler32
+ * \brief zlib Adler-32 (modulo deferred every 5552 Bytes)
+ */
+class Adler32 {
+ public:
+	Adler32(): _a(1), _b(0) {}
+	void reset() {_a = 1; _b = 0;}
+	void update(const uint8_t *data, size_t len);
+	uint32_t value() const {return (_b << 16) | _a;}
+
+ private:
+	uint32_t _a;
+	uint32_t _b;
+};
+
+/*!
+ * \class Fletcher16
+ * \brief Fletcher-16 (sums modulo 255)
+ */
+class Fletcher16 {
+ public:
+	Fletcher16(): _sum1(0), _sum2(0) {}
+	void reset() {_sum1 = 0; _sum2 = 0;}
+	void update(const uint8_t *data, size_t len);
+	uint16_t value() const {return static_cast<uint16_t>((_sum2 << 8) | _sum1);}
+
+ private:
+	uint32_t _sum1;
+	uint32_t _sum2;
+};
+
+/*!
+ * \class Sum16
+ * \brief 16 bits additive checksum (JEDEC fuse checksum, Gowin
+ *        configuration data checksum): sum of Bytes or of big endian
+ *        16 bits words. In word mode, an odd Byte is kept for next
+ *        update and counted as MSB of a zero padded word by value()
+ */
+class Sum16 {
+ public:
+	explicit Sum16(bool words = false): _words(words), _sum(0),
+		_pending(false), _msb(0) {}
+	void reset() {_sum = 0; _pending = false;}
+	void update(const uint8_t *data, size_t len);
+	uint16_t value() const {
+		return static_cast<uint16_t>(_sum + ((_pending) ? (_msb << 8) : 0));
+	}
+
+ private:
+	bool _words;
+	uint32_t _sum;
+	bool _pending;  /**< word mode: _msb waits for its LSB */
+	uint8_t _msb;
+};
+
+/*!
+ * \class SHA256
+ * \brief FIPS 180-4 SHA-256
+ */
+class SHA256 {
+ public:
+	SHA256();
+	/*!
+	 * \brief restart a new computation
+	 */
+	void reset();
+	/*!
+	 * \brief hash len Bytes from data
+	 */
+	void update(const uint8_t *data, size_t len);
+	/*!
+	 * \brief finalize computation (reset must be called before reuse)
+	 * \param[out] digest: 32 Bytes hash
+	 */
+	void final(uint8_t digest[32]);
+	/*!
+	 * \brief finalize computation
+	 * \return hash as lower case hexadecimal string
+	 */
+	std::string hexdigest();
+
+	/*!
+	 * \brief one shot hash
+	 * \return hash as lower case hexadecimal string
+	 */
+	static std::string hash(const uint8_t *data, size_t len);
+
+ private:
+	void transform(const uint8_t *block);
+
+	uint32_t _state[8];
+	uint64_t _length;     /**< total length (in Byte) */
+	uint8_t _buffer[64];  /**< partial block */
+	size_t _buffer_len;
+};
+
+#endif  // SRC_CHECKSUM_HPP_
@@ -17,6 +17,7 @@
 #include <string>
 #include <vector>
 
+#include "bufferPool.hpp"
 #include "display.hpp"
 
 #include "cmsisDAP.hpp"
@@ -436,13 +437,13 @@ int CmsisDAP::writeJtagSequence(uint8_t tms, uint8_t *tx, uint8_t *rx,
 	 */
 	if (end) {
 		byte_to_read++;   // residual (or 0) from previous iter + 1 Byte
-		uint8_t val[byte_to_read];
+		BufferPool::Buffer val(byte_to_read);
 		_buffer[0] = seq_num + 1;
 		_buffer[pos++] = ((rx) ? DAP_JTAG_SEQ_TDO_CAPTURE : 0) |
 								  DAP_JTAG_SEQ_TMS_SHIFT(0x01&(!tms)) |
 								  DAP_JTAG_SEQ_NB_TCK(1);
 		_buffer[pos++] = (tx[(real_len) >> 3] & (1 << (real_len & 0x07))) ? 1 : 0;
-		ret = xfer(DAP_JTAG_SEQUENCE, pos, (rx) ? val: NULL, byte_to_read);
+		ret = xfer(DAP_JTAG_SEQUENCE, pos, (rx) ? val.data() : NULL, byte_to_read);
 		if (ret <= 0) {
 			printError("writeTDI: failed to send last sequence");
 			return ret;
@@ -473,7 +474,7 @@ int CmsisDAP::writeTDI(uint8_t *tx, uint8_t *rx, uint32_t len, bool end)
 int CmsisDAP::toggleClk(uint8_t tms, uint8_t tdi, uint32_t clk_len)
 {
 	const int byte_len = (clk_len + 7) / 8;
-	uint8_t tx[byte_len];
+	BufferPool::Buffer tx(byte_len);
 	memset(tx, (tdi) ? 0xff : 0x00, byte_len);
 	/* use false as last param to maintain tms in the current state */
 	return writeJtagSequence(tms, tx, NULL, clk_len, false);
@@ -648,8 +649,10 @@ void CmsisDAP::display_info(uint8_t info, uint8_t type)
 						(buffer[3] << 8) | buffer[2];
 		printf("%u\n", val);
 	} else {
-		char val[ret];
+		/* string may be not NUL terminated */
+		BufferPool::Buffer val(ret + 1);
 		memcpy(val, &buffer[2], ret);
-		printf("%s\n", val);
+		val[ret] = '\0';
+		printf("%s\n", reinterpret_cast<char *>(val.data()));
 	}
 }
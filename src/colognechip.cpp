@@ -4,6 +4,7 @@
  * Copyright (C) 2021 Cologne Chip AG <support@colognechip.com>
  */
 
+#include "bufferPool.hpp"
 #include "colognechip.hpp"
 
 #define JTAG_CONFIGURE  0x06
@@ -101,7 +102,7 @@ bool CologneChip::cfgDone()
 /**
  * Prints information if configuration was successful.
  */
-void CologneChip::waitCfgDone()
+bool CologneChip::waitCfgDone()
 {
 	uint32_t timeout = 1000;
 
@@ -112,9 +113,10 @@ void CologneChip::waitCfgDone()
 	} while (!cfgDone() && timeout > 0);
 	if (timeout == 0) {
 		printError("FAIL");
-	} else {
-		printSuccess("DONE");
+		return false;
 	}
+	printSuccess("DONE");
+	return true;
 }
 
 /**
@@ -166,11 +168,11 @@ bool CologneChip::dumpFlash(uint32_t base_addr, uint32_t len)
  * Parse bitstream from *.bit or *.cfg and program FPGA in SPI or JTAG mode
  * or write configuration to external flash via SPI or JTAG-SPI-bypass.
  */
-void CologneChip::program(unsigned int offset, bool unprotect_flash)
+bool CologneChip::program(unsigned int offset, bool unprotect_flash)
 {
 	/* nothing to do here */
 	if (_mode == Device::NONE_MODE || _mode == Device::READ_MODE)
-		return;
+		return true;
 
 	ConfigBitstreamParser *cfg;
 	if (_file_extension == "cfg") {
@@ -185,36 +187,43 @@ void CologneChip::program(unsigned int offset, bool unprotect_flash)
 		}
 	}
 
-	cfg->parse();
+	if (cfg->parse() == EXIT_FAILURE) {
+		printError("Failed to parse " + _filename);
+		delete cfg;
+		return false;
+	}
 
 	uint8_t *data = cfg->getData();
 	int length = cfg->getLength() / 8;
 
+	bool ret = true;
 	switch (_mode) {
 		case Device::FLASH_MODE:
 			if (_jtag != NULL) {
-				programJTAG_flash(offset, data, length, unprotect_flash);
+				ret = programJTAG_flash(offset, data, length, unprotect_flash);
 			} else if (_jtag == NULL) {
-				programSPI_flash(offset, data, length, unprotect_flash);
+				ret = programSPI_flash(offset, data, length, unprotect_flash);
 			}
 			break;
 		case Device::MEM_MODE:
 			if (_jtag != NULL) {
-				programJTAG_sram(data, length);
+				ret = programJTAG_sram(data, length);
 			} else if (_jtag == NULL) {
-				programSPI_sram(data, length);
+				ret = programSPI_sram(data, length);
 			}
 			break;
 		default: /* avoid warning */
 			break;
 	}
+	delete cfg;
+	return ret;
 }
 
 /**
  * Write configuration into FPGA latches via SPI after active reset.
  * CFG_MD[3:0] must be set to 0x40 (SPI passive).
  */
-void CologneChip::programSPI_sram(uint8_t *data, int length)
+bool CologneChip::programSPI_sram(uint8_t *data, int length)
 {
 	/* hold device in reset for a moment */
 	reset();
@@ -223,10 +232,11 @@ void CologneChip::programSPI_sram(uint8_t *data, int length)
 	_spi->gpio_set(_rstn_pin);
 	_spi->spi_put(data, recv, length); // TODO _spi->spi_put(data, null, length) does not work?
 
-	waitCfgDone();
+	bool ret = waitCfgDone();
 
 	_spi->gpio_set(_oen_pin);
 	delete [] recv;
+	return ret;
 }
 
 /**
@@ -234,7 +244,7 @@ void CologneChip::programSPI_sram(uint8_t *data, int length)
  * done, release reset to start FPGA in active SPI mode (load from flash).
  * CFG_MD[3:0] must be set to 0x00 (SPI active).
  */
-void CologneChip::programSPI_flash(unsigned int offset, uint8_t *data,
+bool CologneChip::programSPI_flash(unsigned int offset, uint8_t *data,
 		int length, bool unprotect_flash)
 {
 	/* hold device in reset during flash write access */
@@ -248,25 +258,27 @@ void CologneChip::programSPI_flash(unsigned int offset, uint8_t *data,
 
 	printf("%02x\n", flash.read_status_reg());
 	flash.read_id();
-	flash.erase_and_prog(offset, data, length);
+	bool ret = flash.erase_and_prog(offset, data, length) == 0;
 
 	/* verify write if required */
-	if (_verify)
-		flash.verify(offset, data, length);
+	if (ret && _verify)
+		ret = flash.verify(offset, data, length);
 
 	_spi->gpio_set(_rstn_pin);
 	usleep(SLEEP_US);
 
-	waitCfgDone();
+	if (!waitCfgDone())
+		ret = false;
 
 	_spi->gpio_set(_oen_pin);
+	return ret;
 }
 
 /**
  * Write configuration into FPGA latches via JTAG after active reset.
  * CFG_MD[3:0] must be set to 0xF0 (JTAG).
  */
-void CologneChip::programJTAG_sram(uint8_t *data, int length)
+bool CologneChip::programJTAG_sram(uint8_t *data, int length)
 {
 	/* hold device in reset for a moment */
 	reset();
@@ -294,16 +306,17 @@ void CologneChip::programJTAG_sram(uint8_t *data, int length)
 	progress.done();
 	_jtag->set_state(Jtag::RUN_TEST_IDLE);
 
-	waitCfgDone();
+	bool ret = waitCfgDone();
 
 	_ftdi_jtag->gpio_set(_oen_pin);
+	return ret;
 }
 
 /**
  * Write configuration to flash via JTAG-SPI-bypass. The FPGA will not start
  * as it is in JTAG mode with CFG_MD[3:0] set to 0xF0 (JTAG).
  */
-void CologneChip::programJTAG_flash(unsigned int offset, uint8_t *data,
+bool CologneChip::programJTAG_flash(unsigned int offset, uint8_t *data,
 		int length, bool unprotect_flash)
 {
 	/* hold device in reset for a moment */
@@ -315,13 +328,14 @@ void CologneChip::programJTAG_flash(unsigned int offset, uint8_t *data,
 
 	printf("%02x\n", flash.read_status_reg());
 	flash.read_id();
-	flash.erase_and_prog(offset, data, length);
+	bool ret = flash.erase_and_prog(offset, data, length) == 0;
 
 	/* verify write if required */
-	if (_verify)
-		flash.verify(offset, data, length);
+	if (ret && _verify)
+		ret = flash.verify(offset, data, length);
 
 	_ftdi_jtag->gpio_set(_oen_pin);
+	return ret;
 }
 
 /**
@@ -330,8 +344,8 @@ void CologneChip::programJTAG_flash(unsigned int offset, uint8_t *data,
 int CologneChip::spi_put(uint8_t cmd, uint8_t *tx, uint8_t *rx, uint32_t len)
 {
 	int xfer_len = len + 1;
-	uint8_t jtx[xfer_len+2];
-	uint8_t jrx[xfer_len+2];
+	BufferPool::Buffer jtx(xfer_len+2);
+	BufferPool::Buffer jrx(xfer_len+2);
 
 	jtx[0] = ConfigBitstreamParser::reverseByte(cmd);
 
@@ -343,7 +357,7 @@ int CologneChip::spi_put(uint8_t cmd, uint8_t *tx, uint8_t *rx, uint32_t len)
 	_jtag->shiftIR(JTAG_SPI_BYPASS, 6, Jtag::SELECT_DR_SCAN);
 
 	int test = (rx == NULL) ? 8*xfer_len+1 : 8*xfer_len+2;
-	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx, test, Jtag::SELECT_DR_SCAN);
+	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx.data(), test, Jtag::SELECT_DR_SCAN);
 
 	if (rx != NULL) {
 		for (uint32_t i=0; i < len; i++) {
@@ -361,8 +375,8 @@ int CologneChip::spi_put(uint8_t cmd, uint8_t *tx, uint8_t *rx, uint32_t len)
 int CologneChip::spi_put(uint8_t *tx, uint8_t *rx, uint32_t len)
 {
 	int xfer_len = len;
-	uint8_t jtx[xfer_len+2];
-	uint8_t jrx[xfer_len+2];
+	BufferPool::Buffer jtx(xfer_len+2);
+	BufferPool::Buffer jrx(xfer_len+2);
 
 	if (tx != NULL) {
 		for (uint32_t i=0; i < len; i++)
@@ -370,7 +384,7 @@ int CologneChip::spi_put(uint8_t *tx, uint8_t *rx, uint32_t len)
 	}
 
 	_jtag->shiftIR(JTAG_SPI_BYPASS, 6, Jtag::SELECT_DR_SCAN);
-	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx, 8*xfer_len+1, Jtag::SELECT_DR_SCAN);
+	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx.data(), 8*xfer_len+1, Jtag::SELECT_DR_SCAN);
 
 	if (rx != NULL) {
 		for (uint32_t i=0; i < len; i++) {
@@ -33,7 +33,7 @@ class CologneChip: public Device, SPIInterface {
 		~CologneChip() {}
 
 		bool cfgDone();
-		void waitCfgDone();
+		bool waitCfgDone();
 		bool dumpFlash(uint32_t base_addr, uint32_t len) override;
 		virtual bool protect_flash(uint32_t len) override {
 			(void) len;
@@ -42,17 +42,17 @@ class CologneChip: public Device, SPIInterface {
 			printError("unprotect flash not supported"); return false;}
 		virtual bool bulk_erase_flash() override {
 			printError("bulk erase flash not supported"); return false;}
-		void program(unsigned int offset, bool unprotect_flash) override;
+		bool program(unsigned int offset, bool unprotect_flash) override;
 
 		int idCode() override {return 0;}
 		void reset() override;
 
 	private:
-		void programSPI_sram(uint8_t *data, int length);
-		void programSPI_flash(unsigned int offset, uint8_t *data, int length,
+		bool programSPI_sram(uint8_t *data, int length);
+		bool programSPI_flash(unsigned int offset, uint8_t *data, int length,
 				bool unprotect_flash);
-		void programJTAG_sram(uint8_t *data, int length);
-		void programJTAG_flash(unsigned int offset, uint8_t *data, int length,
+		bool programJTAG_sram(uint8_t *data, int length);
+		bool programJTAG_flash(unsigned int offset, uint8_t *data, int length,
 				bool unprotect_flash);
 
 		/* spi interface via jtag */
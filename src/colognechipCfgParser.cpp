@@ -4,7 +4,7 @@
  * Copyright (C) 2021 Cologne Chip AG <support@colognechip.com>
  */
 
-#include <sstream>
+#include <stdlib.h>
 
 #include "colognechipCfgParser.hpp"
 
@@ -15,17 +15,6 @@ CologneChipCfgParser::CologneChipCfgParser(const std::string &filename):
 
 int CologneChipCfgParser::parse()
 {
-	std::string buffer;
-	std::istringstream lineStream(_raw_data);
-
-	while (std::getline(lineStream, buffer, '\n')) {
-		std::string val = buffer.substr(0, buffer.find("//"));
-		val.erase(std::remove_if(val.begin(), val.end(), ::isspace), val.end());
-		if (val != "") {
-			_bit_data += std::stol(val, nullptr, 16);
-		}
-	}
-	_bit_length = _bit_data.size() * 8;
-
-	return EXIT_SUCCESS;
+	/* values may be followed by a "//" comment */
+	return (decodeHexLines(true)) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -3,10 +3,15 @@
  * Copyright (C) 2019 Gwenhael Goavec-Merou <gwenhael.goavec-merou@trabucayre.com>
  */
 
+#include <algorithm>
+#include <cctype>
+#include <fstream>
 #include <iostream>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <stdint.h>
+#include <string.h>
 #include <strings.h>
 #include <unistd.h>
 
@@ -28,12 +33,222 @@
 
 using namespace std;
 
+std::map<std::string, std::pair<std::string, std::string>>
+	ConfigBitstreamParser::_preloaded;
+std::mutex ConfigBitstreamParser::_preload_mutex;
+
 ConfigBitstreamParser::ConfigBitstreamParser(const string &filename, int mode,
 			bool verbose): _filename(filename), _bit_length(0),
 			_file_size(0), _verbose(verbose),
 			_bit_data(), _raw_data(), _hdr()
 {
 	(void) mode;
+	bool cached = false;
+	{
+		std::lock_guard<std::mutex> lock(_preload_mutex);
+		auto cache = _preloaded.find(filename);
+		if (cache != _preloaded.end()) {
+			_filename = cache->second.first;
+			_raw_data = cache->second.second;
+			cached = true;
+		}
+	}
+	if (!cached)
+		load_file(filename, &_filename, &_raw_data);
+	_file_size = _raw_data.size();
+	if (!filename.empty())
+		_bit_data.reserve(_file_size);
+}
+
+void ConfigBitstreamParser::preload(const string &filename)
+{
+	{
+		std::lock_guard<std::mutex> lock(_preload_mutex);
+		if (_preloaded.find(filename) != _preloaded.end())
+			return;
+	}
+	/* files may be loaded concurrently: no lock while reading */
+	std::pair<string, string> entry;
+	load_file(filename, &entry.first, &entry.second);
+
+	std::lock_guard<std::mutex> lock(_preload_mutex);
+	_preloaded.emplace(filename, std::move(entry));
+}
+
+void ConfigBitstreamParser::preload(const string &name, const uint8_t *data,
+		size_t len)
+{
+	std::pair<string, string> entry(name,
+		string(reinterpret_cast<const char *>(data), len));
+
+	std::lock_guard<std::mutex> lock(_preload_mutex);
+	_preloaded[name] = std::move(entry);
+}
+
+void ConfigBitstreamParser::unload(const string &name)
+{
+	std::lock_guard<std::mutex> lock(_preload_mutex);
+	_preloaded.erase(name);
+}
+
+/* printable text: lines of bits, hex values, intel hex records */
+static string sniff_text(const char *data, size_t len)
+{
+	const char *end = data + len;
+	const char *line = data;
+	while (line < end) {
+		const char *eol = static_cast<const char *>(
+			memchr(line, '\n', end - line));
+		/* last line may be truncated: only check complete lines */
+		if (!eol)
+			break;
+		const char *line_end = (eol > line && eol[-1] == '\r') ? eol - 1 : eol;
+		size_t line_len = line_end - line;
+		/* skip empty and comment lines */
+		if (line_len == 0 || line[0] == '/' || line[0] == '#') {
+			line = eol + 1;
+			continue;
+		}
+
+		if (line_len >= 11 && strncmp(line, "Feature Row", 11) == 0)
+			return "fea";
+		if (line[0] == ':') {  // intel hex record
+			for (const char *c = line + 1; c < line_end; c++)
+				if (!isxdigit(static_cast<unsigned char>(*c)))
+					return "";
+			return "mcs";
+		}
+		if (line[0] == '0' || line[0] == '1') {
+			const char *c = line;
+			while (c < line_end && (*c == '0' || *c == '1'))
+				c++;
+			if (c == line_end && line_len == 96)  // feature row
+				return "fea";
+			if (c == line_end && line_len >= 32 && (line_len % 8) == 0)
+				return "fs";
+		}
+		if (line_len == 2 && isxdigit(static_cast<unsigned char>(line[0])) &&
+				isxdigit(static_cast<unsigned char>(line[1])))
+			return "hex";
+		return "";
+	}
+	return "";
+}
+
+/* JEDEC content after STX: '*' terminated fields starting with a
+ * field identifier, up to ETX and its 4 hex digits checksum. true if at
+ * least one field or ETX is found before a non text Byte. A fuse list (L)
+ * may be longer than the sniffed buffer: its truncated content must be
+ * fuses only
+ */
+static bool sniff_jedec(const uint8_t *data, const uint8_t *end)
+{
+	static const char field_id[] = "ABCDEFGJKLNPQRSTUVXZ";
+	bool field = false;
+	while (data < end) {
+		uint8_t c = *data++;
+		if (c == 0x03) {  // ETX
+			if (field)
+				return true;
+			if (end - data < 4)
+				return false;
+			for (int i = 0; i < 4; i++)
+				if (!isxdigit(data[i]))
+					return false;
+			return true;
+		}
+		if (c == ' ' || c == '\r' || c == '\n' || c == '\t' || c == '*')
+			continue;
+		if (c == 0 || !strchr(field_id, c))
+			return false;
+		/* field content: text up to '*' */
+		const uint8_t id = c;
+		bool fuses = true;
+		while (data < end && *data != '*') {
+			c = *data++;
+			if ((c < 0x20 || c >= 0x7f) && c != '\r' && c != '\n' && c != '\t')
+				return false;
+			fuses &= isdigit(c) || isspace(c);
+		}
+		/* truncated by buffer size */
+		if (data == end)
+			return field || (id == 'L' && fuses);
+		field = true;
+		data++;
+	}
+	return field;
+}
+
+string ConfigBitstreamParser::sniffFormat(const string &filename)
+{
+	if (filename.empty())
+		return "";
+
+	char buf[512];
+	size_t len = 0;
+	bool cached = false;
+	{
+		/* preloaded content (file or memory buffer) */
+		std::lock_guard<std::mutex> lock(_preload_mutex);
+		auto cache = _preloaded.find(filename);
+		if (cache != _preloaded.end()) {
+			len = cache->second.second.copy(buf, sizeof(buf));
+			cached = true;
+		}
+	}
+	if (!cached) {
+		ifstream fd(filename, ifstream::binary);
+		if (!fd.is_open())
+			return "";
+		fd.read(buf, sizeof(buf));
+		len = fd.gcount();
+	}
+	const uint8_t *data = reinterpret_cast<const uint8_t *>(buf);
+	if (len < 4)
+		return "";
+
+	/* Xilinx bit: 9 Bytes field (0x0ff0 pattern) */
+	if (len >= 13 && data[0] == 0x00 && data[1] == 0x09 &&
+			data[2] == 0x0f && data[3] == 0xf0)
+		return "bit";
+	/* Lattice bit: optional "LSCC" then 0xff00 comment area (text) */
+	if (!memcmp(data, "LSCC", 4) || (data[0] == 0xff && data[1] == 0x00 &&
+			data[2] >= 0x20 && data[2] < 0x7f))
+		return "bit";
+	/* Intel POF */
+	if (!memcmp(data, "POF\0", 4))
+		return "pof";
+	/* gzip: type given by sub extension */
+	if (data[0] == 0x1f && data[1] == 0x8b)
+		return "";
+	/* Anlogic bit: "# " text header ended by an empty line, data
+	 * start with a 0x00
+	 */
+	if (data[0] == '#' && data[1] == ' ') {
+		static const char hdr_end[] = {'\n', '\n', '\0'};
+		if (std::search(buf, buf + len, hdr_end, hdr_end + 3) != buf + len)
+			return "bit";
+	}
+	/* JEDEC: STX after optional ASCII lines, followed by fields */
+	const uint8_t *stx = static_cast<const uint8_t *>(memchr(data, 0x02, len));
+	if (stx) {
+		bool text = true;
+		for (const uint8_t *c = data; c < stx && text; c++)
+			text = (*c >= 0x20 && *c < 0x7f) || *c == '\r' || *c == '\n' ||
+				*c == '\t';
+		if (text && sniff_jedec(stx + 1, data + len))
+			return "jed";
+	}
+
+	return sniff_text(buf, len);
+}
+
+void ConfigBitstreamParser::load_file(const string &filename,
+		string *real_name, string *data)
+{
+	*real_name = filename;
+	data->clear();
+
 	if (!filename.empty()) {
 		size_t offset =  filename.find_last_of(".");
 
@@ -41,8 +256,8 @@ ConfigBitstreamParser::ConfigBitstreamParser(const string &filename, int mode,
 		if (!_fd) {
 			/* if file not found it's maybe a gz -> try without gz */
 			if (offset != string::npos) {
-				_filename = filename.substr(0, offset);
-				_fd = fopen(_filename.c_str(), "rb");
+				*real_name = filename.substr(0, offset);
+				_fd = fopen(real_name->c_str(), "rb");
 			}
 
 			/* test again */
@@ -51,40 +266,34 @@ ConfigBitstreamParser::ConfigBitstreamParser(const string &filename, int mode,
 		}
 
 		fseek(_fd, 0, SEEK_END);
-		_file_size = ftell(_fd);
+		long file_size = ftell(_fd);
 		fseek(_fd, 0, SEEK_SET);
 
-		_raw_data.resize(_file_size);
+		data->resize(file_size);
 
-		int ret = fread((char *)&_raw_data[0], sizeof(char), _file_size, _fd);
+		long ret = fread((char *)&(*data)[0], sizeof(char), file_size, _fd);
 		fclose(_fd);
-		if (ret != _file_size)
-			throw std::runtime_error("Error: fail to read " + _filename);
+		if (ret != file_size)
+			throw std::runtime_error("Error: fail to read " + *real_name);
 
 		if (offset != string::npos) {
-			string extension = _filename.substr(_filename.find_last_of(".") +1);
+			string extension = real_name->substr(real_name->find_last_of(".") +1);
 			if (extension == "gz" || extension == "gzip") {
 				string tmp;
-				tmp.reserve(_file_size);
-				if (!decompress_bitstream(_raw_data, &tmp))
+				tmp.reserve(file_size);
+				if (!decompress_bitstream(*data, &tmp))
 					throw std::runtime_error("Error: decompress failed");
-				_raw_data.clear();
-				_raw_data.append(std::move(tmp));
-				_file_size = _raw_data.size();
+				*data = std::move(tmp);
 			}
 		}
-		_bit_data.reserve(_file_size);
-
 	} else if (!isatty(fileno(stdin))) {
-		_file_size = 0;
 		string tmp;
 		tmp.resize(4096);
 		size_t size;
 
 		do {
 			size = fread((char *)&tmp[0], sizeof(char), 4096, stdin);
-			_raw_data.append(tmp, 0, size);
-			_file_size += size;
+			data->append(tmp, 0, size);
 		} while (size > 0);
 	} else {
 		throw std::runtime_error("Error: fail to parse. No filename or pipe\n");
@@ -157,6 +366,99 @@ uint8_t ConfigBitstreamParser::reverseByte(uint8_t src)
 #endif
 }
 
+void ConfigBitstreamParser::reverseBytes(const uint8_t *src, uint8_t *dst,
+		size_t len)
+{
+	size_t i = 0;
+	/* 8 Bytes at a time: swap bits pairs, pairs of pairs and nibbles
+	 * inside each Byte
+	 */
+	for (; i + 8 <= len; i += 8) {
+		uint64_t v;
+		memcpy(&v, src + i, 8);
+		v = ((v >> 1) & 0x5555555555555555ULL) |
+			((v & 0x5555555555555555ULL) << 1);
+		v = ((v >> 2) & 0x3333333333333333ULL) |
+			((v & 0x3333333333333333ULL) << 2);
+		v = ((v >> 4) & 0x0f0f0f0f0f0f0f0fULL) |
+			((v & 0x0f0f0f0f0f0f0f0fULL) << 4);
+		memcpy(dst + i, &v, 8);
+	}
+	for (; i < len; i++)
+		dst[i] = revertByteArr[src[i]];
+}
+
+/* hexadecimal digits value, or class of other characters */
+#define HEX_SPACE   0x10
+#define HEX_INVALID 0xff
+
+namespace {
+struct HexTable {
+	uint8_t val[256];
+	HexTable() {
+		memset(val, HEX_INVALID, sizeof(val));
+		for (int i = 0; i < 10; i++)
+			val['0' + i] = i;
+		for (int i = 0; i < 6; i++) {
+			val['a' + i] = 10 + i;
+			val['A' + i] = 10 + i;
+		}
+		val[' '] = val['\t'] = val['\r'] = val['\v'] = val['\f'] = HEX_SPACE;
+	}
+};
+const HexTable hex_table;
+}  // namespace
+
+bool ConfigBitstreamParser::decodeHexLines(bool comments)
+{
+	const uint8_t *tab = hex_table.val;
+	const uint8_t *p = reinterpret_cast<const uint8_t *>(_raw_data.data());
+	const uint8_t *end = p + _raw_data.size();
+
+	/* at most one Byte by line */
+	size_t nb_lines = 1 + std::count(_raw_data.begin(), _raw_data.end(), '\n');
+	_bit_data.resize(nb_lines);
+	uint8_t *out = reinterpret_cast<uint8_t *>(&_bit_data[0]);
+
+	while (p < end) {
+		/* usual line: two digits */
+		if (end - p >= 3 && p[2] == '\n' && (tab[p[0]] | tab[p[1]]) < 16) {
+			*out++ = (tab[p[0]] << 4) | tab[p[1]];
+			p += 3;
+			continue;
+		}
+
+		uint8_t val = 0;
+		bool has_val = false;
+		for (; p < end && *p != '\n'; p++) {
+			uint8_t t = tab[*p];
+			if (t < 16) {
+				val = (val << 4) | t;
+				has_val = true;
+			} else if (comments && *p == '/' && p + 1 < end && p[1] == '/') {
+				const void *eol = memchr(p, '\n', end - p);
+				p = (eol) ? static_cast<const uint8_t *>(eol) : end;
+				break;
+			} else if (t != HEX_SPACE) {
+				size_t line = 1 + std::count(_raw_data.data(),
+					reinterpret_cast<const char *>(p), '\n');
+				printError("Error: invalid character at line " +
+					std::to_string(line));
+				_bit_data.clear();
+				return false;
+			}
+		}
+		if (has_val)
+			*out++ = val;
+		if (p < end)
+			p++;  // '\n'
+	}
+
+	_bit_data.resize(out - reinterpret_cast<uint8_t *>(&_bit_data[0]));
+	_bit_length = _bit_data.size() * 8;
+	return true;
+}
+
 bool ConfigBitstreamParser::decompress_bitstream(string source, string *dest)
 {
 #ifndef HAS_ZLIB
@@ -12,6 +12,8 @@
 #include <fstream>
 #include <string>
 #include <map>
+#include <mutex>
+#include <utility>
 
 class ConfigBitstreamParser {
 	public:
@@ -21,6 +23,14 @@ class ConfigBitstreamParser {
 		virtual int parse() = 0;
 		uint8_t *getData() {return (uint8_t*)_bit_data.c_str();}
 		int getLength() {return _bit_length;}
+		/**
+		 * \brief decode file header only (device, idcode, length)
+		 *        without configuration data, so target compatibility may
+		 *        be checked before parse()
+		 * \return false when header can't be decoded or parser has no
+		 *         header only mode
+		 */
+		virtual bool readHeader() {return false;}
 
 		/**
 		 * \brief display header informations
@@ -46,8 +56,58 @@ class ConfigBitstreamParser {
 		};
 
 		static uint8_t reverseByte(uint8_t src);
+		/**
+		 * \brief reverse bits order of each Byte of a buffer
+		 * \param[in] src: source buffer
+		 * \param[out] dst: destination buffer (may be src)
+		 * \param[in] len: buffer length (Byte)
+		 */
+		static void reverseBytes(const uint8_t *src, uint8_t *dst, size_t len);
+
+		/**
+		 * \brief read (and uncompress) a file once and keep its content:
+		 *        next parsers created with the same filename use it
+		 *        instead of accessing the file (or stdin when filename
+		 *        is empty) again. May be called from several threads
+		 * \param[in] filename: file to load
+		 */
+		static void preload(const std::string &filename);
+		/**
+		 * \brief same as preload but content is a memory buffer: parsers
+		 *        created with name fill their raw data from it, no file
+		 *        with this name is accessed
+		 * \param[in] name: name given to parsers instead of a filename
+		 * \param[in] data: file content (uncompressed)
+		 * \param[in] len: content length (Byte)
+		 */
+		static void preload(const std::string &name, const uint8_t *data,
+			size_t len);
+		/**
+		 * \brief forget a preloaded content
+		 * \param[in] name: filename or name given to preload
+		 */
+		static void unload(const std::string &name);
+
+		/**
+		 * \brief identify file format by its first Bytes (magic
+		 *        numbers / syntax), without reading the full file
+		 * \param[in] filename: file to check
+		 * \return file type as used for extension (bit, jed, mcs, fs,
+		 *         fea, pof, hex) or an empty string when unknown
+		 *         (raw binary, compressed file, stdin)
+		 */
+		static std::string sniffFormat(const std::string &filename);
 
 	private:
+		/**
+		 * \brief read a file (or stdin when filename is empty), gzip
+		 *        files are uncompressed
+		 * \param[in] filename: file to read
+		 * \param[out] real_name: filename really opened
+		 * \param[out] data: file content
+		 */
+		static void load_file(const std::string &filename,
+			std::string *real_name, std::string *data);
 		/**
 		 * \brief decompress bitstream in gzip format
 		 * \param[in] source: raw compressed data
@@ -55,9 +115,23 @@ class ConfigBitstreamParser {
 		 * \return false if openFPGALoader is build without zlib or
 		 *              if uncompress fails
 		 */
-		bool decompress_bitstream(std::string source, std::string *dest);
+		static bool decompress_bitstream(std::string source, std::string *dest);
+
+		/* preloaded files: filename -> (real filename, content) */
+		static std::map<std::string,
+			std::pair<std::string, std::string>> _preloaded;
+		static std::mutex _preload_mutex;
 
 	protected:
+		/**
+		 * \brief decode _raw_data text with one hexadecimal value by
+		 *        line into _bit_data (low Byte of each value is kept).
+		 *        Spaces and empty lines are ignored
+		 * \param[in] comments: ignore "//" comments
+		 * \return false if a line contains a non hexadecimal character
+		 */
+		bool decodeHexLines(bool comments);
+
 		std::string _filename;
 		int _bit_length;
 		int _file_size;
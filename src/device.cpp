@@ -4,9 +4,12 @@
  */
 
 #include <iostream>
+#include <set>
 #include <stdexcept>
 
+#include "configBitstreamParser.hpp"
 #include "device.hpp"
+#include "display.hpp"
 
 using namespace std;
 
@@ -44,6 +47,19 @@ Device::Device(Jtag *jtag, string filename, const string &file_type,
 		}
 	}
 
+	/* no or unknown extension: identify type from file content */
+	static const std::set<string> known_types = {"bin", "bit", "cfg", "fea",
+		"fs", "hex", "jed", "jic", "mcs", "pof", "pub", "rbf", "rpd", "svf"};
+	if (file_type.empty() && !filename.empty() &&
+			known_types.find(_file_extension) == known_types.end()) {
+		string sniffed = ConfigBitstreamParser::sniffFormat(filename);
+		if (!sniffed.empty()) {
+			if (verbose > 0)
+				printInfo("File type deduced from content: " + sniffed);
+			_file_extension = sniffed;
+		}
+	}
+
 	_jtag = jtag;
 	if (verbose > 0)
 		cout << "File type : " << _file_extension << endl;
@@ -12,6 +12,9 @@
 #include "display.hpp"
 #include "jtag.hpp"
 
+class FlashLayout;
+class JtagStream;
+
 /* GGM: TODO: program must have an optional
  * offset
  * and question: bitstream to load bitstream in SPI mode must
@@ -37,7 +40,13 @@ class Device {
 		Device(Jtag *jtag, std::string filename, const std::string &file_type,
 				bool verify, int8_t verbose = false);
 		virtual ~Device();
-		virtual void program(unsigned int offset,
+		/*!
+		 * \brief load bitstream (SRAM or flash, according to mode)
+		 * \param[in] offset: flash offset
+		 * \param[in] unprotect_flash: unprotect blocks if required
+		 * \return false if load or verify fails
+		 */
+		virtual bool program(unsigned int offset,
 				bool unprotect_flash) = 0;
 
 		/**********************/
@@ -46,6 +55,23 @@ class Device {
 		virtual bool dumpFlash(uint32_t base_addr, uint32_t len) {
 			(void) base_addr; (void) len;
 			printError("dump flash not supported"); return false;}
+		/*!
+		 * \brief write only partitions of a flash layout
+		 *        with a content different from the flash
+		 * \param[in] layout: partitions list
+		 * \param[in] unprotect_flash: unprotect blocks if required
+		 * \return false if something wrong
+		 */
+		virtual bool program_layout(FlashLayout &layout,
+				bool unprotect_flash) {
+			(void) layout; (void) unprotect_flash;
+			printError("flash layout not supported"); return false;}
+		/*!
+		 * \brief rewrite flash sectors found mismatched by verify
+		 *        (default: mismatches are only reported)
+		 * \param[in] repair: enable rewrite
+		 */
+		virtual void set_verify_repair(bool repair) {(void) repair;}
 		virtual bool protect_flash(uint32_t len) = 0;
 		virtual bool unprotect_flash() = 0;
 		virtual bool bulk_erase_flash() = 0;
@@ -55,6 +81,16 @@ class Device {
 
 		virtual bool connectJtagToMCU() {return false;}
 
+		/*!
+		 * \brief open a byte stream with the FPGA through a user
+		 *        data register (see jtagStream.hpp)
+		 * \param[in] channel: register (device specific)
+		 * \return stream to delete by caller, NULL if not supported
+		 */
+		virtual JtagStream *open_stream(int channel) {
+			(void) channel;
+			printError("JTAG stream not supported"); return NULL;}
+
 	protected:
 		Jtag *_jtag;
 		std::string _filename;
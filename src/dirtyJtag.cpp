@@ -13,6 +13,7 @@
 #include <string>
 #include <cassert>
 
+#include "bufferPool.hpp"
 #include "dirtyJtag.hpp"
 #include "display.hpp"
 
@@ -247,7 +248,7 @@ int DirtyJtag::writeTDI(uint8_t *tx, uint8_t *rx, uint32_t len, bool end)
 	uint32_t real_bit_len = len - (end ? 1 : 0);
 	uint32_t kRealByteLen = (len + 7) / 8;
 
-	uint8_t tx_cpy[kRealByteLen];
+	BufferPool::Buffer tx_cpy(kRealByteLen);
 	uint8_t tx_buf[512], rx_buf[512];
 	uint8_t *tx_ptr, *rx_ptr = rx;
 
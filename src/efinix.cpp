@@ -12,6 +12,7 @@
 #include <stdexcept>
 #include <string>
 
+#include "bufferPool.hpp"
 #include "common.hpp"
 #include "device.hpp"
 #include "display.hpp"
@@ -164,12 +165,12 @@ void Efinix::reset()
 		printSuccess("DONE");
 }
 
-void Efinix::program(unsigned int offset, bool unprotect_flash)
+bool Efinix::program(unsigned int offset, bool unprotect_flash)
 {
 	if (_file_extension.empty())
-		return;
+		return true;
 	if (_mode == Device::NONE_MODE)
-		return;
+		return true;
 
 	ConfigBitstreamParser *bit;
 	try {
@@ -184,7 +185,7 @@ void Efinix::program(unsigned int offset, bool unprotect_flash)
 		}
 	} catch (std::exception &e) {
 		printError("FAIL: " + std::string(e.what()));
-		return;
+		return false;
 	}
 
 	printInfo("Parse file ", false);
@@ -193,7 +194,7 @@ void Efinix::program(unsigned int offset, bool unprotect_flash)
 	} else {
 		printError("FAIL");
 		delete bit;
-		return;
+		return false;
 	}
 
 	const uint8_t *data = bit->getData();
@@ -202,22 +203,24 @@ void Efinix::program(unsigned int offset, bool unprotect_flash)
 	if (_verbose)
 		bit->displayHeader();
 
+	bool ret = true;
 	switch (_mode) {
 		case MEM_MODE:
 			programJTAG(data, length);
 			break;
 		case FLASH_MODE:
 			if (_jtag)
-				SPIInterface::write(offset, const_cast<uint8_t *>(data),
+				ret = SPIInterface::write(offset, const_cast<uint8_t *>(data),
 					length, unprotect_flash);
 			else
-				programSPI(offset, data, length, unprotect_flash);
+				ret = programSPI(offset, data, length, unprotect_flash);
 			break;
 		default:
-			return;
+			break;
 	}
 
 	delete bit;
+	return ret;
 }
 
 bool Efinix::dumpFlash(uint32_t base_addr, uint32_t len)
@@ -260,7 +263,7 @@ bool Efinix::dumpFlash(uint32_t base_addr, uint32_t len)
 	return false;
 }
 
-void Efinix::programSPI(unsigned int offset, const uint8_t *data,
+bool Efinix::programSPI(unsigned int offset, const uint8_t *data,
 		const int length, const bool unprotect_flash)
 {
 	_spi->gpio_clear(_rst_pin | _oe_pin);
@@ -272,13 +275,15 @@ void Efinix::programSPI(unsigned int offset, const uint8_t *data,
 
 	printf("%02x\n", flash.read_status_reg());
 	flash.read_id();
-	flash.erase_and_prog(offset, const_cast<uint8_t *>(data), length);
+	bool ret = flash.erase_and_prog(offset, const_cast<uint8_t *>(data),
+			length) == 0;
 
 	/* verify write if required */
-	if (_verify)
-		flash.verify(offset, data, length);
+	if (ret && _verify)
+		ret = flash.verify(offset, data, length);
 
 	reset();
+	return ret;
 }
 
 #define SAMPLE_PRELOAD 0x02
@@ -418,9 +423,9 @@ int Efinix::spi_put(uint8_t cmd,
 			uint8_t *tx, uint8_t *rx, uint32_t len)
 {
 	int kXferLen = len + 1 + ((rx == NULL) ? 0 : 1);
-	uint8_t jtx[kXferLen];
+	BufferPool::Buffer jtx(kXferLen);
 	jtx[0] = EfinixHexParser::reverseByte(cmd);
-	uint8_t jrx[kXferLen];
+	BufferPool::Buffer jrx(kXferLen);
 	if (tx != NULL) {
 		for (uint32_t i=0; i < len; i++)
 			jtx[i+1] = EfinixHexParser::reverseByte(tx[i]);
@@ -431,7 +436,7 @@ int Efinix::spi_put(uint8_t cmd,
 	 * in the same time store each byte
 	 * to next
 	 */
-	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx, 8*kXferLen);
+	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx.data(), 8*kXferLen);
 
 	if (rx != NULL) {
 		for (uint32_t i=0; i < len; i++)
@@ -443,8 +448,8 @@ int Efinix::spi_put(uint8_t cmd,
 int Efinix::spi_put(uint8_t *tx, uint8_t *rx, uint32_t len)
 {
 	int kXferLen = len + ((rx == NULL) ? 0 : 1);
-	uint8_t jtx[kXferLen];
-	uint8_t jrx[kXferLen];
+	BufferPool::Buffer jtx(kXferLen);
+	BufferPool::Buffer jrx(kXferLen);
 	if (tx != NULL) {
 		for (uint32_t i=0; i < len; i++)
 			jtx[i] = EfinixHexParser::reverseByte(tx[i]);
@@ -455,7 +460,7 @@ int Efinix::spi_put(uint8_t *tx, uint8_t *rx, uint32_t len)
 	 * in the same time store each byte
 	 * to next
 	 */
-	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx, 8*kXferLen);
+	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx.data(), 8*kXferLen);
 
 	if (rx != NULL) {
 		for (uint32_t i=0; i < len; i++)
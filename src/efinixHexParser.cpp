@@ -3,8 +3,7 @@
  * Copyright (C) 2020 Gwenhael Goavec-Merou <gwenhael.goavec-merou@trabucayre.com>
  */
 
-#include <sstream>
-#include <stdexcept>
+#include <stdlib.h>
 
 #include "configBitstreamParser.hpp"
 #include "display.hpp"
@@ -19,13 +18,5 @@ EfinixHexParser::EfinixHexParser(const string &filename):
 
 int EfinixHexParser::parse()
 {
-	string buffer;
-	istringstream lineStream(_raw_data);
-
-	while (std::getline(lineStream, buffer, '\n')) {
-		_bit_data += std::stol(buffer, nullptr, 16);
-	}
-	_bit_length = _bit_data.size() * 8;
-
-	return EXIT_SUCCESS;
+	return (decodeHexLines(false)) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -5,9 +5,15 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <strings.h>
+#include <string.h>
 
+#include <map>
+#include <stdexcept>
+
+#include "bufferPool.hpp"
+#include "display.hpp"
 #include "epcq.hpp"
+#include "progressBar.hpp"
 
 #define RD_STATUS_REG       0x05
 #  define STATUS_REG_WEL    (0x01 << 1)
@@ -16,62 +22,187 @@
 #define RD_DEV_ID_REG       0x9F
 #define RD_SILICON_ID_REG   0xAB
 #define RD_FAST_READ_REG    0x0B
-/* TBD */
 #define WR_ENABLE_REG       0x06
 #define WR_DISABLE_REG      0x04
 #define WR_STATUS_REG       0x01
 #define WR_BYTES_REG        0x02
-/* TBD */
 #define ERASE_BULK_REG      0xC7
 #define ERASE_SECTOR_REG    0xD8
 #define ERASE_SUBSECTOR_REG 0x20
 #define RD_SFDP_REG_REG     0x5A
 
-#define SECTOR_SIZE			65536
+/* EPCS devices have no JEDEC ID: silicon ID and sector size */
+typedef struct {
+	uint32_t sector_size; /**< ERASE_SECTOR_REG size (Byte) */
+	flash_t flash;        /**< description (nr_sector is in 64KB unit) */
+} epcs_t;
 
-void EPCQ::dumpJICFile(char *jic_file, char *out_file, size_t max_len)
-{
-	int offset = 0xA1;
-	unsigned char c;
-	size_t i = 0;
-
-	FILE *jic = fopen(jic_file, "r");
-	fseek(jic, offset, SEEK_SET);
-	FILE *out = fopen(out_file, "w");
-	for (i=0; i < max_len && (1 == fread(&c, 1, 1, jic)); i++) {
-		fprintf(out, "%zx %x\n", i, c);
+#define EPCS_ENTRY(_model, _sector_size, _nr_sector) { \
+	.sector_size = _sector_size, \
+	.flash = { \
+		.manufacturer = "altera", \
+		.model = _model, \
+		.nr_sector = _nr_sector, \
+		.sector_erase = true, \
+		.subsector_erase = false, \
+		.has_extended = false, \
+		.tb_otp = false, \
+		.tb_offset = 0, \
+		.tb_register = NONER, \
+		.bp_len = 0, \
+		.bp_offset = {0, 0, 0, 0}, \
+		.sector_erase_ms = 0, \
+		.subsector_erase_ms = 0, \
+		.page_prog_us = 0} \
 	}
-	fclose(jic);
-	fclose(out);
+
+static std::map<uint8_t, epcs_t> epcs_list = {
+	{0x10, EPCS_ENTRY("EPCS1",   0x08000,   2)},
+	{0x12, EPCS_ENTRY("EPCS4",   0x10000,   8)},
+	{0x14, EPCS_ENTRY("EPCS16",  0x10000,  32)},
+	{0x16, EPCS_ENTRY("EPCS64",  0x10000, 128)},
+	{0x18, EPCS_ENTRY("EPCS128", 0x40000, 256)},
+};
+
+EPCQ::EPCQ(SPIInterface *spi, bool unprotect_flash, int8_t verbose):
+	SPIFlash(spi, unprotect_flash, verbose, false), _sector_size(0),
+	_silicon_id(0)
+{
+	/* probed here: EPCS fallback is only seen from EPCQ methods */
+	reset();
+	power_up();
+	read_id();
 }
 
+EPCQ::~EPCQ()
+{}
+
 void EPCQ::read_id()
 {
-	unsigned char rx_buf[5];
-	/* read EPCQ device id */
-	/* 2 dummy_byte + 1byte */
-	_spi->spi_put(0x9F, NULL, rx_buf, 3);
-	_device_id = rx_buf[2];
-	if (_verbose)
-		printf("device id 0x%x attendu 0x15\n", _device_id);
-	/* read EPCQ silicon id */
-	/* 3 dummy_byte + 1 byte*/
-	_spi->spi_put(0xAB, NULL, rx_buf, 4);
+	/* EPCQ: JEDEC compliant (micron N25Q) */
+	try {
+		SPIFlash::read_id();
+	} catch (std::exception &e) {
+		if (_verbose > 0)
+			printInfo(e.what());
+		_jedec_id = 0xffffffff;
+	}
+	if (!_flash_model && no_jedec_id())
+		read_silicon_id();
+}
+
+bool EPCQ::no_jedec_id()
+{
+	uint32_t id = _jedec_id >> 8;
+	return id == 0 || id == 0xffffff;
+}
+
+void EPCQ::read_silicon_id()
+{
+	/* EPCS: read silicon ID: 3 dummy Bytes + 1 Byte */
+	unsigned char rx_buf[4];
+	_spi->spi_put(RD_SILICON_ID_REG, NULL, rx_buf, 4);
 	_silicon_id = rx_buf[3];
-	if (_verbose)
-		printf("silicon id 0x%x attendu 0x14\n", _silicon_id);
+	if (_verbose > 0)
+		printf("silicon id 0x%02x\n", _silicon_id);
+
+	auto t = epcs_list.find(_silicon_id);
+	if (t == epcs_list.end()) {
+		char mess[64];
+		snprintf(mess, sizeof(mess), "Unknown EPCS silicon ID 0x%02x",
+				_silicon_id);
+		throw std::runtime_error(mess);
+	}
+
+	_jedec_id = _silicon_id;
+	_sector_size = t->second.sector_size;
+	_flash_model = &t->second.flash;
+
+	char content[256];
+	snprintf(content, 256, "Detected: %s %s %u sectors size: %uMb",
+			_flash_model->manufacturer.c_str(), _flash_model->model.c_str(),
+			_flash_model->nr_sector * 0x10000 / _sector_size,
+			_flash_model->nr_sector * 0x80000 / 1048576);
+	printInfo(content);
 }
 
 void EPCQ::reset()
 {
-	printf("reset\n");
+	if (_verbose > 0)
+		printf("reset\n");
 	_spi->spi_put(0x66, NULL, NULL, 0);
 	_spi->spi_put(0x99, NULL, NULL, 0);
 }
 
-EPCQ::EPCQ(SPIInterface *spi, bool unprotect_flash, int8_t verbose):
-	SPIFlash(spi, unprotect_flash, verbose), _device_id(0), _silicon_id(0)
-{}
+int EPCQ::read(int base_addr, uint8_t *data, int len)
+{
+	/* 4 Bytes address: no fast read variant in generic path */
+	if (base_addr > 0xffffff)
+		return SPIFlash::read(base_addr, data, len);
 
-EPCQ::~EPCQ()
-{}
+	/* 3 Bytes address + 1 dummy Byte (8 clk cycles) */
+	const int hdr_len = 4;
+	BufferPool::Buffer tx(len + hdr_len);
+	BufferPool::Buffer rx(len + hdr_len);
+
+	tx[0] = (uint8_t)(0xff & (base_addr >> 16));
+	tx[1] = (uint8_t)(0xff & (base_addr >>  8));
+	tx[2] = (uint8_t)(0xff & (base_addr      ));
+	tx[3] = 0x00;
+
+	int ret = _spi->spi_put(RD_FAST_READ_REG, tx, rx, len + hdr_len);
+	if (ret == 0)
+		memcpy(data, rx + hdr_len, len);
+	else
+		printError("EPCQ: fast read failed");
+	return ret;
+}
+
+int EPCQ::sectors_erase(int base_addr, int len, ProgressBar *ext_progress)
+{
+	if (_sector_size == 0)
+		return SPIFlash::sectors_erase(base_addr, len, ext_progress);
+
+	/* EPCS: only sector erase, with a device specific size */
+	int ret = 0;
+	int start_addr = base_addr & ~(_sector_size - 1);
+	int end_addr = (base_addr + len + _sector_size - 1) & ~(_sector_size - 1);
+	ProgressBar local_progress("Erasing", end_addr - start_addr, 50,
+			_verbose < 0);
+	ProgressBar *progress = (ext_progress) ? ext_progress : &local_progress;
+	local_progress.showRate(true);
+
+	for (int addr = start_addr; addr < end_addr; addr += _sector_size) {
+		if (write_enable() == -1) {
+			ret = -1;
+			break;
+		}
+		/* same opcode as 64KB block erase */
+		if (block64_erase(addr) == -1) {
+			ret = -1;
+			break;
+		}
+		/* EPCS128 sector erase: up to 6s */
+		if (_spi->spi_wait(RD_STATUS_REG, STATUS_REG_WIP, 0x00, 1000000,
+					false) == -1) {
+			ret = -1;
+			break;
+		}
+		progress->display(addr - start_addr);
+	}
+
+	if (ext_progress)
+		return ret;
+	if (ret == 0)
+		local_progress.done();
+	else
+		local_progress.fail();
+	return ret;
+}
+
+uint32_t EPCQ::erase_granularity()
+{
+	if (_sector_size != 0)
+		return _sector_size;
+	return SPIFlash::erase_granularity();
+}
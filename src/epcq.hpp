@@ -13,29 +13,60 @@
 #include "spiInterface.hpp"
 #include "spiFlash.hpp"
 
-using namespace std;
-
+/*!
+ * \file epcq.hpp
+ * \class EPCQ
+ * \brief intel/altera active serial configuration devices (EPCS/EPCQ)
+ *        EPCQ are JEDEC compliant, EPCS are only identified by their
+ *        silicon ID and have device specific erase sector size
+ */
 class EPCQ: public SPIFlash {
  public:
 	EPCQ(SPIInterface *spi, bool unprotect_flash, int8_t verbose);
 	~EPCQ();
 
+	/*!
+	 * \brief read JEDEC ID (EPCQ) and fallback to silicon ID (EPCS)
+	 *        when flash doesn't answer
+	 */
 	void read_id() override;
 
 	void reset() override;
 
+	/*!
+	 * \brief read len Byte starting at base_addr using fast read
+	 *        (opcode + 3 Bytes address + 8 dummy cycles)
+	 * \param[in] base_addr: starting address in flash memory
+	 * \param[out] data: buffer to fill
+	 * \param[in] len: length (in Byte)
+	 * \return 0 when success
+	 */
+	int read(int base_addr, uint8_t *data, int len) override;
+
+	/*!
+	 * \brief erase sectors covering base_addr to base_addr + len
+	 *        using EPCS sector size (EPCQ: generic behavior)
+	 */
+	int sectors_erase(int base_addr, int len,
+			ProgressBar *progress = NULL) override;
+
 	/* not supported */
 	void power_up() override {}
 	void power_down() override {}
+	uint32_t erase_granularity() override;
 
-	private:
-		unsigned char convertLSB(unsigned char src);
-
-		/* trash */
-		void dumpJICFile(char *jic_file, char *out_file, size_t max_len);
+ private:
+	/*!
+	 * \brief check if JEDEC ID read has failed (EPCS)
+	 */
+	bool no_jedec_id();
+	/*!
+	 * \brief identify EPCS devices with silicon ID
+	 */
+	void read_silicon_id();
 
-		unsigned char _device_id;
-		unsigned char _silicon_id;
+	uint32_t _sector_size; /**< EPCS erase sector size, 0 for EPCQ */
+	unsigned char _silicon_id;
 };
 
 #endif  // SRC_EPCQ_HPP_
@@ -9,13 +9,7 @@
 #include <string.h>
 #include <strings.h>
 
-#include <algorithm>
-#include <fstream>
-#include <iostream>
-#include <iterator>
-#include <sstream>
-#include <utility>
-#include <vector>
+#include <string>
 
 #include "display.hpp"
 #include "feaparser.hpp"
@@ -73,32 +67,6 @@ FeaParser::FeaParser(const string &filename, bool verbose):
 		_featuresRow[i] = 0;
 }
 
-/* fill a vector with consecutive lines, beginning with 0 or 1, until EOF
- * \brief read a line with '\r''\n' or '\n' termination
- * check if last char is '\r'
- * \return a vector of lines without [\r]\n
- */
-vector<string> FeaParser::readFeaFile()
-{
-	vector<string> lines;
-
-	while (true) {
-		string buffer;
-		std::getline(_ss, buffer, '\n');
-		if (buffer.empty())
-			break;
-
-		/* if '\r' is present -> drop */
-		if (buffer.back() == '\r')
-			buffer.pop_back();
-
-		if (buffer.front() == '0' || buffer.front() == '1')
-			lines.push_back(buffer);
-	}
-
-	return lines;
-}
-
 void FeaParser::displayHeader()
 {
 	if (_has_feabits) {
@@ -226,39 +194,68 @@ void FeaParser::displayHeader()
 }
 
 /* Features Row & Feabits - this data is in a separate .fea file (MachXO3D)
- * DATA:
- * 1: xxxx\n : feature Row (96 bits)
- * 2: yyyy*\n : feabits (32 bits)
+ * DATA: first two lines beginning with 0 or 1 (others are ignored)
+ * 1: xxxx\n : feature Row (96 bits, MSB first)
+ * 2: yyyy*\n : feabits (32 bits, MSB first)
+ * bits are directly packed, from file content, into _featuresRow
+ * (_featuresRow[2] is the MSB word) and _feabits
  */
-void FeaParser::parseFeatureRowAndFeabits(const vector<string> &content)
+int FeaParser::parse()
 {
-	printf("Parsing Feature Row & FEAbits...\n");
+	const char *ptr = _raw_data.data();
+	const char *end = ptr + _raw_data.size();
+	int nb_lines = 0;
 
-	string featuresRow = content[0];
-	//printf("Features: [%s]\n", featuresRow.c_str());
-	for (size_t i = 0; i < featuresRow.size(); i++)
-		_featuresRow[3 - (i/32) - 1] |= ((featuresRow[i] - '0') << (32 - (i%32) - 1));
+	printf("Parsing Feature Row & FEAbits...\n");
 
-	string feabits = content[1];
-	//printf("Feabits: [%s]\n", feabits.c_str());
+	for (int i = 0; i < 3; i++)
+		_featuresRow[i] = 0;
 	_feabits = 0;
-	for (size_t i = 0; i < feabits.size(); i++) {
-		_feabits |= ((feabits[i] - '0') << (feabits.size() - i - 1));
-	}
-}
 
-int FeaParser::parse()
-{
-	std::vector<string>lines;
+	while (ptr < end && nb_lines < 2) {
+		const char *eol = static_cast<const char *>(
+			memchr(ptr, '\n', end - ptr));
+		if (!eol)
+			eol = end;
 
-	_ss.str(_raw_data);
+		if (*ptr == '0' || *ptr == '1') {
+			const char *c = ptr;
+			int nb_bits = 0;
+			if (nb_lines == 0) {
+				for (; c < eol && (*c == '0' || *c == '1'); c++, nb_bits++) {
+					if (nb_bits == 96)
+						break;
+					if (*c == '1')
+						_featuresRow[2 - (nb_bits / 32)] |=
+							1U << (31 - (nb_bits % 32));
+				}
+			} else {
+				for (; c < eol && (*c == '0' || *c == '1'); c++, nb_bits++) {
+					if (nb_bits == 32)
+						break;
+					_feabits = (_feabits << 1) | (*c - '0');
+				}
+			}
+			/* only '*', '\r' or blank may follow bits */
+			for (; c < eol; c++) {
+				if (*c != '*' && *c != '\r' && *c != ' ' && *c != '\t') {
+					printError("Error: " + std::string((nb_lines == 0) ?
+						"feature row" : "feabits") + " line too long or "
+						"with invalid char");
+					return EXIT_FAILURE;
+				}
+			}
+			nb_lines++;
+		}
+		ptr = eol + 1;
+	}
 
-	lines = readFeaFile();
-	/* empty or end of file */
-	if (lines.size() > 0) {
-		parseFeatureRowAndFeabits(lines);
-		_has_feabits = true;
+	if (nb_lines != 2) {
+		printError("Error: feature row and feabits not found");
+		return EXIT_FAILURE;
 	}
 
+	_has_feabits = true;
+
 	return EXIT_SUCCESS;
 }
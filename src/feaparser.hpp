@@ -7,11 +7,7 @@
 
 #include <stdint.h>
 
-#include <iostream>
-#include <fstream>
-#include <sstream>
 #include <string>
-#include <vector>
 
 #include "configBitstreamParser.hpp"
 
@@ -25,14 +21,9 @@ class FeaParser: public ConfigBitstreamParser {
 		uint32_t feabits() {return _feabits;}
 
 	private:
-		std::vector<std::string>readFeaFile();
-		void parseFeatureRowAndFeabits(const std::vector<std::string> &content);
-
 		uint32_t _featuresRow[3];
 		uint32_t _feabits;
 		bool _has_feabits;
-
-		std::istringstream _ss;
 };
 
 #endif  // FEAPARSER_HPP_
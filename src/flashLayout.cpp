@@ -0,0 +1,192 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "checksum.hpp"
+#include "display.hpp"
+#include "flashLayout.hpp"
+#include "progressBar.hpp"
+#include "rawParser.hpp"
+#include "spiFlash.hpp"
+
+FlashLayout::FlashLayout(const std::string &filename, int8_t verbose):
+	_verbose(verbose)
+{
+	std::ifstream fd(filename);
+	if (!fd.is_open())
+		throw std::runtime_error("Error: fail to open " + filename);
+
+	/* partitions files are relative to manifest */
+	std::string dir;
+	size_t pos = filename.find_last_of("/\\");
+	if (pos != std::string::npos)
+		dir = filename.substr(0, pos + 1);
+
+	std::string line;
+	int line_num = 0;
+	while (std::getline(fd, line)) {
+		line_num++;
+		std::istringstream iss(line);
+		std::string offset, length, file, sha;
+		if (!(iss >> offset) || offset[0] == '#')
+			continue;
+		if (!(iss >> length >> file))
+			throw std::runtime_error("Error: " + filename + ":" +
+					std::to_string(line_num) + ": offset length file expected");
+		iss >> sha;
+
+		partition_t part;
+		try {
+			part.offset = std::stoul(offset, nullptr, 0);
+			part.length = std::stoul(length, nullptr, 0);
+		} catch (std::exception &e) {
+			throw std::runtime_error("Error: " + filename + ":" +
+					std::to_string(line_num) + ": invalid offset or length");
+		}
+		/* erase is done by 4KB sectors at least, flash erase size
+		 * is checked again when the flash is known
+		 */
+		if ((part.offset & 0xfff) != 0 || (part.length & 0xfff) != 0)
+			throw std::runtime_error("Error: " + filename + ":" +
+					std::to_string(line_num) +
+					": offset and length must be 4KB aligned");
+		part.filename = (file[0] == '/') ? file : dir + file;
+		std::transform(sha.begin(), sha.end(), sha.begin(), ::tolower);
+
+		RawParser bit(part.filename, false);
+		bit.parse();
+		part.data.assign(reinterpret_cast<const char *>(bit.getData()),
+				bit.getLength() / 8);
+		if (part.length == 0)
+			part.length = (part.data.size() + 0xfff) & ~0xfff;
+		if (part.data.size() > part.length)
+			throw std::runtime_error("Error: " + part.filename +
+					" larger than partition");
+
+		part.sha256 = SHA256::hash(
+				reinterpret_cast<const uint8_t *>(part.data.c_str()),
+				part.data.size());
+		if (!sha.empty() && sha != part.sha256)
+			throw std::runtime_error("Error: " + part.filename +
+					" sha256 mismatch with manifest");
+
+		_partitions.push_back(std::move(part));
+	}
+
+	if (_partitions.empty())
+		throw std::runtime_error("Error: no partition in " + filename);
+
+	/* check overlaps */
+	std::sort(_partitions.begin(), _partitions.end(),
+			[](const partition_t &a, const partition_t &b) {
+				return a.offset < b.offset;});
+	for (size_t i = 1; i < _partitions.size(); i++) {
+		const partition_t &prev = _partitions[i - 1];
+		if (prev.offset + prev.length > _partitions[i].offset)
+			throw std::runtime_error("Error: partitions " + prev.filename +
+					" and " + _partitions[i].filename + " overlap");
+	}
+}
+
+bool FlashLayout::flash_hash(SPIFlash &flash, uint32_t offset, uint32_t len,
+		int rd_burst, std::string *sha256)
+{
+	if (rd_burst == 0 || rd_burst > 65536)
+		rd_burst = 65536;
+
+	SHA256 sha;
+	std::string buffer;
+	buffer.resize(rd_burst);
+
+	ProgressBar progress("Read flash ", len, 50, _verbose < 0);
+	progress.showRate(true);
+	for (uint32_t i = 0; i < len; i += rd_burst) {
+		uint32_t xfer = (i + rd_burst > len) ? len - i : rd_burst;
+		if (flash.read(offset + i, (uint8_t *)&buffer[0], xfer) != 0) {
+			progress.fail();
+			return false;
+		}
+		sha.update((const uint8_t *)buffer.c_str(), xfer);
+		progress.display(i);
+	}
+	progress.done();
+	*sha256 = sha.hexdigest();
+	return true;
+}
+
+bool FlashLayout::write(SPIFlash &flash, bool verify, bool repair,
+		int rd_burst)
+{
+	int nb_written = 0;
+	char mess[256];
+
+	/* a partition is erased by whole erase units: an unaligned
+	 * partition would wipe part of its neighbours
+	 */
+	const uint32_t gran = flash.erase_granularity();
+	bool aligned = true;
+	for (auto &part : _partitions) {
+		if ((part.offset % gran) == 0 && (part.length % gran) == 0)
+			continue;
+		snprintf(mess, sizeof(mess),
+				"partition 0x%08x (%s): offset and length must be "
+				"multiple of flash erase size (0x%x)",
+				part.offset, part.filename.c_str(), gran);
+		printError(mess);
+		aligned = false;
+	}
+	if (!aligned)
+		return false;
+
+	for (auto &part : _partitions) {
+		uint32_t len = part.data.size();
+		snprintf(mess, sizeof(mess), "partition 0x%08x (%s):",
+				part.offset, part.filename.c_str());
+		printInfo(mess);
+
+		/* flash content hash: only data len is relevant */
+		std::string flash_sha;
+		if (!flash_hash(flash, part.offset, len, rd_burst, &flash_sha))
+			return false;
+		if (_verbose > 0) {
+			printInfo("\texpected: " + part.sha256);
+			printInfo("\tflash   : " + flash_sha);
+		}
+		if (flash_sha == part.sha256) {
+			printSuccess("\tup to date: skip");
+			continue;
+		}
+
+		uint8_t *data = (uint8_t *)&part.data[0];
+		if (flash.erase_and_prog(part.offset, data, len) != 0)
+			return false;
+		nb_written++;
+
+		if (verify) {
+			std::vector<flash_area_t> bad_areas;
+			if (!flash.verify(part.offset, data, len, rd_burst, &bad_areas)) {
+				if (!repair || bad_areas.empty())
+					return false;
+				printWarn("Rewrite mismatched sectors");
+				if (!flash.repair(part.offset, data, len, bad_areas, rd_burst))
+					return false;
+			}
+		}
+	}
+
+	snprintf(mess, sizeof(mess), "%d/%zu partition(s) written",
+			nb_written, _partitions.size());
+	printSuccess(mess);
+
+	return true;
+}
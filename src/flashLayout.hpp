@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#ifndef SRC_FLASHLAYOUT_HPP_
+#define SRC_FLASHLAYOUT_HPP_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "spiFlash.hpp"
+
+/*!
+ * \file flashLayout.hpp
+ * \class FlashLayout
+ * \brief SPI flash image described as a list of partitions. Manifest
+ *        is a text file with one partition by line:
+ *        offset length file [sha256]
+ *        - offset and length may be decimal or hexadecimal (0x prefix)
+ *        - offset and length must be multiple of the flash erase
+ *          size (4KB or 64KB)
+ *        - length is partition size: 0 means file size rounded up
+ *          to 4KB
+ *        - file is relative to manifest directory
+ *        - sha256 is the expected file content hash (optional)
+ *        empty lines and lines starting with '#' are ignored
+ */
+class FlashLayout {
+ public:
+	typedef struct {
+		uint32_t offset;      /**< partition start address */
+		uint32_t length;      /**< partition size (in Byte) */
+		std::string filename;
+		std::string sha256;   /**< file content hash */
+		std::string data;     /**< file content */
+	} partition_t;
+
+	/*!
+	 * \brief read manifest and all partitions files
+	 * \param[in] filename: manifest file
+	 * \param[in] verbose: verbose level
+	 */
+	FlashLayout(const std::string &filename, int8_t verbose);
+
+	/*!
+	 * \brief compute each partition hash from flash content
+	 *        and write only partitions with a different content
+	 *        partitions must be aligned on flash erase size
+	 * \param[in] flash: SPI flash access
+	 * \param[in] verify: verify written partitions
+	 * \param[in] repair: rewrite sectors with a verify mismatch
+	 * \param[in] rd_burst: size of packet to read
+	 * \return false if read, write or verify fails
+	 */
+	bool write(SPIFlash &flash, bool verify, bool repair = false,
+		int rd_burst = 0);
+
+	/*!
+	 * \brief return partitions list
+	 */
+	const std::vector<partition_t> &partitions() const {return _partitions;}
+
+ private:
+	/*!
+	 * \brief read len Bytes starting at offset and compute sha256
+	 * \param[out] sha256: flash content hash
+	 * \return false if read fails
+	 */
+	bool flash_hash(SPIFlash &flash, uint32_t offset, uint32_t len,
+			int rd_burst, std::string *sha256);
+
+	std::vector<partition_t> _partitions;
+	int8_t _verbose;
+};
+
+#endif  // SRC_FLASHLAYOUT_HPP_
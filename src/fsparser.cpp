@@ -3,11 +3,13 @@
  * Copyright (C) 2019 Gwenhael Goavec-Merou <gwenhael.goavec-merou@trabucayre.com>
  */
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <vector>
 #include <cstdio>
 
+#include "checksum.hpp"
 #include "fsparser.hpp"
 #include "display.hpp"
 
@@ -33,7 +35,7 @@ uint64_t FsParser::bitToVal(const char *bits, int len)
 	return val;
 }
 
-int FsParser::parseHeader()
+int FsParser::parseHeader(bool header_only)
 {
 	int ret = 0;
 	string buffer;
@@ -41,6 +43,7 @@ int FsParser::parseHeader()
 	bool in_header = true;
 
 	istringstream lineStream(_raw_data);
+	_lstRawData.clear();
 
 	while (std::getline(lineStream, buffer, '\n')) {
 		ret += buffer.size() + 1;
@@ -111,6 +114,8 @@ int FsParser::parseHeader()
 				_hdr["CRCCheck"] = (crc) ? "ON" : "OFF";
 				_hdr["ConfDataLength"] = to_string(0xffff & val);
 				_end_header = line_index;
+				if (header_only)
+					return ret;
 				break;
 		}
 
@@ -120,6 +125,13 @@ int FsParser::parseHeader()
 	return ret;
 }
 
+bool FsParser::readHeader()
+{
+	parseHeader(true);
+	_lstRawData.clear();
+	return _idcode != 0;
+}
+
 int FsParser::parse()
 {
 	string tmp;
@@ -234,10 +246,21 @@ int FsParser::parse()
 		tmp += l.substr(padding, l.size() - padding);
 	}
 
-	/* checksum */
-	_checksum = 0;
-	for (uint32_t pos = 0; pos < tmp.size(); pos+=16)
-		_checksum += (uint16_t)bitToVal(&tmp[pos], 16);
+	/* checksum: 16 bits sum of configuration data big endian words */
+	Sum16 data_sum(true);
+	uint8_t data_bytes[256];
+	size_t nb_bytes = 0;
+	for (size_t pos = 0; pos < tmp.size(); pos += 8) {
+		/* last Byte may be incomplete: missing bits are 0 */
+		size_t nb = std::min<size_t>(8, tmp.size() - pos);
+		data_bytes[nb_bytes++] = bitToVal(&tmp[pos], nb) << (8 - nb);
+		if (nb_bytes == sizeof(data_bytes)) {
+			data_sum.update(data_bytes, nb_bytes);
+			nb_bytes = 0;
+		}
+	}
+	data_sum.update(data_bytes, nb_bytes);
+	_checksum = data_sum.value();
 
 	if (_verbose)
 		printf("checksum 0x%04x\n", _checksum);
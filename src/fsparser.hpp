@@ -18,11 +18,21 @@ class FsParser: public ConfigBitstreamParser {
 		FsParser(const std::string &filename, bool reverseByte, bool verbose);
 		~FsParser();
 		int parse() override;
+		/**
+		 * \brief header lines only (idcode, options, data length)
+		 * \return false if idcode is not found
+		 */
+		bool readHeader() override;
 
 		uint16_t checksum() {return _checksum;}
 
 	private:
-		int parseHeader();
+		/**
+		 * \brief decode header and store lines
+		 * \param[in] header_only: stop after last header line
+		 * \return number of Bytes read
+		 */
+		int parseHeader(bool header_only = false);
 		/**
 		 * \brief convert an binary string representation to the corresponding
 		 * value
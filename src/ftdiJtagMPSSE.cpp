@@ -13,6 +13,7 @@
 #include <stdexcept>
 #include <string>
 
+#include "bufferPool.hpp"
 #include "display.hpp"
 #include "ftdiJtagMPSSE.hpp"
 #include "ftdipp_mpsse.hpp"
@@ -34,6 +35,7 @@ FtdiJtagMPSSE::FtdiJtagMPSSE(const cable_t &cable,
 			const string &dev, const string &serial, uint32_t clkHZ,
 			bool invert_read_edge, int8_t verbose):
 			FTDIpp_MPSSE(cable, dev, serial, clkHZ, verbose), _ch552WA(false),
+			_defer_write(false),
 			_write_mode(MPSSE_WRITE_NEG),  // always write on neg edge
 			_read_mode(0),
 			_invert_read_edge(invert_read_edge), // false: pos, true: neg
@@ -140,8 +142,8 @@ int FtdiJtagMPSSE::writeTMS(uint8_t *tms, uint32_t len, bool flush_buffer)
 				printf("writeTMS: error\n");
 
 			if (_ch552WA) {
-				uint8_t c[len/8+1];
-				int ret = ftdi_read_data(_ftdi, c, len/8+1);
+				BufferPool::Buffer c(len/8+1);
+				int ret = ftdi_read_data(_ftdi, c.data(), len/8+1);
 				if (ret != 0) {
 					printf("ret : %d\n", ret);
 				}
@@ -152,10 +154,14 @@ int FtdiJtagMPSSE::writeTMS(uint8_t *tms, uint32_t len, bool flush_buffer)
 	if (flush_buffer)
 		mpsse_write();
 	if (_ch552WA) {
-		uint8_t c[len/8+1];
-		ftdi_read_data(_ftdi, c, len/8+1);
+		BufferPool::Buffer c(len/8+1);
+		ftdi_read_data(_ftdi, c.data(), len/8+1);
 	}
 
+	/* TMS/TDI lines keep last level: used by writeTMSTDI */
+	_curr_tms = (tms[(len - 1) >> 3] >> ((len - 1) & 0x07)) & 0x01;
+	_curr_tdi = 1;
+
 	return len;
 }
 
@@ -195,7 +201,7 @@ int FtdiJtagMPSSE::toggleClk(uint8_t tms, uint8_t tdi, uint32_t clk_len)
 		ret = clk_len;
 	} else {
 		int byteLen = (len+7)/8;
-		uint8_t buf_tms[byteLen];
+		BufferPool::Buffer buf_tms(byteLen);
 		memset(buf_tms, (tms) ? 0xff : 0x00, byteLen);
 		ret = writeTMS(buf_tms, len, false);
 	}
@@ -208,6 +214,16 @@ int FtdiJtagMPSSE::flush()
 	return mpsse_write();
 }
 
+void FtdiJtagMPSSE::hold_writes(bool hold)
+{
+	/* tangNano requires a read after each write */
+	if (_ch552WA)
+		return;
+	_defer_write = hold;
+	if (!hold)
+		mpsse_write();
+}
+
 int FtdiJtagMPSSE::writeTDI(uint8_t *tdi, uint8_t *tdo, uint32_t len, bool last)
 {
 	/* 3 possible case :
@@ -221,7 +237,7 @@ int FtdiJtagMPSSE::writeTDI(uint8_t *tdi, uint8_t *tdo, uint32_t len, bool last)
 	int nb_byte = real_len >> 3;    // number of byte to send
 	int nb_bit = (real_len & 0x07); // residual bits
 	int xfer = tx_buff_size - 3;
-	unsigned char c[xfer];
+	BufferPool::Buffer c(xfer);
 	unsigned char *rx_ptr = (unsigned char *)tdo;
 	unsigned char *tx_ptr = (unsigned char *)tdi;
 	unsigned char tx_buf[3] = {(unsigned char)(MPSSE_LSB |
@@ -263,8 +279,8 @@ int FtdiJtagMPSSE::writeTDI(uint8_t *tdi, uint8_t *tdo, uint32_t len, bool last)
 			rx_ptr += xfer_len;
 		} else if (_ch552WA) {
 			mpsse_write();
-			ftdi_read_data(_ftdi, c, xfer_len);
-		} else if (!last) {
+			ftdi_read_data(_ftdi, c.data(), xfer_len);
+		} else if (!last && !_defer_write) {
 			mpsse_write();
 		}
 		nb_byte -= xfer_len;
@@ -299,9 +315,9 @@ int FtdiJtagMPSSE::writeTDI(uint8_t *tdi, uint8_t *tdo, uint32_t len, bool last)
 				*rx_ptr >>= (8 - nb_bit);
 			} else {
 				mpsse_write();
-				ftdi_read_data(_ftdi, c, nb_bit);
+				ftdi_read_data(_ftdi, c.data(), nb_bit);
 			}
-		} else if (!last) {
+		} else if (!last && !_defer_write) {
 			mpsse_write();
 		}
 	}
@@ -325,6 +341,8 @@ int FtdiJtagMPSSE::writeTDI(uint8_t *tdi, uint8_t *tdo, uint32_t len, bool last)
 		tx_buf[2] = ((last_bit) ? 0x81 : 0x01);  // we know in TMS tdi is bit 7
 							// and to move to EXIT_XR TMS = 1
 		mpsse_store(tx_buf, 3);
+		_curr_tms = 1;
+		_curr_tdi = (last_bit) ? 1 : 0;
 		if (tdo) {
 			unsigned char c[2];
 			int index = 0;
@@ -337,8 +355,8 @@ int FtdiJtagMPSSE::writeTDI(uint8_t *tdi, uint8_t *tdo, uint32_t len, bool last)
 			*rx_ptr |= (((c[index]) & 0x80) >> (7 - nb_bit));
 		} else if (_ch552WA) {
 			mpsse_write();
-			ftdi_read_data(_ftdi, c, 1);
-		} else {
+			ftdi_read_data(_ftdi, c.data(), 1);
+		} else if (!_defer_write) {
 			mpsse_write();
 		}
 	}
@@ -346,6 +364,23 @@ int FtdiJtagMPSSE::writeTDI(uint8_t *tdi, uint8_t *tdo, uint32_t len, bool last)
 	return 0;
 }
 
+int FtdiJtagMPSSE::writeTDIv(const jtag_seg_t *segs, uint32_t nb_segs,
+		bool end)
+{
+	/* tangNano requires a read after each write */
+	if (_ch552WA)
+		return JtagInterface::writeTDIv(segs, nb_segs, end);
+
+	/* writes held by caller: nothing to send now */
+	bool held = _defer_write;
+	_defer_write = true;
+	int ret = JtagInterface::writeTDIv(segs, nb_segs, end);
+	_defer_write = held;
+	if (!held && mpsse_write() < 0)
+		return -1;
+	return ret;
+}
+
 int32_t FtdiJtagMPSSE::update_tms_buff(uint8_t *buffer, uint8_t bit,
 		uint32_t offset, uint8_t tdi, uint8_t *tdo, bool end)
 {
@@ -415,9 +450,9 @@ bool FtdiJtagMPSSE::writeTMSTDI(const uint8_t *tms, const uint8_t *tdi,
 	int32_t ret;
 	uint32_t max_len = 1024;
 	uint8_t mode = 0;         // current state: 0 none, 1 TDI, 2 TMS
-	uint8_t tdi_buf[max_len]; // buffer to store TDI sequence
+	BufferPool::Buffer tdi_buf(max_len); // buffer to store TDI sequence
 	uint8_t tms_tmp = 0;      // buffer to store TMS sequence (limited to 6bits per cmd)
-	uint8_t tdo_tmp[max_len]; // local TDO sequence
+	BufferPool::Buffer tdo_tmp(max_len); // local TDO sequence
 	uint32_t buff_len = 0;    // current bits stored
 	memset(tdi_buf, 0, max_len);
 	memset(tdo_tmp, 0, max_len);
@@ -38,6 +38,11 @@ class FtdiJtagMPSSE : public JtagInterface, public FTDIpp_MPSSE {
 	int toggleClk(uint8_t tms, uint8_t tdi, uint32_t clk_len) override;
 	/* TDI */
 	int writeTDI(uint8_t *tx, uint8_t *rx, uint32_t len, bool end) override;
+	/*!
+	 * \brief segments are stored back to back in MPSSE buffer:
+	 *        USB transfer only at the end (or when a read is required)
+	 */
+	int writeTDIv(const jtag_seg_t *segs, uint32_t nb_segs, bool end) override;
 
 	/*!
 	 * \brief send TMD and TDI and receive tdo bits;
@@ -58,6 +63,7 @@ class FtdiJtagMPSSE : public JtagInterface, public FTDIpp_MPSSE {
 	bool isFull() override { return false;}
 
 	int flush() override;
+	void hold_writes(bool hold) override;
 
  private:
 	void init_internal(const mpsse_bit_config &cable);
@@ -81,6 +87,8 @@ class FtdiJtagMPSSE : public JtagInterface, public FTDIpp_MPSSE {
 	 */
 	void config_edge();
 	bool _ch552WA; /* avoid errors with SiPeed tangNano */
+	bool _defer_write; /**< writeTDI doesn't flush (segments in progress
+	                      or writes held) */
 	uint8_t _write_mode; /**< write edge configuration */
 	uint8_t _read_mode; /**< read edge configuration */
 	bool _invert_read_edge; /**< read edge selection (false: pos, true: neg) */
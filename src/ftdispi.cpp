@@ -9,6 +9,7 @@
 #include <unistd.h>
 #include <string.h>
 #include "board.hpp"
+#include "bufferPool.hpp"
 #include "ftdipp_mpsse.hpp"
 #include "ftdispi.hpp"
 
@@ -167,7 +168,7 @@ int FtdiSpi::ft2232_spi_wr_and_rd(//struct ftdi_spi *spi,
 			    const uint8_t * writearr, uint8_t * readarr)
 {
 	uint32_t max_xfer = (readarr) ? _buffer_size : 4096;
-	uint8_t buf[max_xfer];
+	BufferPool::Buffer buf(max_xfer);
 	int i = 0;
 	int ret = 0;
 
@@ -232,8 +233,8 @@ int FtdiSpi::ft2232_spi_wr_and_rd(//struct ftdi_spi *spi,
 int FtdiSpi::spi_put(uint8_t cmd, uint8_t *tx, uint8_t *rx, uint32_t len)
 {
 	uint32_t xfer_len = len + 1;
-	uint8_t jtx[xfer_len];
-	uint8_t jrx[xfer_len];
+	BufferPool::Buffer jtx(xfer_len);
+	BufferPool::Buffer jrx(xfer_len);
 
 	jtx[0] = cmd;
 	if (tx != NULL)
@@ -243,7 +244,7 @@ int FtdiSpi::spi_put(uint8_t cmd, uint8_t *tx, uint8_t *rx, uint32_t len)
 	 * in the same time store each byte
 	 * to next
 	 */
-	ft2232_spi_wr_and_rd(xfer_len, jtx, (rx != NULL)?jrx:NULL);
+	ft2232_spi_wr_and_rd(xfer_len, jtx, (rx != NULL)? jrx.data() : NULL);
 
 	if (rx != NULL)
 		memcpy(rx, jrx+1, len);
@@ -12,7 +12,10 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
+#include "bufferPool.hpp"
 #include "jtag.hpp"
 #include "gowin.hpp"
 #include "progressBar.hpp"
@@ -60,6 +63,10 @@ using namespace std;
 #define EFLASH_ERASE		0x75
 #define SWITCH_TO_MCU_JTAG		0x7a
 
+/* embedded flash */
+#define XPAGE_SIZE			256		/* Bytes by X-page (64 x 32bits Y-pages) */
+#define MCU_FW_XPAGE		0x380	/* first X-page of GW1NSR MCU firmware */
+
 /* BSCAN spi (external flash) (see below for details) */
 /* most common pins def */
 #define BSCAN_SPI_SCK           (1 << 1)
@@ -111,6 +118,25 @@ Gowin::Gowin(Jtag *jtag, const string filename, const string &file_type, std::st
 			}
 		}
 
+		/* for fs file check match with targeted device before
+		 * decoding configuration data
+		 */
+		if (_file_extension == "fs") {
+			if (!_fs->readHeader()) {
+				delete _fs;
+				throw std::runtime_error("can't read fs file header");
+			}
+			string idcode_str = _fs->getHeaderVal("idcode");
+			uint32_t fs_idcode = std::stoul(idcode_str.c_str(), NULL, 16);
+			if ((fs_idcode & 0x0fffffff) != idcode) {
+				char mess[256];
+				sprintf(mess, "mismatch between target's idcode and bitstream idcode\n"
+					"\tbitstream has 0x%08X hardware requires 0x%08x", fs_idcode, idcode);
+				delete _fs;
+				throw std::runtime_error(mess);
+			}
+		}
+
 		printInfo("Parse file ", false);
 		if (_fs->parse() == EXIT_FAILURE) {
 			printError("FAIL");
@@ -122,18 +148,6 @@ Gowin::Gowin(Jtag *jtag, const string filename, const string &file_type, std::st
 
 		if (_verbose)
 			_fs->displayHeader();
-
-		/* for fs file check match with targeted device */
-		if (_file_extension == "fs") {
-			string idcode_str = _fs->getHeaderVal("idcode");
-			uint32_t fs_idcode = std::stoul(idcode_str.c_str(), NULL, 16);
-			if ((fs_idcode & 0x0fffffff) != idcode) {
-				char mess[256];
-				sprintf(mess, "mismatch between target's idcode and bitstream idcode\n"
-					"\tbitstream has 0x%08X hardware requires 0x%08x", fs_idcode, idcode);
-				throw std::runtime_error(mess);
-			}
-		}
 	}
 	_jtag->setClkFreq(2500000);
 
@@ -192,45 +206,36 @@ void Gowin::reset()
 	wr_rd(NOOP, NULL, 0, NULL, 0);
 }
 
-void Gowin::programFlash()
+bool Gowin::programFlash()
 {
-	uint8_t *data = _fs->getData();
-	int length = _fs->getLength();
-	
-	uint8_t *mcu_data = nullptr;
-	int mcu_length = 0;
-	
-	if (_mcufw) {
-		mcu_data = _mcufw->getData();
-		mcu_length = _mcufw->getLength();
-	}
+	/* bitstream and MCU firmware: final layout computed before erase */
+	vector<uint8_t> img;
+	vector<uint32_t> xpages;
+	if (!planFlash(img, xpages))
+		return false;
 
 	/* erase SRAM */
 	if (!EnableCfg())
-		return;
+		return false;
 	eraseSRAM();
 	wr_rd(XFER_DONE, NULL, 0, NULL, 0);
 	wr_rd(NOOP, NULL, 0, NULL, 0);
 	if (!DisableCfg())
-		return;
+		return false;
 
 	if (!EnableCfg())
-		return;
+		return false;
 	if (!eraseFLASH())
-		return;
+		return false;
 	if (!DisableCfg())
-		return;
+		return false;
 	/* test status a faire */
-	if (!flashFLASH(0, data, length))
-		return;
-	if (mcu_data) {
-		if (!flashFLASH(0x380, mcu_data, mcu_length))
-			return;
-	}
+	if (!flashFLASH(img, xpages))
+		return false;
 	if (_verify)
 		printWarn("writing verification not supported");
 	if (!DisableCfg())
-		return;
+		return false;
 	wr_rd(RELOAD, NULL, 0, NULL, 0);
 	wr_rd(NOOP, NULL, 0, NULL, 0);
 
@@ -238,26 +243,27 @@ void Gowin::programFlash()
 	usleep(2*150*1000);
 
 	/* check if file checksum == checksum in FPGA */
-	checkCRC();
+	bool ret = checkCRC();
 
 	if (_verbose)
 		displayReadReg(readStatusReg());
+	return ret;
 }
 
-void Gowin::program(unsigned int offset, bool unprotect_flash)
+bool Gowin::program(unsigned int offset, bool unprotect_flash)
 {
 	uint8_t *data;
 	int length;
 
 	if (_mode == NONE_MODE || !_fs)
-		return;
+		return true;
 
 	data = _fs->getData();
 	length = _fs->getLength();
 
 	if (_mode == FLASH_MODE) {
 		if (!_external_flash) { /* write into internal flash */
-			programFlash();
+			return programFlash();
 		} else { /* write bitstream into external flash */
 			_jtag->setClkFreq(10000000);
 
@@ -293,7 +299,7 @@ void Gowin::program(unsigned int offset, bool unprotect_flash)
 			reset();
 		}
 
-		return;
+		return true;
 	}
 
 	if (_verbose) {
@@ -304,29 +310,30 @@ void Gowin::program(unsigned int offset, bool unprotect_flash)
 
 	/* erase SRAM */
 	if (!EnableCfg())
-		return;
+		return false;
 	eraseSRAM();
 	if (!DisableCfg())
-		return;
+		return false;
 
 	/* load bitstream in SRAM */
 	if (!EnableCfg())
-		return;
+		return false;
 	if (!flashSRAM(data, length))
-		return;
+		return false;
 	if (!DisableCfg())
-		return;
+		return false;
 
 	/* ocheck if file checksum == checksum in FPGA */
-	checkCRC();
+	bool ret = checkCRC();
 	if (_verbose)
 		displayReadReg(readStatusReg());
+	return ret;
 }
 
-void Gowin::checkCRC()
+bool Gowin::checkCRC()
 {
 	if (skip_checksum)
-		return;
+		return true;
 
 	bool is_match = true;
 	char mess[256];
@@ -366,6 +373,7 @@ void Gowin::checkCRC()
 		printError("CRC check : FAIL");
 		printError(mess);
 	}
+	return is_match;
 }
 
 bool Gowin::EnableCfg()
@@ -416,7 +424,8 @@ bool Gowin::wr_rd(uint8_t cmd,
 	if (tx_len > rx_len)
 		xfer_len = tx_len;
 
-	uint8_t xfer_tx[xfer_len], xfer_rx[xfer_len];
+	BufferPool::Buffer xfer_tx(xfer_len);
+	BufferPool::Buffer xfer_rx(xfer_len);
 	memset(xfer_tx, 0, xfer_len);
 	int i;
 	if (tx != NULL) {
@@ -427,7 +436,7 @@ bool Gowin::wr_rd(uint8_t cmd,
 	_jtag->shiftIR(&cmd, NULL, 8);
 	_jtag->toggleClk(6);
 	if (rx || tx) {
-		_jtag->shiftDR(xfer_tx, (rx) ? xfer_rx : NULL, 8 * xfer_len);
+		_jtag->shiftDR(xfer_tx, (rx) ? xfer_rx.data() : NULL, 8 * xfer_len);
 		_jtag->toggleClk(6);
 		_jtag->flush();
 	}
@@ -498,70 +507,84 @@ bool Gowin::pollFlag(uint32_t mask, uint32_t value)
 	return true;
 }
 
+bool Gowin::planFlash(vector<uint8_t> &img, vector<uint32_t> &xpages)
+{
+	/* bitstream: bootcode at X=0, Y=0 (4Bytes), 5 x 32 dummy bits then
+	 * full bitstream. Words are sent MSB first
+	 */
+	const uint8_t bootcode[6 * 4] = {
+		0x47, 0x57, 0x31, 0x4E,
+		0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff};
+	uint32_t fs_len = _fs->getLength() / 8;
+	uint32_t fs_xpages = (sizeof(bootcode) + fs_len + XPAGE_SIZE - 1) /
+		XPAGE_SIZE;
+	uint32_t mcu_len = (_mcufw) ? _mcufw->getLength() / 8 : 0;
+	uint32_t mcu_xpages = (mcu_len + XPAGE_SIZE - 1) / XPAGE_SIZE;
+
+	if (_mcufw && fs_xpages > MCU_FW_XPAGE) {
+		printError("bitstream overlaps MCU firmware area");
+		return false;
+	}
+
+	/* padding: erased value */
+	img.assign((fs_xpages + mcu_xpages) * XPAGE_SIZE, 0xff);
+	xpages.resize(fs_xpages + mcu_xpages);
+
+	memcpy(img.data(), bootcode, sizeof(bootcode));
+	memcpy(img.data() + sizeof(bootcode), _fs->getData(), fs_len);
+	for (uint32_t i = 0; i < fs_xpages * XPAGE_SIZE; i += 4) {
+		std::swap(img[i], img[i + 3]);
+		std::swap(img[i + 1], img[i + 2]);
+	}
+	for (uint32_t i = 0; i < fs_xpages; i++)
+		xpages[i] = i;
+
+	/* MCU firmware: words are sent as is */
+	if (_mcufw) {
+		memcpy(img.data() + fs_xpages * XPAGE_SIZE, _mcufw->getData(),
+			mcu_len);
+		for (uint32_t i = 0; i < mcu_xpages; i++)
+			xpages[fs_xpages + i] = MCU_FW_XPAGE + i;
+	}
+
+	if (_verbose) {
+		printInfo("Flash plan: bitstream " + std::to_string(fs_xpages) +
+			" X-pages");
+		if (_mcufw)
+			printInfo("            MCU firmware " +
+				std::to_string(mcu_xpages) + " X-pages at " +
+				std::to_string(MCU_FW_XPAGE));
+	}
+
+	return true;
+}
+
 /* TN653 p. 17-21 */
-bool Gowin::flashFLASH(uint32_t page, uint8_t *data, int length)
+bool Gowin::flashFLASH(const vector<uint8_t> &img,
+		const vector<uint32_t> &xpages)
 {
-	uint8_t tx[4] = {0x4E, 0x31, 0x57, 0x47};
 	uint8_t tmp[4];
 	uint32_t addr;
-	int nb_iter;
-	int byte_length = length / 8;
-	int buffer_length;
-	uint8_t *buffer;
-	int nb_xpage;
-	uint8_t tt[39];
-	memset(tt, 0, 39);
 
 	_jtag->go_test_logic_reset();
 
-	if (page == 0) {
-		/* we have to send
-		 * bootcode a X=0, Y=0 (4Bytes)
-		 * 5 x 32 dummy bits
-		 * full bitstream
-		 */
-		buffer_length = byte_length+(6*4);
-		unsigned char bufvalues[]={
-										0x47, 0x57, 0x31, 0x4E,
-										0xff, 0xff , 0xff, 0xff,
-										0xff, 0xff , 0xff, 0xff,
-										0xff, 0xff , 0xff, 0xff,
-										0xff, 0xff , 0xff, 0xff,
-										0xff, 0xff , 0xff, 0xff};
-		nb_xpage = buffer_length/256;
-		if (nb_xpage * 256 != buffer_length) {
-			nb_xpage++;
-			buffer_length = nb_xpage * 256;
-		}
-
-		buffer = new uint8_t[buffer_length];
-		/* fill theorical size with 0xff */
-		memset(buffer, 0xff, buffer_length);
-		/* fill first page with code */
-		memcpy(buffer, bufvalues, 6*4);
-		/* bitstream just after opcode */
-		memcpy(buffer+6*4, data, byte_length);
-	} else {
-		buffer_length = byte_length;
-		nb_xpage = buffer_length/256;
-		if (nb_xpage * 256 != buffer_length) {
-			nb_xpage++;
-			buffer_length = nb_xpage * 256;
-		}
-		buffer = new uint8_t[buffer_length];
-		memset(buffer, 0xff, buffer_length);
-		memcpy(buffer, data, byte_length);
-	}
-
+	/* no read during programming: everything is sent when the probe
+	 * buffer is full. Released on error too
+	 */
+	JtagHoldWrites hold(_jtag);
 
-	ProgressBar progress("write Flash", buffer_length, 50, _quiet);
+	ProgressBar progress("write Flash", img.size(), 50, _quiet);
 
-	for (int i=0, xpage = 0; xpage < nb_xpage; i += (nb_iter * 4), xpage++) {
+	for (size_t i = 0; i < xpages.size(); i++) {
 		wr_rd(CONFIG_ENABLE, NULL, 0, NULL, 0);
 		wr_rd(EF_PROGRAM, NULL, 0, NULL, 0);
-		if ((page + xpage) != 0)
+		if (xpages[i] != 0)
 			_jtag->toggleClk(312);
-		addr = (page + xpage) << 6;
+		addr = xpages[i] << 6;
 		tmp[3] = 0xff&(addr >> 24);
 		tmp[2] = 0xff&(addr >> 16);
 		tmp[1] = 0xff&(addr >> 8);
@@ -569,38 +592,22 @@ bool Gowin::flashFLASH(uint32_t page, uint8_t *data, int length)
 		_jtag->shiftDR(tmp, NULL, 32);
 		_jtag->toggleClk(312);
 
-		int xoffset = xpage * 256;  // each page containt 256Bytes
-		if (xoffset + 256 > buffer_length)
-			nb_iter = (buffer_length-xoffset) / 4;
-		else
-			nb_iter = 64;
-
-		for (int ypage = 0; ypage < nb_iter; ypage++) {
-			unsigned char *t = buffer+xoffset + 4*ypage;
-			for (int x=0; x < 4; x++) {
-				if (page == 0)
-					tx[3-x] = t[x];
-				else
-					tx[x] = t[x];
-			}
-			_jtag->shiftDR(tx, NULL, 32);
-
+		/* each X-page contains 64 Y-pages of 4 Bytes */
+		const uint8_t *t = &img[i * XPAGE_SIZE];
+		for (int ypage = 0; ypage < XPAGE_SIZE / 4; ypage++, t += 4) {
+			_jtag->shiftDR(const_cast<uint8_t *>(t), NULL, 32);
 			if (!is_gw1n1)
 				_jtag->toggleClk(40);
 		}
-		if (is_gw1n1) {
-			//usleep(10*2400*2);
-			uint8_t tt2[6008/8];
-			memset(tt2, 0, 6008/8);
+		if (is_gw1n1)
 			_jtag->toggleClk(6008);
-		}
-		progress.display(i);
+		progress.display(i * XPAGE_SIZE);
 	}
 	/* 2.2.6.6 */
 	_jtag->set_state(Jtag::RUN_TEST_IDLE);
+	hold.release();
 
 	progress.done();
-	delete[] buffer;
 	return true;
 }
 
@@ -726,13 +733,14 @@ bool Gowin::eraseSRAM()
 
 int Gowin::spi_put(uint8_t cmd, uint8_t *tx, uint8_t *rx, uint32_t len)
 {
-	uint8_t jrx[len+1], jtx[len+1];
+	BufferPool::Buffer jrx(len+1);
+	BufferPool::Buffer jtx(len+1);
 	jtx[0] = cmd;
 	if (tx)
 		memcpy(jtx+1, tx, len);
 	else
 		memset(jtx+1, 0, len);
-	int ret = spi_put(jtx, (rx)? jrx : NULL, len+1);
+	int ret = spi_put(jtx, (rx)? jrx.data() : NULL, len+1);
 	if (rx)
 		memcpy(rx, jrx+1, len);
 	return ret;
@@ -741,10 +749,11 @@ int Gowin::spi_put(uint8_t cmd, uint8_t *tx, uint8_t *rx, uint32_t len)
 int Gowin::spi_put(uint8_t *tx, uint8_t *rx, uint32_t len)
 {
 	if (is_gw2a) {
-		uint8_t jtx[len];
-		uint8_t jrx[len];
-		if (rx)
-			len++;
+		/* one more byte to read last rx bit */
+		uint32_t xfer_len = (rx) ? len + 1 : len;
+		BufferPool::Buffer jtx(xfer_len);
+		BufferPool::Buffer jrx(xfer_len);
+		memset(jtx, 0, xfer_len);
 		if (tx != NULL) {
 			for (uint32_t i = 0; i < len; i++)
 				jtx[i] = FsParser::reverseByte(tx[i]);
@@ -753,7 +762,7 @@ int Gowin::spi_put(uint8_t *tx, uint8_t *rx, uint32_t len)
 		if (!ret)
 			return -1;
 		_jtag->set_state(Jtag::EXIT2_DR);
-		ret = _jtag->shiftDR(jtx, (rx)? jrx:NULL, 8*len);
+		ret = _jtag->shiftDR(jtx, (rx)? jrx.data() : NULL, 8*xfer_len);
 		if (rx) {
 			for (uint32_t i=0; i < len; i++) {
 				rx[i] = FsParser::reverseByte(jrx[i]>>1) |
@@ -24,8 +24,8 @@ class Gowin: public Device, SPIInterface {
 		~Gowin();
 		int idCode() override;
 		void reset() override;
-		void program(unsigned int offset, bool unprotect_flash) override;
-		void programFlash();
+		bool program(unsigned int offset, bool unprotect_flash) override;
+		bool programFlash();
 		bool connectJtagToMCU() override;
 
 		/* spi interface */
@@ -51,15 +51,31 @@ class Gowin: public Device, SPIInterface {
 		bool eraseSRAM();
 		bool eraseFLASH();
 		bool flashSRAM(uint8_t *data, int length);
-		bool flashFLASH(uint32_t page, uint8_t *data, int length);
+		/*!
+		 * \brief embedded flash content: bitstream (with bootcode) from
+		 *        X-page 0 and, when given, MCU firmware at its fixed
+		 *        X-page. Each image is padded to a X-page boundary and
+		 *        words are stored in sending order
+		 * \param[out] img: X-pages content (256 Bytes each)
+		 * \param[out] xpages: flash X-page index for each img X-page
+		 * \return false when bitstream overlaps MCU firmware
+		 */
+		bool planFlash(std::vector<uint8_t> &img,
+				std::vector<uint32_t> &xpages);
+		/*!
+		 * \brief write all X-pages in one sequence (flash already erased)
+		 */
+		bool flashFLASH(const std::vector<uint8_t> &img,
+				const std::vector<uint32_t> &xpages);
 		void displayReadReg(uint32_t dev);
 		uint32_t readStatusReg();
 		uint32_t readUserCode();
 		/*!
 		 * \brief compare usercode register with fs checksum and/or
 		 *        .fs usercode field
+		 * \return false on mismatch
 		 */
-		void checkCRC();
+		bool checkCRC();
 		ConfigBitstreamParser *_fs;
 		bool is_gw1n1;
 		bool is_gw2a;
@@ -110,12 +110,12 @@ bool Ice40::program_cram(uint8_t *data, uint32_t length)
 	return true;
 }
 
-void Ice40::program(unsigned int offset, bool unprotect_flash)
+bool Ice40::program(unsigned int offset, bool unprotect_flash)
 {
 	uint32_t timeout = 1000;
 
 	if (_file_extension.empty())
-		return;
+		return true;
 
 	RawParser bit(_filename, false);
 
@@ -124,16 +124,14 @@ void Ice40::program(unsigned int offset, bool unprotect_flash)
 		printSuccess("DONE");
 	} else {
 		printError("FAIL");
-		return;
+		return false;
 	}
 
 	uint8_t *data = bit.getData();
 	int length = bit.getLength() / 8;
 
-	if (_mode == Device::MEM_MODE) {
-		program_cram(data, length);
-		return;
-	}
+	if (_mode == Device::MEM_MODE)
+		return program_cram(data, length);
 
 	_spi->gpio_clear(_rst_pin);
 
@@ -142,10 +140,10 @@ void Ice40::program(unsigned int offset, bool unprotect_flash)
 
 	printf("%02x\n", flash.read_status_reg());
 	flash.read_id();
-	flash.erase_and_prog(offset, data, length);
+	bool ret = flash.erase_and_prog(offset, data, length) == 0;
 
-	if (_verify)
-		flash.verify(offset, data, length);
+	if (ret && _verify)
+		ret = flash.verify(offset, data, length);
 
 	_spi->gpio_set(_rst_pin);
 	usleep(12000);
@@ -155,10 +153,12 @@ void Ice40::program(unsigned int offset, bool unprotect_flash)
 		timeout--;
 		usleep(12000);
 	} while (((_spi->gpio_get(true) & _done_pin) == 0) && timeout > 0);
-	if (timeout == 0)
+	if (timeout == 0) {
 		printError("FAIL");
-	else
-		printSuccess("DONE");
+		return false;
+	}
+	printSuccess("DONE");
+	return ret;
 }
 
 bool Ice40::dumpFlash(uint32_t base_addr, uint32_t len)
@@ -21,7 +21,7 @@ class Ice40: public Device, SPIInterface {
 			bool verify, int8_t verbose);
 		~Ice40();
 
-		void program(unsigned int offset, bool unprotect_flash) override;
+		bool program(unsigned int offset, bool unprotect_flash) override;
 		bool program_cram(uint8_t *data, uint32_t length);
 		bool dumpFlash(uint32_t base_addr, uint32_t len) override;
 		bool protect_flash(uint32_t len) override;
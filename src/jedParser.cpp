@@ -21,6 +21,7 @@
 #include <utility>
 #include <vector>
 
+#include "checksum.hpp"
 #include "display.hpp"
 #include "jedParser.hpp"
 
@@ -35,7 +36,7 @@ JedParser::JedParser(const string &filename, bool verbose):
 	ConfigBitstreamParser(filename, ConfigBitstreamParser::BIN_MODE, verbose),
 	_fuse_count(0), _pin_count(0), _max_vect_test(0),
 	_featuresRow(0), _feabits(0), _has_feabits(false), _checksum(0),
-	_compute_checksum(0),
+	_compute_checksum(0), _fuse_byte(0), _fuse_bit(0),
 	_userCode(0), _security_settings(0), _default_fuse_state(0),
 	_default_test_condition(0), _arch_code(0), _pinout_code(0)
 {
@@ -80,6 +81,25 @@ vector<string> JedParser::readJEDLine()
 	return lines;
 }
 
+void JedParser::sumFuses(const string &fuses)
+{
+	uint8_t bytes[64];
+	size_t nb_bytes = 0;
+	for (size_t i = 0; i < fuses.size(); i++) {
+		_fuse_byte |= (fuses[i] == '1') << _fuse_bit;
+		if (++_fuse_bit < 8)
+			continue;
+		bytes[nb_bytes++] = _fuse_byte;
+		_fuse_byte = 0;
+		_fuse_bit = 0;
+		if (nb_bytes == sizeof(bytes)) {
+			_fuse_sum.update(bytes, nb_bytes);
+			nb_bytes = 0;
+		}
+	}
+	_fuse_sum.update(bytes, nb_bytes);
+}
+
 /* convert one serie ASCII 1/0 to a vector of
  * unsigned char
  */
@@ -88,6 +108,7 @@ void JedParser::buildDataArray(const string &content, struct jed_data &jed)
 	size_t data_len = content.size();
 	string tmp_buff;
 	fuselist += content;
+	sumFuses(content);
 	for (size_t i = 0; i < content.size(); i+=8) {
 		uint8_t data = 0;
 		for (int ii = 0; ii < 8; ii++) {
@@ -113,6 +134,7 @@ void JedParser::buildDataArray(const vector<string> &content,
 		uint8_t data = 0;
 		data_len += content[i].size();
 		fuselist += content[i];
+		sumFuses(content[i]);
 		for (size_t ii = 0; ii < content[i].size(); ii++) {
 			uint8_t val = (content[i][ii] == '1'?1:0);
 			data |= val << ii;
@@ -354,18 +376,12 @@ int JedParser::parse()
 		size += _data_list[area].len;
 	}
 
-	std::string fuses;
-	std::copy(fuselist.begin(), fuselist.end(), std::back_inserter(fuses));
-
-	if (fuses.size() % 8) {
-		int diff = (((fuses.size() / 8) + 1) * 8) - fuses.size();
-		for (int i = 0; i < diff; i++)
-			fuses += '0';
-	}
-
-	for (size_t i = 0; i < fuses.size(); i+=8)
-		_compute_checksum += reverseByte(std::stoi(fuses.substr(i, 8),
-				nullptr, 2));
+	/* fuse checksum summed by L fields: missing fuses of last Byte
+	 * are 0
+	 */
+	_compute_checksum = _fuse_sum.value();
+	if (_fuse_bit != 0)
+		_compute_checksum += _fuse_byte;
 
 	if (_verbose)
 		printf("theorical checksum %x -> %x\n", _checksum, _compute_checksum);
@@ -13,6 +13,7 @@
 #include <string>
 #include <vector>
 
+#include "checksum.hpp"
 #include "configBitstreamParser.hpp"
 
 class JedParser: public ConfigBitstreamParser {
@@ -32,7 +33,7 @@ class JedParser: public ConfigBitstreamParser {
 		size_t nb_section() { return _data_list.size();}
 		size_t offset_for_section(int id) {return _data_list[id].offset;}
 		int len_for_section(int id) {return _data_list[id].len;}
-		std::string get_fuselist() {return fuselist;}
+		const std::string &get_fuselist() const {return fuselist;}
 		int get_fuse_count() {return _fuse_count;}
 		std::vector<std::string> data_for_section(int id) {
 			return _data_list[id].data;
@@ -47,6 +48,11 @@ class JedParser: public ConfigBitstreamParser {
 		void buildDataArray(const std::string &content, struct jed_data &jed);
 		void buildDataArray(const std::vector<std::string> &content,
 				struct jed_data &jed);
+		/*!
+		 * \brief add fuses to fuse checksum while they are read: first
+		 *        fuse is LSB of first Byte
+		 */
+		void sumFuses(const std::string &fuses);
 		void parseEField(const std::vector<std::string> &content);
 		void parseLField(const std::vector<std::string> &content);
 
@@ -59,6 +65,9 @@ class JedParser: public ConfigBitstreamParser {
 		bool _has_feabits;
 		uint16_t _checksum;
 		uint16_t _compute_checksum;
+		Sum16 _fuse_sum;     /**< sum of complete fuse Bytes */
+		uint8_t _fuse_byte;  /**< Byte being filled */
+		uint8_t _fuse_bit;   /**< fuses in _fuse_byte */
 		uint32_t _userCode;
 		uint8_t _security_settings;
 		uint8_t _default_fuse_state;
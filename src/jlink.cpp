@@ -17,6 +17,7 @@
 #include <string>
 #include <vector>
 
+#include "bufferPool.hpp"
 #include "display.hpp"
 
 #define VID 0x1366
@@ -243,7 +244,7 @@ bool Jlink::ll_write(uint8_t *tdo)
 	if (_num_bits == 0)
 		return true;
 	uint32_t numbytes = (_num_bits + 7) >> 3;
-	uint8_t rx_buf[numbytes+2];
+	BufferPool::Buffer rx_buf(numbytes + 2);
 	uint8_t status;
 	// 1. cmd + dummy + numbits + tms + tdi
 	_xfer_buf[0] = EMU_CMD_HW_JTAG3;
@@ -460,9 +461,10 @@ string Jlink::get_version()
 {
 	uint16_t length;
 	cmd_read(EMU_CMD_VERSION, &length);
-	uint8_t version[length];
+	BufferPool::Buffer version(length + 1);
 	read_device(version, length);
-	return string(reinterpret_cast<char*>(version));
+	version[length] = '\0';
+	return string(reinterpret_cast<char*>(version.data()));
 }
 
 int Jlink::get_hw_version()
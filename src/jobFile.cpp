@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#include <exception>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "configBitstreamParser.hpp"
+#include "display.hpp"
+#include "jobFile.hpp"
+
+JobFile::JobFile(const std::string &filename, int8_t verbose):
+	_filename(filename), _verbose(verbose)
+{
+	std::ifstream fd(filename);
+	if (!fd.is_open())
+		throw std::runtime_error("Error: fail to open " + filename);
+
+	/* jobs files are relative to job file */
+	std::string dir;
+	size_t pos = filename.find_last_of("/\\");
+	if (pos != std::string::npos)
+		dir = filename.substr(0, pos + 1);
+
+	std::string line;
+	int line_num = 0;
+	while (std::getline(fd, line)) {
+		line_num++;
+		std::istringstream iss(line);
+		std::string index, param;
+		if (!(iss >> index) || index[0] == '#')
+			continue;
+
+		const std::string where = filename + ":" + std::to_string(line_num);
+		job_t job;
+		job.line = line_num;
+		job.offset = 0;
+		try {
+			job.index = std::stoi(index, nullptr, 0);
+		} catch (std::exception &e) {
+			throw std::runtime_error("Error: " + where + ": invalid index");
+		}
+		if (job.index < 0)
+			throw std::runtime_error("Error: " + where + ": invalid index");
+
+		if (!(iss >> job.operation))
+			throw std::runtime_error("Error: " + where +
+					": index operation [file] expected");
+		if (job.operation == "sram" || job.operation == "svf") {
+			job.prg_type = Device::WR_SRAM;
+		} else if (job.operation == "flash") {
+			job.prg_type = Device::WR_FLASH;
+		} else if (job.operation == "reset") {
+			job.prg_type = Device::PRG_NONE;
+		} else {
+			throw std::runtime_error("Error: " + where +
+					": unknown operation " + job.operation);
+		}
+
+		while (iss >> param) {
+			size_t eq = param.find('=');
+			if (eq == std::string::npos) {
+				if (!job.filename.empty())
+					throw std::runtime_error("Error: " + where +
+							": more than one file");
+				job.filename = (param[0] == '/') ? param : dir + param;
+				continue;
+			}
+			std::string key = param.substr(0, eq);
+			std::string val = param.substr(eq + 1);
+			if (key == "offset") {
+				try {
+					job.offset = std::stoul(val, nullptr, 0);
+				} catch (std::exception &e) {
+					throw std::runtime_error("Error: " + where +
+							": invalid offset");
+				}
+			} else if (key == "type") {
+				job.file_type = val;
+			} else if (key == "part") {
+				job.fpga_part = val;
+			} else {
+				throw std::runtime_error("Error: " + where +
+						": unknown key " + key);
+			}
+		}
+
+		if (job.operation != "reset" && job.filename.empty())
+			throw std::runtime_error("Error: " + where + ": file expected");
+		if (job.operation == "reset" && !job.filename.empty())
+			throw std::runtime_error("Error: " + where +
+					": reset doesn't use a file");
+		if (job.operation == "svf")
+			job.file_type = "svf";
+
+		_jobs.push_back(job);
+	}
+
+	if (_jobs.empty())
+		throw std::runtime_error("Error: " + filename + ": no job");
+
+	if (_verbose > 0)
+		printInfo(filename + ": " + std::to_string(_jobs.size()) + " jobs");
+}
+
+void JobFile::preload() const
+{
+	/* same file may be used by several jobs, svf is not a bitstream */
+	std::set<std::string> files;
+	for (auto &job : _jobs) {
+		if (!job.filename.empty() && job.file_type != "svf")
+			files.insert(job.filename);
+	}
+
+	std::vector<std::thread> loaders;
+	std::vector<std::exception_ptr> errors(files.size());
+	size_t i = 0;
+	for (auto &file : files) {
+		std::exception_ptr *error = &errors[i++];
+		loaders.push_back(std::thread([&file, error]() {
+			try {
+				ConfigBitstreamParser::preload(file);
+			} catch (...) {
+				*error = std::current_exception();
+			}
+		}));
+	}
+	for (auto &loader : loaders)
+		loader.join();
+
+	for (auto &error : errors) {
+		if (error)
+			std::rethrow_exception(error);
+	}
+}
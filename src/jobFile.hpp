@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#ifndef SRC_JOBFILE_HPP_
+#define SRC_JOBFILE_HPP_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "device.hpp"
+
+/*!
+ * \file jobFile.hpp
+ * \class JobFile
+ * \brief list of operations applied, in order, to devices of a JTAG
+ *        chain in one session. Job file is a text file with one
+ *        operation by line:
+ *        index operation [file] [key=value ...]
+ *        - index: device position in the JTAG chain
+ *        - operation: sram, flash, svf or reset
+ *        - file: relative to job file directory (not for reset)
+ *        - keys: offset (flash offset), type (file type),
+ *          part (fpga part)
+ *        empty lines and lines starting with '#' are ignored
+ */
+class JobFile {
+ public:
+	typedef struct {
+		int line;                     /**< job file line (messages) */
+		int index;                    /**< device in JTAG chain */
+		std::string operation;
+		Device::prog_type_t prg_type;
+		std::string filename;
+		uint32_t offset;
+		std::string file_type;        /**< empty: from file extension */
+		std::string fpga_part;        /**< empty: from command line */
+	} job_t;
+
+	/*!
+	 * \brief read and check job file
+	 * \param[in] filename: job file
+	 * \param[in] verbose: verbose level
+	 */
+	JobFile(const std::string &filename, int8_t verbose);
+
+	/*!
+	 * \brief read (and uncompress) all jobs files in parallel, devices
+	 *        use loaded contents instead of accessing files
+	 */
+	void preload() const;
+
+	/*!
+	 * \brief return jobs list
+	 */
+	const std::vector<job_t> &jobs() const {return _jobs;}
+
+ private:
+	std::string _filename;
+	std::vector<job_t> _jobs;
+	int8_t _verbose;
+};
+
+#endif  // SRC_JOBFILE_HPP_
@@ -8,6 +8,7 @@
 #include <iostream>
 #include <map>
 #include <sstream>
+#include <stdexcept>
 #include <vector>
 #include <string>
 
@@ -24,6 +25,8 @@
 #include "jetsonNanoJtagBitbang.hpp"
 #endif
 #include "jlink.hpp"
+#include "jtagRecorder.hpp"
+#include "jtagReplay.hpp"
 #ifdef ENABLE_CMSISDAP
 #include "cmsisDAP.hpp"
 #endif
@@ -74,14 +77,19 @@ Jtag::Jtag(const cable_t &cable, const jtag_pins_conf_t *pin_conf,
 			const string &dev,
 			const string &serial, uint32_t clkHZ, int8_t verbose,
 			const string &ip_adr, int port,
-			const bool invert_read_edge, const string &firmware_path):
+			const bool invert_read_edge, const string &firmware_path,
+			const string &record_file, const string &replay_file):
 			_verbose(verbose > 1),
 			_state(RUN_TEST_IDLE),
 			_tms_buffer_size(128), _num_tms(0),
-			_board_name("nope"), device_index(0)
+			_board_name("nope"), device_index(0),
+			_ir_cache_dev(-1), _ir_cache_len(0)
 {
 	init_internal(cable, dev, serial, pin_conf, clkHZ, firmware_path,
-			invert_read_edge, ip_adr, port);
+			invert_read_edge, ip_adr, port, replay_file);
+	/* log all probe accesses, from chain detection */
+	if (!record_file.empty())
+		_jtag = new JtagRecorder(_jtag, record_file, verbose);
 	detectChain(5);
 }
 
@@ -93,7 +101,8 @@ Jtag::~Jtag()
 
 void Jtag::init_internal(const cable_t &cable, const string &dev, const string &serial,
 	const jtag_pins_conf_t *pin_conf, uint32_t clkHZ, const string &firmware_path,
-	const bool invert_read_edge, const string &ip_adr, int port)
+	const bool invert_read_edge, const string &ip_adr, int port,
+	const string &replay_file)
 {
 	switch (cable.type) {
 	case MODE_ANLOGICCABLE:
@@ -151,6 +160,11 @@ void Jtag::init_internal(const cable_t &cable, const string &dev, const string &
 		_jtag = new RemoteBitbang_client(ip_adr, port, _verbose);
 		break;
 #endif
+	case MODE_JTAG_REPLAY:
+		if (replay_file.empty())
+			throw std::runtime_error("replay cable requires a JTAG log");
+		_jtag = new JtagReplay(replay_file, (_verbose) ? 1 : 0);
+		break;
 	default:
 		std::cerr << "Jtag: unknown cable type" << std::endl;
 		throw std::exception();
@@ -245,6 +259,8 @@ bool Jtag::insert_first(uint32_t device_id, uint16_t irlength)
 {
 	_devices_list.insert(_devices_list.begin(), device_id);
 	_irlength_list.insert(_irlength_list.begin(), irlength);
+	/* devices index shifted */
+	invalidate_ir();
 
 	return true;
 }
@@ -299,6 +315,8 @@ void Jtag::go_test_logic_reset()
 		setTMS(0x01);
 	flushTMS(false);
 	_state = TEST_LOGIC_RESET;
+	/* IR reloaded with IDCODE/BYPASS */
+	invalidate_ir();
 }
 
 int Jtag::read_write(unsigned char *tdi, unsigned char *tdo, int len, char last)
@@ -320,59 +338,75 @@ void Jtag::toggleClk(int nb)
 	return;
 }
 
-int Jtag::shiftDR(unsigned char *tdi, unsigned char *tdo, int drlen, int end_state)
+int Jtag::read_write(const jtag_seg_t *segs, int nb_segs, char last)
 {
-	/* get number of devices in the JTAG chain
-	 * after the selected one
-	 */
-	int bits_after = device_index;
+	flushTMS(false);
+	_jtag->writeTDIv(segs, nb_segs, last);
+	if (last == 1)
+		_state = (_state == SHIFT_DR) ? EXIT1_DR : EXIT1_IR;
+	return 0;
+}
 
-	/* if current state not shift DR
-	 * move to this state
-	 */
-	if (_state != SHIFT_DR) {
-		set_state(SHIFT_DR);
-		flushTMS(false);  // force transmit tms state
+/* caller segments + bypass before and after without allocation */
+#define JTAG_MAX_SEGS 8
 
-		/* get number of devices, in the JTAG chain,
-		 * before the selected one
-		 */
-		int bits_before = _devices_list.size() - device_index - 1;
+int Jtag::shift_segs(tapState_t shift_state, int pad_before, int pad_after,
+		const jtag_seg_t *segs, int nb_segs, int end_state)
+{
+	std::vector<jtag_seg_t> large;
+	jtag_seg_t local[JTAG_MAX_SEGS];
+	jtag_seg_t *chain = local;
+	if (nb_segs + 2 > JTAG_MAX_SEGS) {
+		large.resize(nb_segs + 2);
+		chain = large.data();
+	}
 
-		/* if not 0 send enough bits
-		 */
-		if (bits_before > 0) {
-			int n = (bits_before + 7) / 8;
-			uint8_t tx[n];
-			memset(tx, 0xff, n);
-			read_write(tx, NULL, bits_before, 0);
-		}
+	/* if current state not shift xR
+	 * move to this state and send bypass
+	 * for devices before the selected one
+	 */
+	int n = 0;
+	if (_state != shift_state) {
+		set_state(shift_state);
+		if (pad_before > 0)
+			chain[n++] = {NULL, NULL, (uint32_t)pad_before, 1};
 	}
 
-	/* write tdi (and read tdo) to the selected device
-	 * end (ie TMS high) is used only when current device
-	 * is the last of the chain and a state change must
-	 * be done
+	for (int i = 0; i < nb_segs; i++)
+		chain[n++] = segs[i];
+
+	/* if it's asked to move in FSM: bypass devices after
+	 * the selected one, TMS high with the last bit
 	 */
-	read_write(tdi, tdo, drlen, bits_after == 0 && end_state != SHIFT_DR);
-
-	/* if it's asked to move in FSM */
-	if (end_state != SHIFT_DR) {
-		/* if current device is not the last */
-		if (bits_after > 0) {
-			int n = (bits_after + 7) / 8;
-			uint8_t tx[n];
-			memset(tx, 0xff, n);
-			read_write(tx, NULL, bits_after, 1);  // its the last force
-			                                      // tms high with last bit
-		}
+	if (end_state != shift_state && pad_after > 0)
+		chain[n++] = {NULL, NULL, (uint32_t)pad_after, 1};
 
-		/* move to end_state */
+	read_write(chain, n, end_state != shift_state);
+
+	/* move to end_state */
+	if (end_state != shift_state)
 		set_state(end_state);
-	}
 	return 0;
 }
 
+int Jtag::shiftDR(unsigned char *tdi, unsigned char *tdo, int drlen, int end_state)
+{
+	jtag_seg_t seg = {tdi, tdo, (uint32_t)drlen, 0};
+	return shiftDR(&seg, 1, end_state);
+}
+
+int Jtag::shiftDR(const jtag_seg_t *segs, int nb_segs, int end_state)
+{
+	/* one bypass bit for each device after and before
+	 * the selected one in the chain
+	 */
+	int bits_after = device_index;
+	int bits_before = _devices_list.size() - device_index - 1;
+
+	return shift_segs(SHIFT_DR, bits_before, bits_after, segs, nb_segs,
+		end_state);
+}
+
 int Jtag::shiftIR(unsigned char tdi, int irlen, int end_state)
 {
 	if (irlen > 8) {
@@ -395,51 +429,57 @@ int Jtag::shiftIR(unsigned char *tdi, unsigned char *tdo, int irlen, int end_sta
 			bypass_after += _irlength_list[i];
 	}
 
-	/* if not in SHIFT IR move to this state */
-	if (_state != SHIFT_IR) {
-		set_state(SHIFT_IR);
-		/* force flush */
-		flushTMS(false);
+	/* series of bypass instructions: final size depends on
+	 * number of devices before targeted and irlength of each one
+	 */
+	int bypass_before = 0;
+	for (unsigned int i = device_index + 1; i < _devices_list.size(); i++)
+		bypass_before += _irlength_list[i];
 
-		/* send serie of bypass instructions
-		 * final size depends on number of device
-		 * before targeted and irlength of each one
-		 */
-		int bypass_before = 0;
-		for (unsigned int i = device_index + 1; i < _devices_list.size(); i++)
-			bypass_before += _irlength_list[i];
-
-		/* if > 0 send bits */
-		if (bypass_before > 0) {
-			int n = (bypass_before + 7) / 8;
-			uint8_t tx[n];
-			memset(tx, 0xff, n);
-			read_write(tx, NULL, bypass_before, 0);
-		}
+	display("%s: envoi ircode\n", __func__);
+
+	jtag_seg_t seg = {tdi, tdo, (uint32_t)irlen, 0};
+	shift_segs(SHIFT_IR, bypass_before, bypass_after, &seg, 1, end_state);
+
+	/* update IR shadow: a partial scan let IR unknown */
+	if (end_state == SHIFT_IR || tdi == NULL) {
+		invalidate_ir();
+	} else {
+		_ir_cache.assign(tdi, tdi + (irlen + 7) / 8);
+		_ir_cache_len = irlen;
+		_ir_cache_dev = device_index;
 	}
 
-	display("%s: envoi ircode\n", __func__);
+	return 0;
+}
 
-	/* write tdi (and read tdo) to the selected device
-	 * end (ie TMS high) is used only when current device
-	 * is the last of the chain and a state change must
-	 * be done
+int Jtag::shiftIR_cached(unsigned char *tdi, int irlen, int end_state)
+{
+	/* TAP must be in a state where next DR scan has the same path
+	 * with or without an IR scan. Pause-DR is accepted but must be
+	 * left below: a DR scan started from there skips Capture-DR
 	 */
-	read_write(tdi, tdo, irlen, bypass_after == 0 && end_state != SHIFT_IR);
-
-	/* it's asked to move out of SHIFT IR state */
-	if (end_state != SHIFT_IR) {
-		/* again if devices after fill '1' */
-		if (bypass_after > 0) {
-			int n = (bypass_after + 7) / 8;
-			uint8_t tx[n];
-			memset(tx, 0xff, n);
-			read_write(tx, NULL, bypass_after, 1);
+	bool stable = (_state == RUN_TEST_IDLE || _state == UPDATE_DR ||
+			_state == UPDATE_IR || _state == PAUSE_DR);
+	bool hit = stable && _ir_cache_dev == device_index &&
+			_ir_cache_len == irlen &&
+			(end_state == RUN_TEST_IDLE || end_state == UPDATE_IR ||
+			 end_state == PAUSE_IR);
+	if (hit) {
+		int nb_bytes = irlen / 8;
+		int rest = irlen % 8;
+		hit = memcmp(tdi, _ir_cache.data(), nb_bytes) == 0;
+		if (hit && rest != 0) {
+			uint8_t mask = (1 << rest) - 1;
+			hit = ((tdi[nb_bytes] ^ _ir_cache[nb_bytes]) & mask) == 0;
 		}
-		/* move to the requested state */
-		set_state(end_state);
 	}
 
+	if (!hit)
+		return shiftIR(tdi, NULL, irlen, end_state);
+
+	if (end_state == RUN_TEST_IDLE || _state == PAUSE_DR)
+		set_state(RUN_TEST_IDLE);
 	return 0;
 }
 
@@ -629,6 +669,11 @@ void Jtag::set_state(int newState)
 		setTMS(tms);
 		display("%d %d %d %x\n", tms, _num_tms-1, _state,
 			_tms_buffer[(_num_tms-1) / 8]);
+		/* IR content changes on reset or on IR scan: shiftIR
+		 * updates the shadow once the instruction is shifted
+		 */
+		if (_state == TEST_LOGIC_RESET || _state == CAPTURE_IR)
+			invalidate_ir();
 	}
 	/* force write buffer */
 	flushTMS(false);
@@ -21,7 +21,9 @@ class Jtag {
 		const std::string &serial, uint32_t clkHZ, int8_t verbose,
 		const std::string &ip_adr, int port,
 		const bool invert_read_edge = false,
-		const std::string &firmware_path = "");
+		const std::string &firmware_path = "",
+		const std::string &record_file = "",
+		const std::string &replay_file = "");
 	~Jtag();
 
 	/* maybe to update */
@@ -41,6 +43,11 @@ class Jtag {
 	 * \return list of devices
 	 */
 	std::vector<int> get_devices_list() {return _devices_list;}
+	/*!
+	 * \brief return irlength of each device in the chain
+	 * \return list of irlength (same order as devices list)
+	 */
+	std::vector<int16_t> get_irlength_list() {return _irlength_list;}
 
 	/*!
 	 * \brief return current selected device idcode
@@ -72,15 +79,52 @@ class Jtag {
 		int end_state = RUN_TEST_IDLE);
 	int shiftIR(unsigned char tdi, int irlen,
 		int end_state = RUN_TEST_IDLE);
+	/*!
+	 * \brief same as shiftIR but the IR scan is skipped when the
+	 *        selected device already holds this instruction (IR shadow
+	 *        updated by each shiftIR). Only for instructions used as a
+	 *        DR selector (USERx, commands followed by a DR scan):
+	 *        Update-IR is not replayed
+	 * \param[in] tdi: instruction
+	 * \param[in] irlen: instruction length (bits)
+	 * \param[in] end_state: state after the scan. When skipped the TAP
+	 *            stays in its current (stable or update) state which
+	 *            is equivalent for next DR scan, except Pause-DR which
+	 *            is left to Run-Test/Idle so next DR scan captures
+	 * \return 0
+	 */
+	int shiftIR_cached(unsigned char *tdi, int irlen,
+		int end_state = RUN_TEST_IDLE);
+	/*!
+	 * \brief forget IR shadow: to call after any TAP access not done
+	 *        through this class
+	 */
+	void invalidate_ir() {_ir_cache_dev = -1;}
 	int shiftDR(unsigned char *tdi, unsigned char *tdo, int drlen,
 		int end_state = RUN_TEST_IDLE);
+	/*!
+	 * \brief same as shiftDR but data are a list of segments sent as
+	 *        one scan with bypass bits (command, payload, dummy bits
+	 *        without copy into a single buffer)
+	 * \param[in] segs: segments to send in order
+	 * \param[in] nb_segs: number of segments
+	 * \param[in] end_state: state after the scan
+	 * \return 0
+	 */
+	int shiftDR(const jtag_seg_t *segs, int nb_segs,
+		int end_state = RUN_TEST_IDLE);
 	int read_write(unsigned char *tdi, unsigned char *tdo, int len, char last);
+	int read_write(const jtag_seg_t *segs, int nb_segs, char last);
 
 	void toggleClk(int nb);
 	void go_test_logic_reset();
 	void set_state(int newState);
 	int flushTMS(bool flush_buffer = false);
 	void flush() {flushTMS(); _jtag->flush();}
+	/*!
+	 * \brief see JtagInterface::hold_writes
+	 */
+	void hold_writes(bool hold) {flushTMS(); _jtag->hold_writes(hold);}
 	void setTMS(unsigned char tms);
 
 	enum tapState_t {
@@ -110,12 +154,19 @@ class Jtag {
 	JtagInterface *_jtag;
 
  private:
+	/*!
+	 * \brief move to shift_state and send segments surrounded by
+	 *        pad_before/pad_after bypass bits (high) in one transfer
+	 */
+	int shift_segs(tapState_t shift_state, int pad_before, int pad_after,
+		const jtag_seg_t *segs, int nb_segs, int end_state);
 	void init_internal(const cable_t &cable, const std::string &dev,
 		const std::string &serial,
 		const jtag_pins_conf_t *pin_conf, uint32_t clkHZ,
 		const std::string &firmware_path,
 		const bool invert_read_edge,
-		const std::string &ip_adr, int port);
+		const std::string &ip_adr, int port,
+		const std::string &replay_file);
 	/*!
 	 * \brief search in fpga_list and misc_dev_list for a device with idcode
 	 *        if found insert idcode and irlength in _devices_list and
@@ -132,7 +183,45 @@ class Jtag {
 	std::string _board_name;
 
 	int device_index; /*!< index for targeted FPGA */
+	/* IR shadow: a shiftIR loads bypass in others devices so only
+	 * the last targeted device is tracked
+	 */
+	int _ir_cache_dev; /*!< device index, -1 when IR is unknown */
+	int _ir_cache_len; /*!< instruction length (bits) */
+	std::vector<uint8_t> _ir_cache; /*!< last instruction */
 	std::vector<int32_t> _devices_list; /*!< ordered list of devices idcode */
 	std::vector<int16_t> _irlength_list; /*!< ordered list of irlength */
 };
+
+/*!
+ * \brief scoped Jtag::hold_writes: writes are held from construction
+ *        until release() or end of scope (exception included), so the
+ *        probe is never left in buffering mode
+ */
+class JtagHoldWrites {
+ public:
+	explicit JtagHoldWrites(Jtag *jtag): _jtag(jtag) {_jtag->hold_writes(true);}
+	~JtagHoldWrites() {
+		/* unwinding: an error while flushing can't be reported */
+		try {
+			release();
+		} catch (...) {}
+	}
+	/*!
+	 * \brief stop holding writes (buffer is flushed)
+	 */
+	void release() {
+		if (!_jtag)
+			return;
+		Jtag *jtag = _jtag;
+		_jtag = NULL;
+		jtag->hold_writes(false);
+	}
+
+ private:
+	JtagHoldWrites(const JtagHoldWrites &) = delete;
+	JtagHoldWrites &operator=(const JtagHoldWrites &) = delete;
+
+	Jtag *_jtag;
+};
 #endif
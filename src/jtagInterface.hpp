@@ -7,9 +7,20 @@
 #define _JTAGINTERFACE_H_
 
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <vector>
 
+/*!
+ * \brief one segment of a TDI/TDO scatter-gather transfer
+ */
+typedef struct {
+	const uint8_t *tx; /*!< TDI bits, NULL: len bits at fill value */
+	uint8_t *rx;       /*!< TDO bits, may be NULL */
+	uint32_t len;      /*!< number of bits */
+	uint8_t fill;      /*!< TDI value (0 or 1) when tx is NULL */
+} jtag_seg_t;
+
 /*!
  * \file JtagInterface.hpp
  * \class JtagInterface
@@ -34,7 +45,9 @@ class JtagInterface {
 
 	/*!
 	 * \brief send TDI bits (mainly in shift DR/IR state)
-	 * \param tdi: array of TDI values (used to write)
+	 * \param tdi: array of TDI values (used to write). May be NULL when
+	 *             only TDO matters: TDI level is then driver dependent,
+	 *             callers needing a defined level must pass data
 	 * \param tdo: array of TDO values (used when read)
 	 * \param len: number of bit to send/receive
 	 * \param end: in JTAG state machine last bit and tms are set in same time
@@ -42,6 +55,52 @@ class JtagInterface {
 	 * \return number of bit written and/or read
 	 */
 	virtual int writeTDI(uint8_t *tx, uint8_t *rx, uint32_t len, bool end) = 0;
+	/*!
+	 * \brief send TDI bits of a list of segments as one continuous scan,
+	 *        without copying them into a single buffer (bypass padding,
+	 *        command + payload, dummy bits)
+	 * \param segs: segments to send in order. A segment without tx is
+	 *              sent at its fill value: overrides must honor it
+	 * \param nb_segs: number of segments
+	 * \param end: set TMS with last bit of last segment (see writeTDI)
+	 * \return number of bit written and/or read
+	 */
+	virtual int writeTDIv(const jtag_seg_t *segs, uint32_t nb_segs, bool end)
+	{
+		/* last segment with bits: the one sent with end */
+		int last = -1;
+		for (uint32_t i = 0; i < nb_segs; i++)
+			if (segs[i].len != 0)
+				last = i;
+
+		int ret = 0;
+		uint8_t fill[64];
+		const uint32_t fill_bits = 8 * sizeof(fill);
+		for (int i = 0; i <= last; i++) {
+			const jtag_seg_t &seg = segs[i];
+			if (seg.len == 0)
+				continue;
+			if (seg.tx) {
+				writeTDI(const_cast<uint8_t *>(seg.tx), seg.rx, seg.len,
+					end && i == last);
+				ret += seg.len;
+				continue;
+			}
+			/* no TDI data: by chunks of an explicit fill buffer (writeTDI
+			 * with a NULL tx gives a driver dependent level)
+			 */
+			memset(fill, (seg.fill) ? 0xff : 0x00, sizeof(fill));
+			for (uint32_t pos = 0; pos < seg.len; pos += fill_bits) {
+				uint32_t len = seg.len - pos;
+				if (len > fill_bits)
+					len = fill_bits;
+				writeTDI(fill, (seg.rx) ? seg.rx + (pos >> 3) : NULL, len,
+					end && i == last && pos + len == seg.len);
+			}
+			ret += seg.len;
+		}
+		return ret;
+	}
 	/*!
 	 * \brief send TMD and TDI and receive tdo bits;
 	 * \param tms: array of TMS values (used to write)
@@ -79,6 +138,13 @@ class JtagInterface {
 	 * \return 1 if success, 0 if nothing to write, -1 is something wrong
 	 */
 	virtual int flush() = 0;
+	/*!
+	 * \brief keep write only transfers in internal buffer (sent when
+	 *        full, before a read or with flush) instead of sending them
+	 *        after each scan. Only a hint: default is to do nothing
+	 * \param hold: true to start, false to stop (buffer is flushed)
+	 */
+	virtual void hold_writes(bool hold) {(void)hold;}
  protected:
 	uint32_t _clkHZ; /*!< current clk frequency */
 };
@@ -0,0 +1,220 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#include "display.hpp"
+#include "jtagRecorder.hpp"
+
+using namespace std::chrono;
+
+static void put_u32(std::vector<uint8_t> &buf, uint32_t val)
+{
+	for (int i = 0; i < 4; i++)
+		buf.push_back((val >> (8 * i)) & 0xff);
+}
+
+JtagRecorder::JtagRecorder(JtagInterface *jtag, const std::string &filename,
+		int8_t verbose): _jtag(jtag), _verbose(verbose), _nb_bits(0),
+		_driver_us(0)
+{
+	_fd = fopen(filename.c_str(), "wb");
+	if (!_fd)
+		throw std::runtime_error("Error: can't create JTAG log " + filename);
+
+	memset(_nb_op, 0, sizeof(_nb_op));
+	_clkHZ = _jtag->getClkFreq();
+
+	std::vector<uint8_t> header(JTAG_LOG_MAGIC, JTAG_LOG_MAGIC + 4);
+	header.push_back(JTAG_LOG_VERSION);
+	put_u32(header, _clkHZ);
+	put_u32(header, _jtag->get_buffer_size());
+	fwrite(header.data(), 1, header.size(), _fd);
+
+	_last = steady_clock::now();
+}
+
+JtagRecorder::~JtagRecorder()
+{
+	fclose(_fd);
+
+	if (_verbose > 0) {
+		char mess[256];
+		snprintf(mess, sizeof(mess), "JTAG log: driver calls TMS %u TDI %u "
+			"TDIv %u TMSTDI %u CLK %u flush %u, %llu bits, %llu us in driver",
+			_nb_op[JTAG_LOG_TMS], _nb_op[JTAG_LOG_TDI],
+			_nb_op[JTAG_LOG_TDIV], _nb_op[JTAG_LOG_TMSTDI],
+			_nb_op[JTAG_LOG_CLK],
+			_nb_op[JTAG_LOG_FLUSH], (unsigned long long)_nb_bits,
+			(unsigned long long)_driver_us);
+		printInfo(mess);
+	}
+
+	delete _jtag;
+}
+
+uint32_t JtagRecorder::start()
+{
+	_payload.clear();
+	_begin = steady_clock::now();
+	return duration_cast<microseconds>(_begin - _last).count();
+}
+
+void JtagRecorder::append_bits(const uint8_t *bits, uint32_t len)
+{
+	_payload.insert(_payload.end(), bits, bits + (len + 7) / 8);
+}
+
+void JtagRecorder::log(uint8_t op, uint8_t flags, uint32_t len,
+		uint32_t gap, int32_t ret)
+{
+	_last = steady_clock::now();
+	uint32_t dur = duration_cast<microseconds>(_last - _begin).count();
+
+	std::vector<uint8_t> rec;
+	rec.reserve(18 + _payload.size());
+	rec.push_back(op);
+	rec.push_back(flags);
+	put_u32(rec, len);
+	put_u32(rec, gap);
+	put_u32(rec, dur);
+	put_u32(rec, (uint32_t)ret);
+	rec.insert(rec.end(), _payload.begin(), _payload.end());
+	fwrite(rec.data(), 1, rec.size(), _fd);
+
+	/* segments are counted with their TDIV record */
+	if (!(op == JTAG_LOG_TDI && (flags & JTAG_LOG_SEG)))
+		_nb_op[op]++;
+	_driver_us += dur;
+	if (op != JTAG_LOG_SETFREQ && op != JTAG_LOG_FLUSH &&
+			op != JTAG_LOG_TDIV)
+		_nb_bits += len;
+	/* log time is host time, not driver time */
+	_last = steady_clock::now();
+}
+
+int JtagRecorder::setClkFreq(uint32_t clkHZ)
+{
+	uint32_t gap = start();
+	int ret = _jtag->setClkFreq(clkHZ);
+	_clkHZ = _jtag->getClkFreq();
+	log(JTAG_LOG_SETFREQ, 0, clkHZ, gap, ret);
+	return ret;
+}
+
+int JtagRecorder::writeTMS(uint8_t *tms, uint32_t len, bool flush_buffer)
+{
+	uint32_t gap = start();
+	/* caller may reuse buffer: copy before call */
+	append_bits(tms, len);
+	int ret = _jtag->writeTMS(tms, len, flush_buffer);
+	log(JTAG_LOG_TMS, (flush_buffer) ? JTAG_LOG_FLUSH_BUF : 0, len, gap, ret);
+	return ret;
+}
+
+int JtagRecorder::writeTDI(uint8_t *tx, uint8_t *rx, uint32_t len, bool end)
+{
+	uint8_t flags = (end) ? JTAG_LOG_END : 0;
+	uint32_t gap = start();
+	if (tx) {
+		flags |= JTAG_LOG_HAS_TDI;
+		append_bits(tx, len);
+	}
+	int ret = _jtag->writeTDI(tx, rx, len, end);
+	if (rx) {
+		flags |= JTAG_LOG_HAS_TDO;
+		append_bits(rx, len);
+	}
+	log(JTAG_LOG_TDI, flags, len, gap, ret);
+	return ret;
+}
+
+int JtagRecorder::writeTDIv(const jtag_seg_t *segs, uint32_t nb_segs,
+		bool end)
+{
+	uint32_t gap = start();
+	/* forwarded as is: driver packs segments as without recorder */
+	int ret = _jtag->writeTDIv(segs, nb_segs, end);
+
+	uint32_t nb_rec = 0, last = 0;
+	for (uint32_t i = 0; i < nb_segs; i++) {
+		if (segs[i].len != 0) {
+			nb_rec++;
+			last = i;
+		}
+	}
+	/* driver time is given to the TDIV record */
+	log(JTAG_LOG_TDIV, (end) ? JTAG_LOG_END : 0, nb_rec, gap, ret);
+
+	for (uint32_t i = 0; i < nb_segs; i++) {
+		const jtag_seg_t &seg = segs[i];
+		if (seg.len == 0)
+			continue;
+		uint8_t flags = JTAG_LOG_SEG;
+		if (end && i == last)
+			flags |= JTAG_LOG_END;
+		_payload.clear();
+		_begin = steady_clock::now();
+		if (seg.tx) {
+			flags |= JTAG_LOG_HAS_TDI;
+			append_bits(seg.tx, seg.len);
+		} else {
+			flags |= JTAG_LOG_HAS_TDI;
+			_payload.resize((seg.len + 7) / 8, (seg.fill) ? 0xff : 0x00);
+		}
+		if (seg.rx) {
+			flags |= JTAG_LOG_HAS_TDO;
+			append_bits(seg.rx, seg.len);
+		}
+		log(JTAG_LOG_TDI, flags, seg.len, 0, ret);
+	}
+	return ret;
+}
+
+bool JtagRecorder::writeTMSTDI(const uint8_t *tms, const uint8_t *tdi,
+		uint8_t *tdo, uint32_t len)
+{
+	uint32_t gap = start();
+	bool ret = _jtag->writeTMSTDI(tms, tdi, tdo, len);
+	/* not supported by driver: nothing sent */
+	if (!ret)
+		return ret;
+
+	uint8_t flags = JTAG_LOG_HAS_TDI;
+	append_bits(tms, len);
+	append_bits(tdi, len);
+	if (tdo) {
+		flags |= JTAG_LOG_HAS_TDO;
+		append_bits(tdo, len);
+	}
+	log(JTAG_LOG_TMSTDI, flags, len, gap, ret);
+	return ret;
+}
+
+int JtagRecorder::toggleClk(uint8_t tms, uint8_t tdi, uint32_t clk_len)
+{
+	uint8_t flags = JTAG_LOG_HAS_TDI;
+	if (tms)
+		flags |= JTAG_LOG_CLK_TMS;
+	if (tdi)
+		flags |= JTAG_LOG_CLK_TDI;
+	uint32_t gap = start();
+	int ret = _jtag->toggleClk(tms, tdi, clk_len);
+	log(JTAG_LOG_CLK, flags, clk_len, gap, ret);
+	return ret;
+}
+
+int JtagRecorder::flush()
+{
+	uint32_t gap = start();
+	int ret = _jtag->flush();
+	log(JTAG_LOG_FLUSH, 0, 0, gap, ret);
+	return ret;
+}
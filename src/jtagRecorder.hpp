@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#ifndef SRC_JTAGRECORDER_HPP_
+#define SRC_JTAGRECORDER_HPP_
+
+#include <stdio.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "jtagInterface.hpp"
+
+/*!
+ * \file jtagRecorder.hpp
+ * \brief JTAG operations log: binary file (little endian) with a header
+ *        ("OJRL", version (1B), clk freq (4B), buffer size (4B)) followed
+ *        by records:
+ *        op (1B), flags (1B), len (4B), gap_us (4B): host time since
+ *        previous call end, dur_us (4B): time spent in the driver,
+ *        ret (4B): driver return value, then op payload (bit arrays
+ *        of len bits, LSB first). A writeTDIv call is a TDIV record
+ *        (len: number of segments) followed by one TDI record by
+ *        segment, with JTAG_LOG_SEG flag
+ */
+
+#define JTAG_LOG_MAGIC   "OJRL"
+#define JTAG_LOG_VERSION 2
+
+/* ops and payloads */
+enum jtag_log_op {
+	JTAG_LOG_SETFREQ = 0, /*! len: frequency */
+	JTAG_LOG_TMS     = 1, /*! tms */
+	JTAG_LOG_TDI     = 2, /*! [tdi] [tdo] */
+	JTAG_LOG_TMSTDI  = 3, /*! tms tdi [tdo] */
+	JTAG_LOG_CLK     = 4, /*! len: clk cycles */
+	JTAG_LOG_FLUSH   = 5, /*! none */
+	JTAG_LOG_TDIV    = 6, /*! none, followed by len TDI records */
+	JTAG_LOG_NB_OP
+};
+
+/* flags */
+#define JTAG_LOG_FLUSH_BUF (1 << 0) /*! TMS: flush_buffer */
+#define JTAG_LOG_END       (1 << 0) /*! TDI: end */
+#define JTAG_LOG_CLK_TMS   (1 << 0) /*! CLK: tms state */
+#define JTAG_LOG_CLK_TDI   (1 << 1) /*! CLK: tdi state */
+#define JTAG_LOG_HAS_TDI   (1 << 2) /*! tdi provided */
+#define JTAG_LOG_HAS_TDO   (1 << 3) /*! tdo read */
+#define JTAG_LOG_SEG       (1 << 4) /*! TDI: segment of a TDIV record */
+
+/*!
+ * \class JtagRecorder
+ * \brief JtagInterface wrapper: forwards each call to a probe driver
+ *        and logs it with TDO results and timings
+ */
+class JtagRecorder: public JtagInterface {
+ public:
+	/*!
+	 * \brief constructor
+	 * \param[in] jtag: probe driver, owned by the recorder
+	 * \param[in] filename: log file
+	 * \param[in] verbose: display a summary at the end when > 0
+	 */
+	JtagRecorder(JtagInterface *jtag, const std::string &filename,
+			int8_t verbose);
+	~JtagRecorder();
+
+	int setClkFreq(uint32_t clkHZ) override;
+	uint32_t getClkFreq() override {return _jtag->getClkFreq();}
+	int writeTMS(uint8_t *tms, uint32_t len, bool flush_buffer) override;
+	int writeTDI(uint8_t *tx, uint8_t *rx, uint32_t len, bool end) override;
+	int writeTDIv(const jtag_seg_t *segs, uint32_t nb_segs,
+			bool end) override;
+	bool writeTMSTDI(const uint8_t *tms, const uint8_t *tdi,
+			uint8_t *tdo, uint32_t len) override;
+	int toggleClk(uint8_t tms, uint8_t tdi, uint32_t clk_len) override;
+	int get_buffer_size() override {return _jtag->get_buffer_size();}
+	bool isFull() override {return _jtag->isFull();}
+	int flush() override;
+	void hold_writes(bool hold) override {_jtag->hold_writes(hold);}
+
+ private:
+	/*!
+	 * \brief start a call: time since previous call end
+	 */
+	uint32_t start();
+	/*!
+	 * \brief write a record, payload already in _payload
+	 */
+	void log(uint8_t op, uint8_t flags, uint32_t len, uint32_t gap,
+			int32_t ret);
+	void append_bits(const uint8_t *bits, uint32_t len);
+
+	JtagInterface *_jtag;
+	FILE *_fd;
+	int8_t _verbose;
+	std::vector<uint8_t> _payload;
+	std::chrono::steady_clock::time_point _last;  /**< previous call end */
+	std::chrono::steady_clock::time_point _begin; /**< current call start */
+	uint32_t _nb_op[JTAG_LOG_NB_OP];
+	uint64_t _nb_bits;
+	uint64_t _driver_us;
+};
+
+#endif  // SRC_JTAGRECORDER_HPP_
@@ -0,0 +1,287 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#include <string.h>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "display.hpp"
+#include "jtagRecorder.hpp"
+#include "jtagReplay.hpp"
+
+using namespace std::chrono;
+
+static inline uint8_t get_bit(const uint8_t *buf, uint64_t pos)
+{
+	return (buf[pos >> 3] >> (pos & 0x07)) & 0x01;
+}
+
+static inline void set_bit(std::vector<uint8_t> &buf, uint64_t pos,
+		uint8_t val)
+{
+	if ((pos >> 3) >= buf.size())
+		buf.resize((pos >> 3) + 1, 0);
+	if (val)
+		buf[pos >> 3] |= (1 << (pos & 0x07));
+}
+
+static uint32_t get_u32(const uint8_t *buf)
+{
+	return buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+JtagReplay::JtagReplay(const std::string &filename, int8_t verbose):
+	_verbose(verbose), _buffer_size(0), _nb_cycles(0), _pos(0),
+	_mismatch(0), _first_mismatch(0), _tdo_unknown(0), _rec_driver_us(0),
+	_rec_host_us(0)
+{
+	std::ifstream fd(filename, std::ios::binary);
+	if (!fd.good())
+		throw std::runtime_error("Error: can't open JTAG log " + filename);
+	std::vector<uint8_t> log((std::istreambuf_iterator<char>(fd)),
+			std::istreambuf_iterator<char>());
+
+	const size_t hdr_len = 13, rec_len = 18;
+	if (log.size() < hdr_len || memcmp(log.data(), JTAG_LOG_MAGIC, 4) ||
+			log[4] < 1 || log[4] > JTAG_LOG_VERSION)
+		throw std::runtime_error("Error: " + filename + " is not a JTAG log");
+
+	_clkHZ = get_u32(&log[5]);
+	_buffer_size = get_u32(&log[9]);
+	memset(_rec_op, 0, sizeof(_rec_op));
+	memset(_op, 0, sizeof(_op));
+
+	size_t pos = hdr_len;
+	while (pos + rec_len <= log.size()) {
+		const uint8_t *rec = &log[pos];
+		uint8_t op = rec[0], flags = rec[1];
+		uint32_t len = get_u32(rec + 2);
+		_rec_host_us += get_u32(rec + 6);
+		_rec_driver_us += get_u32(rec + 10);
+		pos += rec_len;
+
+		uint32_t nb_byte = (len + 7) / 8;
+		uint32_t nb_array = 0;
+		switch (op) {
+		case JTAG_LOG_TMS:
+			nb_array = 1;
+			break;
+		case JTAG_LOG_TDI:
+			nb_array = ((flags & JTAG_LOG_HAS_TDI) ? 1 : 0) +
+				((flags & JTAG_LOG_HAS_TDO) ? 1 : 0);
+			break;
+		case JTAG_LOG_TMSTDI:
+			nb_array = 2 + ((flags & JTAG_LOG_HAS_TDO) ? 1 : 0);
+			break;
+		case JTAG_LOG_SETFREQ:
+		case JTAG_LOG_CLK:
+		case JTAG_LOG_FLUSH:
+		case JTAG_LOG_TDIV:
+			break;
+		default:
+			throw std::runtime_error("Error: corrupted JTAG log");
+		}
+		if (pos + nb_array * nb_byte > log.size())
+			throw std::runtime_error("Error: truncated JTAG log");
+
+		const uint8_t *data = &log[pos];
+		pos += nb_array * nb_byte;
+		/* segments are counted with their TDIV record */
+		if (!(op == JTAG_LOG_TDI && (flags & JTAG_LOG_SEG)))
+			_rec_op[op]++;
+
+		switch (op) {
+		case JTAG_LOG_TMS:
+			load_cycles(data, 0, false, NULL, 0, false, NULL, len);
+			break;
+		case JTAG_LOG_TDI: {
+			const uint8_t *tdi = (flags & JTAG_LOG_HAS_TDI) ? data : NULL;
+			const uint8_t *tdo = (flags & JTAG_LOG_HAS_TDO) ?
+				data + ((tdi) ? nb_byte : 0) : NULL;
+			/* TMS low, high for last cycle when end */
+			load_cycles(NULL, 0, flags & JTAG_LOG_END, tdi, 0, tdi != NULL,
+				tdo, len);
+			break;
+		}
+		case JTAG_LOG_TMSTDI:
+			load_cycles(data, 0, false, data + nb_byte, 0, true,
+				(flags & JTAG_LOG_HAS_TDO) ? data + 2 * nb_byte : NULL, len);
+			break;
+		case JTAG_LOG_CLK:
+			load_cycles(NULL, (flags & JTAG_LOG_CLK_TMS) ? 1 : 0, false, NULL,
+				(flags & JTAG_LOG_CLK_TDI) ? 1 : 0, true, NULL, len);
+			break;
+		}
+	}
+
+	if (pos != log.size())
+		printWarn("JTAG replay: truncated log");
+
+	if (_verbose > 0) {
+		char mess[128];
+		snprintf(mess, sizeof(mess), "JTAG replay: %llu cycles loaded",
+			(unsigned long long)_nb_cycles);
+		printInfo(mess);
+	}
+
+	_start = steady_clock::now();
+}
+
+JtagReplay::~JtagReplay()
+{
+	uint64_t host_us = duration_cast<microseconds>(
+		steady_clock::now() - _start).count();
+
+	static const char *names[JTAG_LOG_NB_OP] = {"setClkFreq", "writeTMS",
+		"writeTDI", "writeTMSTDI", "toggleClk", "flush", "writeTDIv"};
+	char mess[256];
+
+	printInfo("JTAG replay:          recorded   replayed");
+	for (int i = 0; i < JTAG_LOG_NB_OP; i++) {
+		snprintf(mess, sizeof(mess), "    %-12s %10u %10u", names[i],
+			_rec_op[i], _op[i]);
+		printInfo(mess);
+	}
+	snprintf(mess, sizeof(mess), "    %-12s %10llu %10llu", "cycles",
+		(unsigned long long)_nb_cycles, (unsigned long long)_pos);
+	printInfo(mess);
+	snprintf(mess, sizeof(mess), "    host time: recorded %llu us "
+		"(+ %llu us in driver), replayed %llu us",
+		(unsigned long long)_rec_host_us, (unsigned long long)_rec_driver_us,
+		(unsigned long long)host_us);
+	printInfo(mess);
+
+	if (_mismatch != 0) {
+		snprintf(mess, sizeof(mess), "JTAG replay: %llu TMS/TDI mismatch "
+			"(first at cycle %llu)", (unsigned long long)_mismatch,
+			(unsigned long long)_first_mismatch);
+		printWarn(mess);
+	}
+	if (_tdo_unknown != 0) {
+		snprintf(mess, sizeof(mess), "JTAG replay: %llu TDO bits not recorded",
+			(unsigned long long)_tdo_unknown);
+		printWarn(mess);
+	}
+}
+
+void JtagReplay::load_cycles(const uint8_t *tms, uint8_t tms_val,
+		bool end, const uint8_t *tdi, uint8_t tdi_val, bool tdi_valid,
+		const uint8_t *tdo, uint32_t len)
+{
+	for (uint32_t i = 0; i < len; i++, _nb_cycles++) {
+		uint8_t tms_bit = (tms) ? get_bit(tms, i) : tms_val;
+		if (end && i == len - 1)
+			tms_bit = 1;
+		set_bit(_tms, _nb_cycles, tms_bit);
+		set_bit(_tdi, _nb_cycles, (tdi) ? get_bit(tdi, i) : tdi_val);
+		set_bit(_tdi_valid, _nb_cycles, tdi_valid);
+		set_bit(_tdo, _nb_cycles, (tdo) ? get_bit(tdo, i) : 1);
+		set_bit(_tdo_valid, _nb_cycles, tdo != NULL);
+	}
+}
+
+void JtagReplay::replay_cycles(const uint8_t *tms, uint8_t tms_val,
+		bool end, const uint8_t *tdi, uint8_t tdi_val, bool tdi_valid,
+		uint8_t *tdo, uint32_t len)
+{
+	if (tdo)
+		memset(tdo, 0, (len + 7) / 8);
+
+	for (uint32_t i = 0; i < len; i++, _pos++) {
+		uint8_t tdo_bit = 1;
+		if (_pos < _nb_cycles) {
+			uint8_t tms_bit = (tms) ? get_bit(tms, i) : tms_val;
+			if (end && i == len - 1)
+				tms_bit = 1;
+			bool diff = tms_bit != get_bit(_tms.data(), _pos);
+			if (tdi_valid && get_bit(_tdi_valid.data(), _pos)) {
+				uint8_t tdi_bit = (tdi) ? get_bit(tdi, i) : tdi_val;
+				diff |= tdi_bit != get_bit(_tdi.data(), _pos);
+			}
+			if (diff && _mismatch++ == 0)
+				_first_mismatch = _pos;
+			if (tdo && !get_bit(_tdo_valid.data(), _pos))
+				_tdo_unknown++;
+			tdo_bit = get_bit(_tdo.data(), _pos);
+		} else {
+			/* beyond recorded run */
+			if (_mismatch++ == 0)
+				_first_mismatch = _pos;
+			if (tdo)
+				_tdo_unknown++;
+		}
+		if (tdo && tdo_bit)
+			tdo[i >> 3] |= (1 << (i & 0x07));
+	}
+}
+
+int JtagReplay::setClkFreq(uint32_t clkHZ)
+{
+	_op[JTAG_LOG_SETFREQ]++;
+	_clkHZ = clkHZ;
+	return clkHZ;
+}
+
+int JtagReplay::writeTMS(uint8_t *tms, uint32_t len, bool flush_buffer)
+{
+	(void)flush_buffer;
+	_op[JTAG_LOG_TMS]++;
+	replay_cycles(tms, 0, false, NULL, 0, false, NULL, len);
+	return len;
+}
+
+int JtagReplay::writeTDI(uint8_t *tx, uint8_t *rx, uint32_t len, bool end)
+{
+	_op[JTAG_LOG_TDI]++;
+	replay_cycles(NULL, 0, end, tx, 0, tx != NULL, rx, len);
+	return len;
+}
+
+int JtagReplay::writeTDIv(const jtag_seg_t *segs, uint32_t nb_segs,
+		bool end)
+{
+	_op[JTAG_LOG_TDIV]++;
+	uint32_t last = 0;
+	for (uint32_t i = 0; i < nb_segs; i++)
+		if (segs[i].len != 0)
+			last = i;
+	int ret = 0;
+	for (uint32_t i = 0; i < nb_segs; i++) {
+		const jtag_seg_t &seg = segs[i];
+		if (seg.len == 0)
+			continue;
+		replay_cycles(NULL, 0, end && i == last, seg.tx, seg.fill,
+			true, seg.rx, seg.len);
+		ret += seg.len;
+	}
+	return ret;
+}
+
+bool JtagReplay::writeTMSTDI(const uint8_t *tms, const uint8_t *tdi,
+		uint8_t *tdo, uint32_t len)
+{
+	_op[JTAG_LOG_TMSTDI]++;
+	replay_cycles(tms, 0, false, tdi, 0, true, tdo, len);
+	return true;
+}
+
+int JtagReplay::toggleClk(uint8_t tms, uint8_t tdi, uint32_t clk_len)
+{
+	_op[JTAG_LOG_CLK]++;
+	replay_cycles(NULL, (tms) ? 1 : 0, false, NULL, (tdi) ? 1 : 0, true, NULL,
+		clk_len);
+	return clk_len;
+}
+
+int JtagReplay::flush()
+{
+	_op[JTAG_LOG_FLUSH]++;
+	return 1;
+}
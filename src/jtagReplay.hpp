@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#ifndef SRC_JTAGREPLAY_HPP_
+#define SRC_JTAGREPLAY_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "jtagInterface.hpp"
+#include "jtagRecorder.hpp"
+
+/*!
+ * \file jtagReplay.hpp
+ * \class JtagReplay
+ * \brief probe driver serving TDO from a JtagRecorder log, without hardware.
+ *        The log is flattened as one bit per TCK cycle: TDO is served by
+ *        cycle position, so a caller packing scans differently from the
+ *        recorded run (more/less calls or flushes) still reads the same
+ *        values as long as it produces the same TMS/TDI sequence
+ */
+class JtagReplay: public JtagInterface {
+ public:
+	/*!
+	 * \brief constructor: load the log
+	 * \param[in] filename: log produced by JtagRecorder
+	 * \param[in] verbose: verbose level
+	 */
+	JtagReplay(const std::string &filename, int8_t verbose);
+	/*!
+	 * \brief display replay statistics compared to the recorded run
+	 */
+	~JtagReplay();
+
+	int setClkFreq(uint32_t clkHZ) override;
+	int writeTMS(uint8_t *tms, uint32_t len, bool flush_buffer) override;
+	int writeTDI(uint8_t *tx, uint8_t *rx, uint32_t len, bool end) override;
+	int writeTDIv(const jtag_seg_t *segs, uint32_t nb_segs,
+			bool end) override;
+	bool writeTMSTDI(const uint8_t *tms, const uint8_t *tdi,
+			uint8_t *tdo, uint32_t len) override;
+	int toggleClk(uint8_t tms, uint8_t tdi, uint32_t clk_len) override;
+	int get_buffer_size() override {return _buffer_size;}
+	bool isFull() override {return false;}
+	int flush() override;
+
+ private:
+	/*!
+	 * \brief append recorded cycles
+	 * \param[in] tms: TMS bits (NULL: constant tms_val)
+	 * \param[in] end: TMS high for last cycle
+	 * \param[in] tdi: TDI bits (NULL: tdi_val, or unknown if !tdi_valid)
+	 * \param[in] tdo: TDO bits (NULL: not read)
+	 */
+	void load_cycles(const uint8_t *tms, uint8_t tms_val, bool end,
+			const uint8_t *tdi, uint8_t tdi_val, bool tdi_valid,
+			const uint8_t *tdo, uint32_t len);
+	/*!
+	 * \brief consume len cycles: check TMS/TDI against log and
+	 *        fill tdo with recorded values (1 when unknown)
+	 */
+	void replay_cycles(const uint8_t *tms, uint8_t tms_val, bool end,
+			const uint8_t *tdi, uint8_t tdi_val, bool tdi_valid,
+			uint8_t *tdo, uint32_t len);
+
+	int8_t _verbose;
+	int _buffer_size;
+	/* one bit per TCK cycle */
+	std::vector<uint8_t> _tms;
+	std::vector<uint8_t> _tdi;
+	std::vector<uint8_t> _tdi_valid;
+	std::vector<uint8_t> _tdo;
+	std::vector<uint8_t> _tdo_valid;
+	uint64_t _nb_cycles;   /**< recorded cycles */
+	uint64_t _pos;         /**< replayed cycles */
+	uint64_t _mismatch;    /**< TMS/TDI differences */
+	uint64_t _first_mismatch;
+	uint64_t _tdo_unknown; /**< TDO read but not recorded */
+	/* recorded / replayed call counters */
+	uint32_t _rec_op[JTAG_LOG_NB_OP];
+	uint32_t _op[JTAG_LOG_NB_OP];
+	uint64_t _rec_driver_us;
+	uint64_t _rec_host_us;
+	std::chrono::steady_clock::time_point _start;
+};
+
+#endif  // SRC_JTAGREPLAY_HPP_
@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <deque>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "display.hpp"
+#include "jtag.hpp"
+#include "jtagStream.hpp"
+
+using namespace std::chrono;
+
+#define SLOT_LEN     10    /* bits by slot */
+#define CHUNK_SLOTS  1024  /* slots by shiftDR call */
+#define POLL_MS      1     /* delay between empty sessions */
+
+static inline uint8_t get_bit(const uint8_t *buf, uint32_t pos)
+{
+	return (buf[pos >> 3] >> (pos & 0x07)) & 0x01;
+}
+
+JtagStream::JtagStream(Jtag *jtag, std::function<void()> select,
+		int8_t verbose): _jtag(jtag), _select(select), _verbose(verbose),
+		_skew(0), _tx_bytes(0), _rx_bytes(0), _busy_us(0), _nb_session(0)
+{
+	/* each device in bypass adds one bit between host and FPGA,
+	 * the first slot absorbs this delay
+	 */
+	size_t nb_dev = _jtag->get_devices_list().size();
+	_skew = (nb_dev > 0) ? nb_dev - 1 : 0;
+	if (_skew >= SLOT_LEN)
+		throw std::runtime_error("JTAG stream: too many devices in chain");
+
+	_tx_bits.resize(CHUNK_SLOTS * SLOT_LEN / 8);
+	_rx_bits.resize(CHUNK_SLOTS * SLOT_LEN / 8);
+}
+
+JtagStream::~JtagStream()
+{
+	if (_verbose > 0)
+		display_stats();
+}
+
+uint32_t JtagStream::session(const uint8_t *tx, uint32_t tx_len,
+		uint32_t rx_want)
+{
+	steady_clock::time_point begin = steady_clock::now();
+
+	/* slots are numbered from Capture-DR: data bit i reaches the FPGA
+	 * at cycle i + _skew, TDO bit i is FPGA cycle i
+	 */
+	uint64_t data_idx = 0;
+	int64_t cur_slot = -1;
+	int64_t cur_byte = -1;     // tx byte sent in cur_slot
+	uint32_t tx_pos = 0;       // next tx byte to send
+	uint32_t tx_acked = 0;
+	bool stalled = false, ending = false;
+	/* sent bytes waiting for FPGA ready bit: slot, byte */
+	std::deque<std::pair<uint64_t, uint32_t>> pending;
+
+	_select();
+
+	while (true) {
+		/* last call: one slot to complete the slot in progress and
+		 * leave Shift-DR (devices after FPGA are bypassed while
+		 * moving to Exit1-DR)
+		 */
+		uint32_t nb_slots = (ending) ? 1 : CHUNK_SLOTS;
+		uint32_t nb_bits = nb_slots * SLOT_LEN;
+		memset(_tx_bits.data(), 0, (nb_bits + 7) / 8);
+
+		for (uint32_t i = 0; i < nb_bits; i++) {
+			uint64_t cycle = data_idx + i + _skew;
+			int64_t slot = cycle / SLOT_LEN;
+			uint32_t pos = cycle % SLOT_LEN;
+			if (slot != cur_slot) {
+				cur_slot = slot;
+				cur_byte = -1;
+				/* first slot is ignored by FPGA */
+				if (slot != 0 && !ending && !stalled && tx_pos < tx_len) {
+					cur_byte = tx_pos++;
+					pending.push_back(std::make_pair(slot, cur_byte));
+				}
+			}
+			if (cur_byte < 0)
+				continue;
+			uint8_t bit = (pos == 0) ? 1 :
+				(pos <= 8) ? (tx[cur_byte] >> (pos - 1)) & 0x01 : 0;
+			if (bit)
+				_tx_bits[i >> 3] |= 1 << (i & 0x07);
+		}
+
+		_jtag->shiftDR(_tx_bits.data(), _rx_bits.data(), nb_bits,
+			(ending) ? Jtag::RUN_TEST_IDLE : Jtag::SHIFT_DR);
+
+		uint32_t got = 0;
+		for (uint32_t j = 0; j < nb_slots; j++) {
+			uint64_t slot = data_idx / SLOT_LEN + j;
+			uint32_t base = j * SLOT_LEN;
+			uint8_t ready = get_bit(_rx_bits.data(), base);
+			if (get_bit(_rx_bits.data(), base + 1)) {
+				uint8_t val = 0;
+				for (int b = 0; b < 8; b++)
+					val |= get_bit(_rx_bits.data(), base + 2 + b) << b;
+				_rx_queue.push_back(val);
+				got++;
+			}
+			if (!pending.empty() && pending.front().first == slot) {
+				/* FPGA drops everything after a refused byte */
+				if (ready && !stalled)
+					tx_acked = pending.front().second + 1;
+				else
+					stalled = true;
+				pending.pop_front();
+			}
+		}
+		_rx_bytes += got;
+		data_idx += nb_bits;
+
+		if (ending)
+			break;
+		bool more_tx = !stalled && tx_pos < tx_len;
+		bool more_rx = got > 0 && _rx_queue.size() < rx_want;
+		if (!more_tx && !more_rx)
+			ending = true;
+	}
+
+	_tx_bytes += tx_acked;
+	_busy_us += duration_cast<microseconds>(steady_clock::now() - begin).count();
+	_nb_session++;
+	return tx_acked;
+}
+
+int JtagStream::write(const uint8_t *data, uint32_t len, uint32_t timeout_ms)
+{
+	uint32_t sent = 0;
+	steady_clock::time_point last = steady_clock::now();
+
+	while (sent < len) {
+		uint32_t acked = session(data + sent, len - sent, 0);
+		if (acked != 0) {
+			sent += acked;
+			last = steady_clock::now();
+			continue;
+		}
+		if (duration_cast<milliseconds>(steady_clock::now() - last).count() >=
+				timeout_ms) {
+			printWarn("JTAG stream: write timeout");
+			break;
+		}
+		std::this_thread::sleep_for(milliseconds(POLL_MS));
+	}
+	return sent;
+}
+
+int JtagStream::read(uint8_t *data, uint32_t len, uint32_t timeout_ms)
+{
+	steady_clock::time_point last = steady_clock::now();
+
+	while (_rx_queue.size() < len) {
+		size_t before = _rx_queue.size();
+		session(NULL, 0, len);
+		if (_rx_queue.size() != before) {
+			last = steady_clock::now();
+			continue;
+		}
+		if (duration_cast<milliseconds>(steady_clock::now() - last).count() >=
+				timeout_ms)
+			break;
+		std::this_thread::sleep_for(milliseconds(POLL_MS));
+	}
+
+	uint32_t nb = (_rx_queue.size() < len) ? _rx_queue.size() : len;
+	for (uint32_t i = 0; i < nb; i++) {
+		data[i] = _rx_queue.front();
+		_rx_queue.pop_front();
+	}
+	return nb;
+}
+
+double JtagStream::throughput() const
+{
+	if (_busy_us == 0)
+		return 0;
+	return static_cast<double>(_tx_bytes + _rx_bytes) / _busy_us;
+}
+
+void JtagStream::display_stats() const
+{
+	char mess[256];
+	snprintf(mess, sizeof(mess), "JTAG stream: %llu Bytes sent, %llu Bytes "
+		"received in %u transfers, %.3f MB/s (TCK %u Hz: %.3f MB/s max "
+		"by direction)",
+		(unsigned long long)_tx_bytes, (unsigned long long)_rx_bytes,
+		_nb_session, throughput(), _jtag->getClkFreq(),
+		_jtag->getClkFreq() / (SLOT_LEN * 1e6));
+	printInfo(mess);
+}
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#ifndef SRC_JTAGSTREAM_HPP_
+#define SRC_JTAGSTREAM_HPP_
+
+#include <stdint.h>
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "jtag.hpp"
+
+/*!
+ * \file jtagStream.hpp
+ * \class JtagStream
+ * \brief byte stream between host and FPGA through a USER data register
+ *        (see spiOverJtag/jtagStream.v).
+ *        The register is scanned as a continuous sequence of 10 bits
+ *        slots (LSB first), slot boundaries restart at Capture-DR:
+ *        - TDI: valid (1b), data (8b), reserved (1b)
+ *        - TDO: ready (1b), valid (1b), data (8b)
+ *        ready is the FPGA flow control: a valid byte sent in a slot
+ *        without ready is dropped, as all following bytes until next
+ *        Capture-DR, so accepted bytes are always a prefix of sent
+ *        bytes. FPGA ignores the first slot after Capture-DR (bypassed
+ *        devices in the chain delay TDI). A transfer stays in Shift-DR
+ *        as long as there is data to exchange
+ */
+class JtagStream {
+ public:
+	/*!
+	 * \brief constructor
+	 * \param[in] jtag: JTAG chain, FPGA already selected
+	 * \param[in] select: load instruction connecting the stream register
+	 *            between TDI and TDO
+	 * \param[in] verbose: display statistics at the end when > 0
+	 */
+	JtagStream(Jtag *jtag, std::function<void()> select, int8_t verbose);
+	~JtagStream();
+
+	/*!
+	 * \brief send len Bytes, bytes sent by the FPGA meanwhile are kept
+	 *        for read
+	 * \param[in] timeout_ms: max time without any accepted byte
+	 * \return number of Bytes accepted by the FPGA (< len on timeout)
+	 */
+	int write(const uint8_t *data, uint32_t len, uint32_t timeout_ms = 1000);
+
+	/*!
+	 * \brief receive up to len Bytes
+	 * \param[in] timeout_ms: max time without any received byte
+	 * \return number of Bytes read (< len on timeout)
+	 */
+	int read(uint8_t *data, uint32_t len, uint32_t timeout_ms = 1000);
+
+	/*!
+	 * \brief Bytes already received and not read
+	 */
+	size_t available() const {return _rx_queue.size();}
+
+	/*!
+	 * \brief sustained throughput (Bytes in both directions during
+	 *        transfers) in MB/s
+	 */
+	double throughput() const;
+
+	/*!
+	 * \brief display transfered Bytes and throughput
+	 */
+	void display_stats() const;
+
+ private:
+	/*!
+	 * \brief select register, send tx bytes and receive FPGA bytes
+	 *        until nothing left to do, back to Run-Test/Idle
+	 * \param[in] tx: bytes to send (may be NULL)
+	 * \param[in] tx_len: tx length
+	 * \param[in] rx_want: continue while FPGA sends data and less than
+	 *            rx_want Bytes are queued
+	 * \return number of tx Bytes accepted
+	 */
+	uint32_t session(const uint8_t *tx, uint32_t tx_len, uint32_t rx_want);
+
+	Jtag *_jtag;
+	std::function<void()> _select;
+	int8_t _verbose;
+	uint32_t _skew;              /**< TDI delay by bypassed devices (bits) */
+	std::vector<uint8_t> _tx_bits;
+	std::vector<uint8_t> _rx_bits;
+	std::deque<uint8_t> _rx_queue;
+	uint64_t _tx_bytes;          /**< accepted Bytes */
+	uint64_t _rx_bytes;          /**< received Bytes */
+	uint64_t _busy_us;           /**< time spent in sessions */
+	uint32_t _nb_session;
+};
+
+#endif  // SRC_JTAGSTREAM_HPP_
@@ -19,6 +19,7 @@
 #include "mcsParser.hpp"
 #include "progressBar.hpp"
 #include "rawParser.hpp"
+#include "bufferPool.hpp"
 #include "display.hpp"
 #include "part.hpp"
 #include "spiFlash.hpp"
@@ -136,6 +137,12 @@ using namespace std;
 
 #define PUBKEY_LENGTH_BYTES				64			/* length of the public key (MachXO3D) in bytes */
 
+/* MachXO3D internal flash streaming */
+#define XO3D_PAGE_BITS					128			/* one flash page by DR scan */
+#define XO3D_GROUP_PAGES				64			/* pages between two busy checks / compares */
+#define XO3D_IDLE_MIN					16			/* first idle clocks tried after a page */
+#define XO3D_IDLE_MAX					65536		/* above: busy poll after each page */
+
 Lattice::Lattice(Jtag *jtag, const string filename, const string &file_type,
 	Device::prog_type_t prg_type, std::string flash_sector, bool verify, int8_t verbose):
 		Device(jtag, filename, file_type, verify, verbose),
@@ -268,6 +275,23 @@ bool Lattice::program_mem()
 	printInfo("Open file: ", false);
 	printSuccess("DONE");
 
+	/* read ID Code 0xE0 and compare to bitstream before decoding
+	 * configuration data
+	 */
+	if (!_bit.readHeader()) {
+		printError("Failed to read bitstream header");
+		return false;
+	}
+	uint32_t bit_idcode = std::stoul(_bit.getHeaderVal("idcode").c_str(), NULL, 16);
+	uint32_t idcode = idCode();
+	if (idcode != bit_idcode) {
+		char mess[256];
+		snprintf(mess, 256, "mismatch between target's idcode and bitstream idcode\n"
+			"\tbitstream has 0x%08X hardware requires 0x%08x", bit_idcode, idcode);
+		printError(mess);
+		return false;
+	}
+
 	err = _bit.parse();
 
 	printInfo("Parse file: ", false);
@@ -281,17 +305,6 @@ bool Lattice::program_mem()
 	if (_verbose)
 		_bit.displayHeader();
 
-	/* read ID Code 0xE0 and compare to bitstream */
-	uint32_t bit_idcode = std::stoul(_bit.getHeaderVal("idcode").c_str(), NULL, 16);
-	uint32_t idcode = idCode();
-	if (idcode != bit_idcode) {
-		char mess[256];
-		snprintf(mess, 256, "mismatch between target's idcode and bitstream idcode\n"
-			"\tbitstream has 0x%08X hardware requires 0x%08x", bit_idcode, idcode);
-		printError(mess);
-		return false;
-	}
-
 	if (_verbose) {
 		printf("IDCode : %x\n", idcode);
 		displayReadReg(readStatusReg());
@@ -681,20 +694,13 @@ bool Lattice::program_extFlash(unsigned int offset, bool unprotect_flash)
 		return false;
 	}
 
-
-	printInfo("Parse file ", false);
-	if (_bit->parse() == EXIT_FAILURE) {
-		printError("FAIL");
-		delete _bit;
-		return false;
-	} else {
-		printSuccess("DONE");
-	}
-
-	if (_verbose)
-		_bit->displayHeader();
-
+	/* bit file: check idcode from header only */
 	if (_file_extension == "bit") {
+		if (!_bit->readHeader()) {
+			printError("Failed to read bitstream header");
+			delete _bit;
+			return false;
+		}
 		uint32_t bit_idcode = std::stoul(_bit->getHeaderVal("idcode").c_str(), NULL, 16);
 		uint32_t idcode = idCode();
 		if (idcode != bit_idcode) {
@@ -707,6 +713,18 @@ bool Lattice::program_extFlash(unsigned int offset, bool unprotect_flash)
 		}
 	}
 
+	printInfo("Parse file ", false);
+	if (_bit->parse() == EXIT_FAILURE) {
+		printError("FAIL");
+		delete _bit;
+		return false;
+	} else {
+		printSuccess("DONE");
+	}
+
+	if (_verbose)
+		_bit->displayHeader();
+
 	ret = SPIInterface::write(offset, _bit->getData(), _bit->getLength() / 8,
 			unprotect_flash);
 
@@ -787,15 +805,14 @@ bool Lattice::program_flash(unsigned int offset, bool unprotect_flash)
 	return true;
 }
 
-void Lattice::program(unsigned int offset, bool unprotect_flash)
+bool Lattice::program(unsigned int offset, bool unprotect_flash)
 {
 	bool retval = true;
 	if (_mode == FLASH_MODE)
 		retval = program_flash(offset, unprotect_flash);
 	else if (_mode == MEM_MODE)
 		retval = program_mem();
-	if (!retval)
-		throw std::exception();
+	return retval;
 }
 
 /* flash mode :
@@ -906,37 +923,64 @@ uint32_t Lattice::readStatusReg()
 	return reg;
 }
 
+/* commands only selecting a register to read: IR scan may be skipped
+ * when already loaded (see Jtag::shiftIR_cached). Others (enable, erase,
+ * program, refresh, auto increment read...) act on Update-IR and are
+ * always shifted
+ */
+static bool is_read_only_cmd(uint8_t cmd)
+{
+	switch (cmd) {
+	case READ_DEVICE_ID_CODE:
+	case 0xC0:  /* USERCODE */
+	case READ_BUSY_FLAG:
+	case READ_STATUS_REGISTER:
+	case READ_STATUS_REGISTER_1:
+	case READ_FEATURE_ROW:
+	case READ_FEABITS:
+	case READ_ECDSA_PUBKEY0:
+	case READ_ECDSA_PUBKEY1:
+	case READ_ECDSA_PUBKEY2:
+	case READ_ECDSA_PUBKEY3:
+		return true;
+	default:
+		return false;
+	}
+}
+
 bool Lattice::wr_rd(uint8_t cmd,
 					uint8_t *tx, int tx_len,
 					uint8_t *rx, int rx_len,
 					bool verbose)
 {
-	int kXferLen = rx_len;
-	if (tx_len > rx_len)
-		kXferLen = tx_len;
-
-	uint8_t xfer_tx[kXferLen];
-	uint8_t xfer_rx[kXferLen];
-	memset(xfer_tx, 0, kXferLen);
 	int i;
-	if (tx != NULL && tx_len > 0) {
-		for (i = 0; i < tx_len; i++)
-			xfer_tx[i] = tx[i];
-	}
-
-	_jtag->shiftIR(&cmd, NULL, 8, Jtag::PAUSE_IR);
-	if (rx || tx) {
-		_jtag->shiftDR(xfer_tx, (rx) ? xfer_rx : NULL, 8 * kXferLen,
-			Jtag::PAUSE_DR);
-	}
-	if (rx) {
-		if (verbose) {
-			for (i=kXferLen-1; i >= 0; i--)
-				printf("%02x ", xfer_rx[i]);
-			printf("\n");
-		}
-		for (i = 0; i < rx_len; i++)
-			rx[i] = (xfer_rx[i]);
+	if (tx == NULL)
+		tx_len = 0;
+	if (rx == NULL)
+		rx_len = 0;
+	/* tx and rx used in place: common part, then tail of the
+	 * longest one (missing tx bytes are sent as explicit zeros by the
+	 * segment fill value, extra rx are dropped)
+	 */
+	int common = (tx_len < rx_len) ? tx_len : rx_len;
+	int kXferLen = (tx_len > rx_len) ? tx_len : rx_len;
+	jtag_seg_t segs[2] = {
+		{tx, rx, (uint32_t)(8 * common), 0},
+		{(tx_len > common) ? tx + common : NULL,
+			(rx_len > common) ? rx + common : NULL,
+			(uint32_t)(8 * (kXferLen - common)), 0},
+	};
+
+	if (rx && !tx && is_read_only_cmd(cmd))
+		_jtag->shiftIR_cached(&cmd, 8, Jtag::PAUSE_IR);
+	else
+		_jtag->shiftIR(&cmd, NULL, 8, Jtag::PAUSE_IR);
+	if (rx || tx)
+		_jtag->shiftDR(segs, 2, Jtag::PAUSE_DR);
+	if (rx && verbose) {
+		for (i = rx_len - 1; i >= 0; i--)
+			printf("%02x ", rx[i]);
+		printf("\n");
 	}
 	return true;
 }
@@ -1332,8 +1376,8 @@ uint16_t Lattice::getUFMStartPageFromJEDEC(JedParser *_jed, int id)
 int Lattice::spi_put(uint8_t cmd, uint8_t *tx, uint8_t *rx, uint32_t len)
 {
 	int xfer_len = len + 1;
-	uint8_t jtx[xfer_len];
-	uint8_t jrx[xfer_len];
+	BufferPool::Buffer jtx(xfer_len);
+	BufferPool::Buffer jrx(xfer_len);
 
 	jtx[0] = LatticeBitParser::reverseByte(cmd);
 
@@ -1346,7 +1390,7 @@ int Lattice::spi_put(uint8_t cmd, uint8_t *tx, uint8_t *rx, uint32_t len)
 	 * in the same time store each byte
 	 * to next
 	 */
-	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx, 8*xfer_len);
+	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx.data(), 8*xfer_len);
 
 	if (rx != NULL) {
 		for (uint32_t i=0; i < len; i++)
@@ -1358,8 +1402,8 @@ int Lattice::spi_put(uint8_t cmd, uint8_t *tx, uint8_t *rx, uint32_t len)
 int Lattice::spi_put(uint8_t *tx, uint8_t *rx, uint32_t len)
 {
 	int xfer_len = len;
-	uint8_t jtx[xfer_len];
-	uint8_t jrx[xfer_len];
+	BufferPool::Buffer jtx(xfer_len);
+	BufferPool::Buffer jrx(xfer_len);
 
 	if (tx) {
 		for (uint32_t i=0; i < len; i++)
@@ -1370,7 +1414,7 @@ int Lattice::spi_put(uint8_t *tx, uint8_t *rx, uint32_t len)
 	 * in the same time store each byte
 	 * to next
 	 */
-	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx, 8*xfer_len);
+	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx.data(), 8*xfer_len);
 
 	if (rx != NULL) {
 		for (uint32_t i=0; i < len; i++)
@@ -1419,201 +1463,191 @@ int Lattice::spi_wait(uint8_t cmd, uint8_t mask, uint8_t cond,
 
 /*************************** MODS FOR MacXO3D *********************************/
 
-bool Lattice::programFeatureRow_MachXO3D(uint8_t* feature_row)
+bool Lattice::flashProg_MachXO3D(const string &name,
+		const vector<string> &data, bool &late_pages)
 {
-	uint8_t tx[16] = { 0 };
-	uint8_t rx[15] = { 0 };
-
-	for (int i = 0; i < 12; i++)
-		tx[i] = feature_row[i];
-
-	if (_verbose) {
-		printf("\tProgramming feature row: [0x");
-		for (int i = 11; i >= 0; i--) {
-			printf("%02x", feature_row[i]);
-		}
-		printf("]\n");
-	}
-
-	wr_rd(PROG_FEATURE_ROW, tx, 16, NULL, 0);
-	_jtag->set_state(Jtag::RUN_TEST_IDLE);
-	_jtag->toggleClk(2);
-
-	wr_rd(0xff, NULL, 0, NULL, 0);
-	if (!pollBusyFlag())
-		return false;
+	ProgressBar progress("Writing " + name, data.size(), 50, _quiet);
+	uint32_t idle = XO3D_IDLE_MIN;
+	uint8_t rx;
+	size_t line = 0;
 
-	if (_verbose || _verify) {
-		wr_rd(READ_FEATURE_ROW, NULL, 0, rx, 15);
+	/* program time measure with first pages: smallest idle (power of 2)
+	 * after which device is no more busy. Above XO3D_IDLE_MAX: same as
+	 * flashProg
+	 */
+	while (line < data.size()) {
+		bool measure = idle <= XO3D_IDLE_MAX;
+		wr_rd(PROG_CFG_FLASH, (uint8_t *)data[line].c_str(), 16, NULL, 0);
 		_jtag->set_state(Jtag::RUN_TEST_IDLE);
-		_jtag->toggleClk(2);
+		_jtag->toggleClk((measure) ? idle : 1000);
+		progress.display(line++);
+		if (measure) {
+			wr_rd(READ_BUSY_FLAG, NULL, 0, &rx, 1);
+			_jtag->set_state(Jtag::RUN_TEST_IDLE);
+			if (rx == 0)
+				break;
+			idle *= 2;
+		}
+		if (!pollBusyFlag())
+			return false;
 	}
+	/* 2x margin */
+	idle *= 2;
+	if (_verbose && line < data.size())
+		printInfo("page program: " + std::to_string(idle) + " idle clocks");
 
-	if (_verbose) {
-		printf("\tReadback Feature Row: [0x");
-		for(int i = 11; i >= 0; i--) {
-			printf("%02x", rx[i]);
+	/* groups of pages: instruction is kept between pages (IR shadow),
+	 * each page is a DR scan followed by idle clocks, without any read,
+	 * so probe buffers are only flushed. Busy flag is checked after
+	 * the last page of the group
+	 */
+	while (line < data.size()) {
+		uint32_t count = (data.size() - line < XO3D_GROUP_PAGES) ?
+			data.size() - line : XO3D_GROUP_PAGES;
+
+		for (uint32_t k = 0; k < count; k++, line++) {
+			wr_rd(PROG_CFG_FLASH, (uint8_t *)data[line].c_str(), 16,
+				NULL, 0);
+			_jtag->set_state(Jtag::RUN_TEST_IDLE);
+			_jtag->toggleClk(idle);
 		}
-		printf("]\n");
-	}
+		progress.display(line - 1);
 
-	if (_verify) {
-		for(int i = 0; i < 15; i++) {
-			if (feature_row[i] != rx[i]) {
-				printf("\tVerify Failed...\n");
+		wr_rd(READ_BUSY_FLAG, NULL, 0, &rx, 1);
+		_jtag->set_state(Jtag::RUN_TEST_IDLE);
+		if (rx != 0) {
+			/* last page not done in time: a page may have been sent
+			 * while device was busy
+			 */
+			if (!pollBusyFlag())
 				return false;
-			}
+			idle *= 2;
+			if (!late_pages)
+				printWarn("\npage program slower than measured: verify forced");
+			late_pages = true;
 		}
 	}
-
+	progress.done();
 	return true;
 }
 
-bool Lattice::programFeabits_MachXO3D(uint32_t feabits)
+bool Lattice::Verify_MachXO3D(const vector<string> &data,
+		uint32_t flash_area)
 {
-	uint8_t tx[4] = { 0 };
-	uint8_t rx[5] = { 0 };
-
-	memset(tx, 0, sizeof(tx));
-	for (int i = 0; i < 4; i++) {
-		tx[i] = (feabits >> (8*i)) & 0xff;
-	}
-
-	if (_verbose) {
-		printf("\tProgramming FEAbits: [0x");
-		for (int i = 3; i >= 0; i--) {
-			printf("%02x", tx[i]);
-		}
-		printf("]\n");
-	}
-
-	wr_rd(PROG_FEABITS, tx, 4, NULL, 0);
+	const size_t page_len = XO3D_PAGE_BITS / 8;
+	vector<uint8_t> pages(XO3D_GROUP_PAGES * page_len);
+	uint8_t dummy[XO3D_PAGE_BITS / 8] = {0};
+
+	uint8_t tx[2] = {
+		(uint8_t)((flash_area >> 8) & 0xff),
+		(uint8_t)((flash_area >> 16) & 0xff)
+	};
+	wr_rd(RESET_CFG_ADDR, tx, 2, NULL, 0);
 	_jtag->set_state(Jtag::RUN_TEST_IDLE);
-	_jtag->toggleClk(2);
-
-	wr_rd(0xff, NULL, 0, NULL, 0);
-	if (!pollBusyFlag())
-		return false;
+	_jtag->toggleClk(1000);
 
-	if (_verbose || _verify) {
-		wr_rd(READ_FEABITS, NULL, 0, rx, 5);
-		_jtag->set_state(Jtag::RUN_TEST_IDLE);
-		_jtag->toggleClk(2);
-	}
+	tx[0] = REG_CFG_FLASH;
+	_jtag->shiftIR(tx, NULL, 8, Jtag::PAUSE_IR);
 
-	if (_verbose) {
-		printf("\tReadback Feabits: [0x");
-		for(int i = 4; i >= 0; i--) {
-			printf("%02x", rx[i]);
+	ProgressBar progress("Verifying", data.size(), 50, _quiet);
+	for (size_t line = 0; line < data.size();) {
+		uint32_t count = (data.size() - line < XO3D_GROUP_PAGES) ?
+			data.size() - line : XO3D_GROUP_PAGES;
+
+		for (uint32_t k = 0; k < count; k++) {
+			_jtag->set_state(Jtag::RUN_TEST_IDLE);
+			_jtag->toggleClk(2);
+			_jtag->shiftDR(dummy, &pages[k * page_len], XO3D_PAGE_BITS,
+				Jtag::PAUSE_DR);
 		}
-		printf("]\n");
-	}
 
-	if (_verify) {
-		for(int i = 0; i < 4; i++) {
-			if (((feabits >> (8*i)) & 0xff) != rx[i]) {
-				printf("\tVerify Failed...\n");
-				return false;
+		for (uint32_t k = 0; k < count; k++, line++) {
+			const string &ref = data[line];
+			const uint8_t *rd = &pages[k * page_len];
+			size_t len = (ref.size() < page_len) ? ref.size() : page_len;
+			if (memcmp(rd, ref.data(), len) == 0)
+				continue;
+			for (size_t i = 0; i < len; i++) {
+				if (rd[i] != (unsigned char)ref[i])
+					printf("%3zu %3zu %02x -> %02x\n", line, i, rd[i],
+						(unsigned char)ref[i]);
 			}
+			printf("Verify Failure\n");
+			progress.fail();
+			return false;
 		}
+		progress.display(line - 1);
 	}
 
+	progress.done();
 	return true;
 }
 
-bool Lattice::programPubKey_MachXO3D(uint8_t* pubkey)
+/* MachXO3D feature row, feabits and public key are written by small
+ * rows (one command each). Rows are programmed back-to-back, with only
+ * a busy wait between them, and read back together at the end: compare
+ * is done once all readbacks are done
+ */
+void Lattice::readRows_MachXO3D(const vector<xo3d_row_t> &rows,
+		vector<uint8_t> &rx)
 {
-	uint8_t rxkey[PUBKEY_LENGTH_BYTES] = { 0 };
-	uint8_t tx[16];
-	int i;
-
-	if (_verbose) {
-		printf("\tProgramming ECDSA PubKey: [");
-		for (i = 0; i < PUBKEY_LENGTH_BYTES; i++) {
-			printf("%02x", pubkey[i]);
-		}
-		printf("]\n");
-	}
-
-	for(i = 0; i < 16; i++) {
-		tx[i] = pubkey[63 - i];
-	}
-	wr_rd(PROG_ECDSA_PUBKEY0, tx, 16, NULL, 0);
-	_jtag->set_state(Jtag::RUN_TEST_IDLE);
-	_jtag->toggleClk(2);
-
-	wr_rd(0xff, NULL, 0, NULL, 0);
-	if (!pollBusyFlag())
-		return false;
-
-	for(i = 0; i < 16; i++) {
-		tx[i] = pubkey[47 - i];
-	}
-	wr_rd(PROG_ECDSA_PUBKEY1, tx, 16, NULL, 0);
-	_jtag->set_state(Jtag::RUN_TEST_IDLE);
-	_jtag->toggleClk(2);
-
-	wr_rd(0xff, NULL, 0, NULL, 0);
-	if (!pollBusyFlag())
-		return false;
-
-	for(i = 0; i < 16; i++) {
-		tx[i] = pubkey[31 - i];
-	}
-	wr_rd(PROG_ECDSA_PUBKEY2, tx, 16, NULL, 0);
-	_jtag->set_state(Jtag::RUN_TEST_IDLE);
-	_jtag->toggleClk(2);
-
-	wr_rd(0xff, NULL, 0, NULL, 0);
-	if (!pollBusyFlag())
-		return false;
-
-	for(i = 0; i < 16; i++) {
-		tx[i] = pubkey[15 - i];
-	}
-	wr_rd(PROG_ECDSA_PUBKEY3, tx, 16, NULL, 0);
-	_jtag->set_state(Jtag::RUN_TEST_IDLE);
-	_jtag->toggleClk(2);
-
-	wr_rd(0xff, NULL, 0, NULL, 0);
-	if (!pollBusyFlag())
-		return false;
-
-	if (_verbose || _verify) {
-		/* read the current feature row */
-		wr_rd(READ_ECDSA_PUBKEY0, NULL, 0, rxkey, 16);
+	size_t pos = 0;
+	rx.assign(rows.size() * XO3D_ROW_MAX_LEN, 0);
+	for (const xo3d_row_t &row : rows) {
+		wr_rd(row.read_cmd, NULL, 0, &rx[pos], row.len);
 		_jtag->set_state(Jtag::RUN_TEST_IDLE);
 		_jtag->toggleClk(2);
+		pos += XO3D_ROW_MAX_LEN;
+	}
+}
 
-		wr_rd(READ_ECDSA_PUBKEY1, NULL, 0, rxkey + 16, 16);
-		_jtag->set_state(Jtag::RUN_TEST_IDLE);
-		_jtag->toggleClk(2);
+bool Lattice::compareRows_MachXO3D(const vector<xo3d_row_t> &rows,
+		const vector<uint8_t> &rx, const string &label)
+{
+	bool same = true;
+	for (size_t r = 0; r < rows.size(); r++) {
+		const xo3d_row_t &row = rows[r];
+		const uint8_t *rd = &rx[r * XO3D_ROW_MAX_LEN];
+		if (_verbose) {
+			printf("%s %s: [0x", label.c_str(), row.name);
+			for (int i = row.len - 1; i >= 0; i--)
+				printf("%02x", rd[i]);
+			printf("]\n");
+		}
+		if (memcmp(row.data, rd, row.len) != 0)
+			same = false;
+	}
+	return same;
+}
 
-		wr_rd(READ_ECDSA_PUBKEY2, NULL, 0, rxkey + 32, 16);
+bool Lattice::programRows_MachXO3D(const vector<xo3d_row_t> &rows)
+{
+	for (const xo3d_row_t &row : rows) {
+		if (_verbose) {
+			printf("\tProgramming %s: [0x", row.name);
+			for (int i = row.len - 1; i >= 0; i--)
+				printf("%02x", row.data[i]);
+			printf("]\n");
+		}
+		/* unused payload bytes are sent low */
+		wr_rd(row.prog_cmd, const_cast<uint8_t *>(row.data), row.xfer_len,
+			NULL, 0);
 		_jtag->set_state(Jtag::RUN_TEST_IDLE);
 		_jtag->toggleClk(2);
 
-		wr_rd(READ_ECDSA_PUBKEY3, NULL, 0, rxkey + 48, 16);
-		_jtag->set_state(Jtag::RUN_TEST_IDLE);
-		_jtag->toggleClk(2);
+		wr_rd(ISC_NOOP, NULL, 0, NULL, 0);
+		if (!pollBusyFlag())
+			return false;
 	}
 
-	if (_verbose) {
-		printf("Readback PubKey: [");
-		for (i=PUBKEY_LENGTH_BYTES-1; i >= 0; i--) {
-			printf("%02x", rxkey[i]);
-			if (i && (i%16 == 0)) printf(" ");
-		}
-		printf("]\n");
-	}
+	if (!_verbose && !_verify)
+		return true;
 
-	if (_verify) {
-		for (int i = 0; i < PUBKEY_LENGTH_BYTES; i++) {
-			if (pubkey[i] != rxkey[PUBKEY_LENGTH_BYTES - i - 1]) {
-				printf("\tVerify Failed...\n");
-				return false;
-			}
-		}
+	vector<uint8_t> rx;
+	readRows_MachXO3D(rows, rx);
+	if (!compareRows_MachXO3D(rows, rx, "\tReadback") && _verify) {
+		printf("\tVerify Failed...\n");
+		return false;
 	}
 
 	return true;
@@ -1622,9 +1656,8 @@ bool Lattice::programPubKey_MachXO3D(uint8_t* pubkey)
 bool Lattice::program_fea_MachXO3D()
 {
 	bool err;
-	uint8_t rx[15] = { 0 };
-	uint8_t tx[16] = { 0 };
-	bool same = true;
+	uint8_t tx[2];
+	bool same;
 
 	FeaParser _fea(_filename, _verbose);
 	printInfo("Open file: ", false);
@@ -1653,43 +1686,21 @@ bool Lattice::program_fea_MachXO3D()
 		printSuccess("DONE");
 	}
 
-	/* read the current feature row */
-	wr_rd(READ_FEATURE_ROW, NULL, 0, rx, 12);
-	_jtag->set_state(Jtag::RUN_TEST_IDLE);
-	_jtag->toggleClk(2);
-
-	if (_verbose) {
-		printf("Read Feature Row: [0x");
-		for(int i = 11; i >= 0; i--) {
-			printf("%02x", rx[i]);
-		}
-		printf("]\n");
-	}
-
-	uint8_t* feature_row = (uint8_t*)_fea.featuresRow();
-	for (int i = 0; i < 12; i++) {
-		if (feature_row[i] != rx[i])
-			same = false;
-	}
-
-	/* read the current FEAbits */
+	/* feature row (96 bits, sent with 128) and feabits, LSB first */
+	vector<xo3d_row_t> rows(2);
+	const uint32_t *features_row = _fea.featuresRow();
 	uint32_t feabits = _fea.feabits();
-	wr_rd(READ_FEABITS, NULL, 0, rx, 6);
-	_jtag->set_state(Jtag::RUN_TEST_IDLE);
-	_jtag->toggleClk(2);
-
-	if (_verbose) {
-		printf("Read Feabits: [0x");
-		for(int i = 4; i >= 0; i--) {
-			printf("%02x", rx[i]);
-		}
-		printf("]\n");
-	}
+	rows[0] = {"Feature Row", PROG_FEATURE_ROW, READ_FEATURE_ROW, {0}, 12, 16};
+	rows[1] = {"Feabits", PROG_FEABITS, READ_FEABITS, {0}, 4, 4};
+	for (int i = 0; i < 12; i++)
+		rows[0].data[i] = (features_row[i / 4] >> (8 * (i % 4))) & 0xff;
+	for (int i = 0; i < 4; i++)
+		rows[1].data[i] = (feabits >> (8 * i)) & 0xff;
 
-	for (int i = 0; i < 4; i++) {
-		if ((feabits >> (i * 8) & 0xff) != rx[i])
-			same = false;
-	}
+	/* read the current feature row and FEAbits */
+	vector<uint8_t> rx;
+	readRows_MachXO3D(rows, rx);
+	same = compareRows_MachXO3D(rows, rx, "Read");
 
 	printf("Feature Row / Feabits Compare: %s\n", same ? "Same" : "Different");
 	if (same == false) {
@@ -1709,18 +1720,9 @@ bool Lattice::program_fea_MachXO3D()
 			printSuccess("DONE");
 		}
 
-		/* FEATURE Row */
-		printInfo("Program Feature Row: ", true);
-		if (!programFeatureRow_MachXO3D(feature_row)) {
-			printError("FAIL");
-			return false;
-		} else {
-			printSuccess("DONE");
-		}
-
-		/* FEAbits */
-		printInfo("Program FEAbits: ", true);
-		if (!programFeabits_MachXO3D(feabits)) {
+		/* FEATURE Row and FEAbits */
+		printInfo("Program Feature Row / FEAbits: ", true);
+		if (!programRows_MachXO3D(rows)) {
 			printError("FAIL");
 			return false;
 		} else {
@@ -1914,36 +1916,63 @@ bool Lattice::program_intFlash_MachXO3D(JedParser& _jed)
 			printSuccess("DONE");
 		}
 
-		if (offset == 0) {
-			/* LSC_INIT_ADDRESS */
-			uint8_t tx[2] = {
-				(uint8_t)((prog_op >> 8) & 0xff),
-				(uint8_t)((prog_op >> 16) & 0xff)
-			};
-			printf("address (I): 0x%x 0x%x\n", tx[0], tx[1]);
-			wr_rd(RESET_CFG_ADDR, tx, 2, NULL, 0);
-		} else {
-			/* LSC_WRITE_ADDRESS */
-			uint8_t tx[3] = {
-				(uint8_t)(prog_op & 0xff),
-				(uint8_t)((prog_op >> 8) & 0xff),
-				(uint8_t)((prog_op >> 16) & 0x03)
-			};
-			printf("address (W): 0x%x 0x%x 0x%x\n", tx[0], tx[1], tx[2]);
-			wr_rd(LSC_WRITE_ADDRESS, tx, 3, NULL, 0);
-		}
-		_jtag->set_state(Jtag::RUN_TEST_IDLE);
-		_jtag->toggleClk(1000);
+		auto set_address = [&]() {
+			if (offset == 0) {
+				/* LSC_INIT_ADDRESS */
+				uint8_t tx[2] = {
+					(uint8_t)((prog_op >> 8) & 0xff),
+					(uint8_t)((prog_op >> 16) & 0xff)
+				};
+				printf("address (I): 0x%x 0x%x\n", tx[0], tx[1]);
+				wr_rd(RESET_CFG_ADDR, tx, 2, NULL, 0);
+			} else {
+				/* LSC_WRITE_ADDRESS */
+				uint8_t tx[3] = {
+					(uint8_t)(prog_op & 0xff),
+					(uint8_t)((prog_op >> 8) & 0xff),
+					(uint8_t)((prog_op >> 16) & 0x03)
+				};
+				printf("address (W): 0x%x 0x%x 0x%x\n", tx[0], tx[1], tx[2]);
+				wr_rd(LSC_WRITE_ADDRESS, tx, 3, NULL, 0);
+			}
+			_jtag->set_state(Jtag::RUN_TEST_IDLE);
+			_jtag->toggleClk(1000);
+		};
+		set_address();
 
 		/* flash CfgFlash */
-		if (false == flashProg(0, area_name, data))
+		bool late_pages = false;
+		if (false == flashProg_MachXO3D(area_name, data, late_pages))
 			return false;
 
-		/* verify write */
-		if (_verify) {
-			if (Verify(data, false, prog_op) == false)
-				return false;
+		/* verify write: always when pages may have been dropped */
+		if (!_verify && !late_pages)
+			continue;
+		if (Verify_MachXO3D(data, prog_op))
+			continue;
+		if (!late_pages)
+			return false;
+
+		/* a page can't be programmed again without erase: rewrite area
+		 * with a busy poll after each page
+		 */
+		if (erase_op == 0) {
+			printError("Error: pages dropped while device was busy and " +
+				area_name + " can't be erased alone");
+			return false;
 		}
+		printWarn("Pages dropped while device was busy: rewrite " + area_name);
+		printInfo("Flash erase: ", false);
+		if (flashErase(erase_op) == false) {
+			printError("FAIL");
+			return false;
+		}
+		printSuccess("DONE");
+		set_address();
+		if (!flashProg(0, area_name, data))
+			return false;
+		if (!Verify_MachXO3D(data, prog_op))
+			return false;
 	}
 
 	/* @TODO: missing usercode update */
@@ -1994,7 +2023,7 @@ bool Lattice::program_pubkey_MachXO3D()
 	bool err, same = true;
 	int len, i, j;
 	uint8_t pubkey[PUBKEY_LENGTH_BYTES];
-	uint8_t rxkey[PUBKEY_LENGTH_BYTES];
+	uint8_t rx_reg[4];
 
 	RawParser _pk(_filename, false);
 	printInfo("Open file: ", false);
@@ -2073,36 +2102,23 @@ bool Lattice::program_pubkey_MachXO3D()
 		printSuccess("DONE");
 	}
 
-	/* read the current feature row */
-	wr_rd(READ_ECDSA_PUBKEY0, NULL, 0, rxkey, 16);
-	_jtag->set_state(Jtag::RUN_TEST_IDLE);
-	_jtag->toggleClk(2);
-
-	wr_rd(READ_ECDSA_PUBKEY1, NULL, 0, rxkey + 16, 16);
-	_jtag->set_state(Jtag::RUN_TEST_IDLE);
-	_jtag->toggleClk(2);
-
-	wr_rd(READ_ECDSA_PUBKEY2, NULL, 0, rxkey + 32, 16);
-	_jtag->set_state(Jtag::RUN_TEST_IDLE);
-	_jtag->toggleClk(2);
-
-	wr_rd(READ_ECDSA_PUBKEY3, NULL, 0, rxkey + 48, 16);
-	_jtag->set_state(Jtag::RUN_TEST_IDLE);
-	_jtag->toggleClk(2);
-
-	if (_verbose) {
-		printf("Read PubKey: [");
-		for (j=PUBKEY_LENGTH_BYTES-1; j >= 0; j--) {
-			printf("%02x", rxkey[j]);
-			if (j && (j%16 == 0)) printf(" ");
-		}
-		printf("]\n");
+	/* key is sent by 128 bits rows, last Byte first */
+	const uint8_t prog_cmd[4] = {PROG_ECDSA_PUBKEY0, PROG_ECDSA_PUBKEY1,
+		PROG_ECDSA_PUBKEY2, PROG_ECDSA_PUBKEY3};
+	const uint8_t read_cmd[4] = {READ_ECDSA_PUBKEY0, READ_ECDSA_PUBKEY1,
+		READ_ECDSA_PUBKEY2, READ_ECDSA_PUBKEY3};
+	const char *row_name[4] = {"PubKey0", "PubKey1", "PubKey2", "PubKey3"};
+	vector<xo3d_row_t> rows(4);
+	for (int r = 0; r < 4; r++) {
+		rows[r] = {row_name[r], prog_cmd[r], read_cmd[r], {0}, 16, 16};
+		for (i = 0; i < 16; i++)
+			rows[r].data[i] = pubkey[PUBKEY_LENGTH_BYTES - 1 - (16 * r) - i];
 	}
 
-	for (int i = 0; i < PUBKEY_LENGTH_BYTES; i++) {
-		if (pubkey[i] != rxkey[PUBKEY_LENGTH_BYTES - i - 1])
-			same = false;
-	}
+	/* read the current public key */
+	vector<uint8_t> rx;
+	readRows_MachXO3D(rows, rx);
+	same = compareRows_MachXO3D(rows, rx, "Read");
 
 	printf("PubKey Compare: %s\n", same ? "Same" : "Different");
 	if (same == false) {
@@ -2126,7 +2142,7 @@ bool Lattice::program_pubkey_MachXO3D()
 
 		/* Public Key */
 		printInfo("Program Public Key: ", true);
-		if (!programPubKey_MachXO3D(pubkey)) {
+		if (!programRows_MachXO3D(rows)) {
 			printError("FAIL");
 			return false;
 		}
@@ -2152,11 +2168,11 @@ bool Lattice::program_pubkey_MachXO3D()
 	wr_rd(ISC_NOOP, NULL, 0, NULL, 0);
 
 	if (_verbose) {
-		wr_rd(READ_STATUS_REGISTER_1, NULL, 0, rxkey, 4);
+		wr_rd(READ_STATUS_REGISTER_1, NULL, 0, rx_reg, 4);
 		_jtag->set_state(Jtag::RUN_TEST_IDLE);
 		_jtag->toggleClk(2);
 
-		printf("Auth Mode: [%s] (0x%x)\n", (rxkey[1] & 0x03 ? "ECDSA Signature Verification" : rxkey[1] & 0x01 ? "HMAC Authentication" : "No Authentication"), rxkey[1] & 0x03);
+		printf("Auth Mode: [%s] (0x%x)\n", (rx_reg[1] & 0x03 ? "ECDSA Signature Verification" : rx_reg[1] & 0x01 ? "HMAC Authentication" : "No Authentication"), rx_reg[1] & 0x03);
 	}
 
 	/* ISC program done 0x5E */
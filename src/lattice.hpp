@@ -26,7 +26,7 @@ class Lattice: public Device, SPIInterface {
 		int idCode() override;
 		int userCode();
 		void reset() override {}
-		void program(unsigned int offset, bool unprotect_flash) override;
+		bool program(unsigned int offset, bool unprotect_flash) override;
 		bool program_mem();
 		bool program_flash(unsigned int offset, bool unprotect_flash);
 		bool Verify(std::vector<std::string> data, bool unlock = false,
@@ -35,6 +35,17 @@ class Lattice: public Device, SPIInterface {
 			return SPIInterface::dump(base_addr, len);
 		}
 
+		/*!
+		 * \brief write partitions with a content different
+		 *        from SPI flash
+		 */
+		bool program_layout(FlashLayout &layout,
+				bool unprotect_flash) override {
+			return SPIInterface::write(layout, unprotect_flash);
+		}
+		void set_verify_repair(bool repair) override {
+			set_spif_repair(repair);
+		}
 		/*!
 		 * \brief protect SPI flash blocks
 		 */
@@ -131,10 +142,61 @@ class Lattice: public Device, SPIInterface {
 		};
 
 		lattice_flash_sector_t _flash_sector;
-		bool programFeatureRow_MachXO3D(uint8_t* feature_row);
-		bool programFeabits_MachXO3D(uint32_t feabits);
-		bool programPubKey_MachXO3D(uint8_t* pubkey);
 
+		/* largest row payload (Bytes) */
+		enum {XO3D_ROW_MAX_LEN = 16};
+		/*!
+		 * \brief feature row, feabits or public key part: data
+		 *        (LSB first) written with one command
+		 */
+		typedef struct {
+			const char *name;
+			uint8_t prog_cmd;                 /**< program command */
+			uint8_t read_cmd;                 /**< readback command */
+			uint8_t data[XO3D_ROW_MAX_LEN];   /**< content, LSB first */
+			int len;                          /**< used Bytes (compared) */
+			int xfer_len;                     /**< Bytes sent with prog_cmd */
+		} xo3d_row_t;
+		/*!
+		 * \brief read all rows (no compare between reads)
+		 * \param[out] rx: XO3D_ROW_MAX_LEN Bytes by row
+		 */
+		void readRows_MachXO3D(const std::vector<xo3d_row_t> &rows,
+				std::vector<uint8_t> &rx);
+		/*!
+		 * \brief compare rows content with readRows_MachXO3D result,
+		 *        display read content when verbose (prefixed by label)
+		 * \return true when all rows are identical
+		 */
+		bool compareRows_MachXO3D(const std::vector<xo3d_row_t> &rows,
+				const std::vector<uint8_t> &rx, const std::string &label);
+		/*!
+		 * \brief program rows back-to-back (busy wait between each),
+		 *        then, with verify/verbose, read all and compare once
+		 * \return false on busy timeout or verify failure
+		 */
+		bool programRows_MachXO3D(const std::vector<xo3d_row_t> &rows);
+
+		/*!
+		 * \brief program flash pages (16 Bytes) at current address:
+		 *        page program time is measured with first pages, then
+		 *        pages are sent by groups, each followed by idle clocks
+		 *        and without read, busy flag being checked after each
+		 *        group only
+		 * \param[out] late_pages: set when device was still busy at
+		 *        a group end (a page may have been dropped): caller
+		 *        must verify and rewrite the area on mismatch
+		 * \return false on busy timeout
+		 */
+		bool flashProg_MachXO3D(const std::string &name,
+				const std::vector<std::string> &data, bool &late_pages);
+		/*!
+		 * \brief read back pages from flash_area start by groups and
+		 *        compare each group once read
+		 * \return false when content differs
+		 */
+		bool Verify_MachXO3D(const std::vector<std::string> &data,
+				uint32_t flash_area);
 		bool program_intFlash_MachXO3D(JedParser& _jed);
 		bool program_fea_MachXO3D();
 		bool program_pubkey_MachXO3D();
@@ -35,6 +35,11 @@ int LatticeBitParser::parseHeader()
 {
 	int currPos = 0;
 
+	if (_raw_data.size() < 8) {
+		printError("Error: file too short");
+		return EXIT_FAILURE;
+	}
+
 	/* check header signature */
 
 	/* radiant .bit start with LSCC */
@@ -90,42 +95,56 @@ int LatticeBitParser::parseHeader()
 	return EXIT_SUCCESS;
 }
 
-int LatticeBitParser::parse()
+bool LatticeBitParser::parseIdcode()
 {
-	/* until 0xFFFFBDB3 0xFFFF */
-	if (parseHeader() < 0)
-		return EXIT_FAILURE;
-
 	/* check preamble */
 	uint32_t preamble = (*(uint32_t *)&_raw_data[_endHeader+1]);
 	if ((preamble != 0xb3bdffff) && (preamble != 0xb3bfffff)) {
 		printError("Error: missing preamble\n");
-		return EXIT_FAILURE;
+		return false;
 	}
 
 	if (preamble == 0xb3bdffff) {
 		/* extract idcode from configuration data (area starting with 0xE2)
 		 * and check compression when machXO2
 		 */
-		if (parseCfgData() == false)
-			return EXIT_FAILURE;
-	} else {  // encrypted bitstream
-		if (_is_machXO2) {
-			printError("encrypted bitstream not supported for machXO2");
-			return EXIT_FAILURE;
-		}
-		string part = getHeaderVal("Part");
-		string subpart = part.substr(0, part.find_last_of("-"));
-		for (auto && fpga : fpga_list) {
-			if (fpga.second.manufacturer != "lattice")
-				continue;
-			string model = fpga.second.model;
-			if (subpart.compare(0, model.size(), model) == 0) {
-				_hdr["idcode"] = string(8, ' ');
-				snprintf(&_hdr["idcode"][0], 9, "%08x", fpga.first);
-			}
+		return parseCfgData();
+	}
+
+	/* encrypted bitstream */
+	if (_is_machXO2) {
+		printError("encrypted bitstream not supported for machXO2");
+		return false;
+	}
+	string part = getHeaderVal("Part");
+	string subpart = part.substr(0, part.find_last_of("-"));
+	for (auto && fpga : fpga_list) {
+		if (fpga.second.manufacturer != "lattice")
+			continue;
+		string model = fpga.second.model;
+		if (subpart.compare(0, model.size(), model) == 0) {
+			_hdr["idcode"] = string(8, ' ');
+			snprintf(&_hdr["idcode"][0], 9, "%08x", fpga.first);
 		}
 	}
+	return true;
+}
+
+bool LatticeBitParser::readHeader()
+{
+	if (parseHeader() != EXIT_SUCCESS)
+		return false;
+	return parseIdcode();
+}
+
+int LatticeBitParser::parse()
+{
+	/* until 0xFFFFBDB3 0xFFFF */
+	if (parseHeader() != EXIT_SUCCESS)
+		return EXIT_FAILURE;
+
+	if (!parseIdcode())
+		return EXIT_FAILURE;
 
 	/* read All data */
 	if (!_is_machXO2) {
@@ -19,6 +19,11 @@ class LatticeBitParser: public ConfigBitstreamParser {
 			bool verbose = false);
 		~LatticeBitParser();
 		int parse() override;
+		/*!
+		 * \brief comments area and idcode (from configuration data
+		 *        VERIFY_ID or from part name for encrypted bitstream)
+		 */
+		bool readHeader() override;
 
 		/*!
 		 * \brief return configuration data with structure similar to jedec
@@ -28,6 +33,10 @@ class LatticeBitParser: public ConfigBitstreamParser {
 
 	private:
 		int parseHeader();
+		/*!
+		 * \brief check preamble and fill idcode
+		 */
+		bool parseIdcode();
 		bool parseCfgData();
 		size_t _endHeader;
 		bool _is_machXO2;
@@ -6,6 +6,8 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <chrono>
+#include <csignal>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -16,24 +18,31 @@
 #include "altera.hpp"
 #include "anlogic.hpp"
 #include "board.hpp"
+#include "boundaryScan.hpp"
+#include "bsdlParser.hpp"
 #include "cable.hpp"
 #include "colognechip.hpp"
+#include "configBitstreamParser.hpp"
 #include "cxxopts.hpp"
 #include "device.hpp"
 #include "dfu.hpp"
 #include "display.hpp"
 #include "efinix.hpp"
+#include "flashLayout.hpp"
 #include "ftdispi.hpp"
 #include "gowin.hpp"
 #include "ice40.hpp"
+#include "jobFile.hpp"
 #include "lattice.hpp"
 #include "libusb_ll.hpp"
 #include "jtag.hpp"
 #include "part.hpp"
+#include "progressBar.hpp"
 #include "spiFlash.hpp"
 #include "rawParser.hpp"
 #include "xilinx.hpp"
 #include "svf_jtag.hpp"
+#include "usbWatch.hpp"
 #ifdef ENABLE_XVC
 #include "xvc_server.hpp"
 #endif
@@ -91,11 +100,35 @@ struct arguments {
 	string interface;
 	string mcufw;
 	bool conmcu;
+	int progress_fd;
+	string flash_layout;
+	string jtag_record;
+	string jtag_replay;
+	bool watch;
+	string job_file;
+	/* boundary scan */
+	vector<string> bsdl;
+	uint32_t bs_sample;
+	vector<string> bs_extest;
+	vector<string> bs_pins;
+	bool verify_repair;
 };
 
 int run_xvc_server(const struct arguments &args, const cable_t &cable,
 	const jtag_pins_conf_t *pins_config);
 
+int run_jtag(const struct arguments &args, const cable_t &cable,
+	jtag_pins_conf_t *pins_config, const JobFile *jobs);
+
+int program_device(const struct arguments &args, Jtag *jtag);
+
+int run_jobs(const struct arguments &args, Jtag *jtag, const JobFile &jobs);
+
+int run_boundary_scan(const struct arguments &args, Jtag *jtag);
+
+int run_watch(const struct arguments &args, const cable_t &cable,
+	jtag_pins_conf_t *pins_config, const JobFile *jobs);
+
 int parse_opt(int argc, char **argv, struct arguments *args,
 	jtag_pins_conf_t *pins_config);
 
@@ -120,6 +153,14 @@ int main(int argc, char **argv)
 			/* xvc server */
 			false, 3721, "-",
 			"", false,  // mcufw conmcu
+			-1,  // progress_fd
+			"",  // flash_layout
+			"", "",  // jtag_record jtag_replay
+			false,  // watch
+			"",  // job_file
+			/* bsdl bs_sample bs_extest bs_pins */
+			{},     0,        {},       {},
+			false,  // verify_repair
 	};
 	/* parse arguments */
 	try {
@@ -130,6 +171,10 @@ int main(int argc, char **argv)
 		return EXIT_FAILURE;
 	}
 
+	/* machine readable progress for external tools */
+	if (args.progress_fd >= 0)
+		ProgressBar::setJsonFd(args.progress_fd);
+
 	if (args.is_list_command) {
 		displaySupported(args);
 		return EXIT_SUCCESS;
@@ -185,6 +230,10 @@ int main(int argc, char **argv)
 			args.freq = board->default_freq;
 	}
 
+	/* JTAG log replay: no hardware */
+	if (!args.jtag_replay.empty())
+		args.cable = "replay";
+
 	if (args.cable[0] == '-') { /* if no board and no cable */
 		printWarn("No cable or board specified: using direct ft2232 interface");
 		args.cable = "ft2232";
@@ -279,7 +328,16 @@ int main(int argc, char **argv)
 					board->reset_pin, board->done_pin, DBUS6, board->oe_pin,
 					args.verify, args.verbose);
 			}
-			if (args.prg_type == Device::RD_FLASH) {
+			if (!args.flash_layout.empty()) {
+				try {
+					FlashLayout layout(args.flash_layout, args.verbose);
+					if (!target->program_layout(layout, args.unprotect_flash))
+						spi_ret = EXIT_FAILURE;
+				} catch (std::exception &e) {
+					printError(e.what());
+					spi_ret = EXIT_FAILURE;
+				}
+			} else if (args.prg_type == Device::RD_FLASH) {
 				if (args.file_size == 0) {
 					printError("Error: 0 size for dump");
 				} else {
@@ -288,7 +346,8 @@ int main(int argc, char **argv)
 			} else if ((args.prg_type == Device::WR_FLASH ||
 						args.prg_type == Device::WR_SRAM) ||
 						!args.bit_file.empty() || !args.file_type.empty()) {
-				target->program(args.offset, args.unprotect_flash);
+				if (!target->program(args.offset, args.unprotect_flash))
+					spi_ret = EXIT_FAILURE;
 			}
 			if (args.unprotect_flash && args.bit_file.empty())
 				if (!target->unprotect_flash())
@@ -309,7 +368,17 @@ int main(int argc, char **argv)
 			SPIFlash flash((SPIInterface *)spi, args.unprotect_flash, args.verbose);
 			flash.display_status_reg();
 
-			if (args.prg_type != Device::RD_FLASH &&
+			if (!args.flash_layout.empty()) {
+				try {
+					FlashLayout layout(args.flash_layout, args.verbose);
+					if (!layout.write(flash, args.verify,
+								args.verify_repair))
+						spi_ret = EXIT_FAILURE;
+				} catch (std::exception &e) {
+					printError(e.what());
+					spi_ret = EXIT_FAILURE;
+				}
+			} else if (args.prg_type != Device::RD_FLASH &&
 					(!args.bit_file.empty() || !args.file_type.empty())) {
 				printInfo("Open file " + args.bit_file + " ", false);
 				try {
@@ -336,8 +405,19 @@ int main(int argc, char **argv)
 					printError("FAIL: " + string(e.what()));
 				}
 
-				if (args.verify)
+				if (args.verify_repair) {
+					std::vector<flash_area_t> bad_areas;
+					if (!flash.verify(args.offset, bit->getData(),
+								bit->getLength() / 8, 0, &bad_areas) &&
+							!bad_areas.empty()) {
+						printWarn("Rewrite mismatched sectors");
+						if (!flash.repair(args.offset, bit->getData(),
+									bit->getLength() / 8, bad_areas))
+							spi_ret = EXIT_FAILURE;
+					}
+				} else if (args.verify) {
 					flash.verify(args.offset, bit->getData(), bit->getLength() / 8);
+				}
 
 				delete bit;
 			} else if (args.prg_type == Device::RD_FLASH) {
@@ -438,16 +518,55 @@ int main(int argc, char **argv)
 	if (args.prg_type == Device::PRG_NONE)
 		args.prg_type = Device::WR_SRAM;
 
+	/* job file: files are read in parallel before opening the cable */
+	JobFile *jobs = NULL;
+	if (!args.job_file.empty()) {
+		try {
+			jobs = new JobFile(args.job_file, args.verbose);
+			jobs->preload();
+		} catch (std::exception &e) {
+			printError(e.what());
+			delete jobs;
+			return EXIT_FAILURE;
+		}
+	}
+
+	int ret;
+	if (args.watch)
+		ret = run_watch(args, cable, &pins_config, jobs);
+	else
+		ret = run_jtag(args, cable, &pins_config, jobs);
+
+	delete jobs;
+	return ret;
+}
+
+int run_jtag(const struct arguments &args, const cable_t &cable,
+	jtag_pins_conf_t *pins_config, const JobFile *jobs)
+{
 	Jtag *jtag;
 	try {
-		jtag = new Jtag(cable, &pins_config, args.device, args.ftdi_serial,
+		jtag = new Jtag(cable, pins_config, args.device, args.ftdi_serial,
 				args.freq, args.verbose, args.ip_adr, args.port,
-				args.invert_read_edge, args.probe_firmware);
+				args.invert_read_edge, args.probe_firmware,
+				args.jtag_record, args.jtag_replay);
 	} catch (std::exception &e) {
 		printError("JTAG init failed with: " + string(e.what()));
 		return EXIT_FAILURE;
 	}
 
+	int ret;
+	if (jobs)
+		ret = run_jobs(args, jtag, *jobs);
+	else
+		ret = program_device(args, jtag);
+
+	delete jtag;
+	return ret;
+}
+
+int program_device(const struct arguments &args, Jtag *jtag)
+{
 	/* chain detection */
 	vector<int> listDev = jtag->get_devices_list();
 	int found = listDev.size();
@@ -478,11 +597,14 @@ int main(int argc, char **argv)
 			}
 		}
 		if (args.detect == true) {
-			delete jtag;
 			return EXIT_SUCCESS;
 		}
 	}
 
+	/* boundary scan: whole chain, no device selection */
+	if (!args.bsdl.empty())
+		return run_boundary_scan(args, jtag);
+
 	if (found != 0) {
 		if (args.index_chain == -1) {
 			for (int i = 0; i < found; i++) {
@@ -493,7 +615,6 @@ int main(int argc, char **argv)
 						printError("Use --index-chain to force selection");
 						for (int i = 0; i < found; i++)
 							printf("0x%08x\n", listDev[i]);
-						delete(jtag);
 						return EXIT_FAILURE;
 					} else {
 						idcode = listDev[i];
@@ -502,16 +623,14 @@ int main(int argc, char **argv)
 			}
 		} else {
 			index = args.index_chain;
-			if (index > found || index < 0) {
+			if (index >= found || index < 0) {
 				printError("wrong index for device in JTAG chain");
-				delete(jtag);
 				return EXIT_FAILURE;
 			}
 			idcode = listDev[index];
 		}
 	} else {
 		printError("Error: no device found");
-		delete(jtag);
 		return EXIT_FAILURE;
 	}
 
@@ -520,9 +639,9 @@ int main(int argc, char **argv)
 	/* detect svf file and program the device */
 	if (!args.file_type.compare("svf") ||
 			args.bit_file.find(".svf") != string::npos) {
-		SVF_jtag *svf = new SVF_jtag(jtag, args.verbose);
+		SVF_jtag svf(jtag, args.verbose);
 		try {
-			svf->parse(args.bit_file);
+			svf.parse(args.bit_file);
 		} catch (std::exception &e) {
 			return EXIT_FAILURE;
 		}
@@ -534,7 +653,6 @@ int main(int argc, char **argv)
 	 */
 	if (fpga_list.find(idcode) == fpga_list.end()) {
 		cerr << "Error: device " << hex << idcode << " not supported" << endl;
-		delete(jtag);
 		return EXIT_FAILURE;
 	}
 
@@ -569,25 +687,41 @@ int main(int argc, char **argv)
 				args.prg_type, args.board, args.cable, args.verify, args.verbose);
 		} else {
 			printError("Error: manufacturer " + fab + " not supported");
-			delete(jtag);
 			return EXIT_FAILURE;
 		}
 	} catch (std::exception &e) {
 		printError("Error: Failed to claim FPGA device: " + string(e.what()));
-		delete(jtag);
 		return EXIT_FAILURE;
 	}
+	fpga->set_verify_repair(args.verify_repair);
 
-	if ((!args.bit_file.empty() ||
+	if (!args.flash_layout.empty()) {
+		bool ret;
+		try {
+			FlashLayout layout(args.flash_layout, args.verbose);
+			ret = fpga->program_layout(layout, args.unprotect_flash);
+		} catch (std::exception &e) {
+			printError(e.what());
+			ret = false;
+		}
+		if (!ret) {
+			printError("Error: Failed to write flash layout");
+			delete(fpga);
+			return EXIT_FAILURE;
+		}
+	} else if ((!args.bit_file.empty() ||
 		 !args.secondary_bit_file.empty() ||
 		 !args.file_type.empty())
 			&& args.prg_type != Device::RD_FLASH) {
+		bool ret;
 		try {
-			fpga->program(args.offset, args.unprotect_flash);
+			ret = fpga->program(args.offset, args.unprotect_flash);
 		} catch (std::exception &e) {
 			printError("Error: Failed to program FPGA: " + string(e.what()));
+			ret = false;
+		}
+		if (!ret) {
 			delete(fpga);
-			delete(jtag);
 			return EXIT_FAILURE;
 		}
 	}
@@ -623,7 +757,243 @@ int main(int argc, char **argv)
 		fpga->reset();
 
 	delete(fpga);
-	delete(jtag);
+
+	return EXIT_SUCCESS;
+}
+
+int run_jobs(const struct arguments &args, Jtag *jtag, const JobFile &jobs)
+{
+	for (auto &job : jobs.jobs()) {
+		/* command line provides cable, verbosity, verify ... */
+		struct arguments job_args = args;
+		job_args.index_chain = job.index;
+		job_args.prg_type = job.prg_type;
+		job_args.bit_file = job.filename;
+		job_args.secondary_bit_file.clear();
+		job_args.file_type = job.file_type;
+		job_args.offset = job.offset;
+		if (!job.fpga_part.empty())
+			job_args.fpga_part = job.fpga_part;
+		job_args.detect = false;
+		job_args.reset = (job.operation == "reset");
+		job_args.flash_layout.clear();
+		job_args.bulk_erase_flash = false;
+		job_args.protect_flash = 0;
+		job_args.conmcu = false;
+		if (job_args.reset)
+			job_args.unprotect_flash = false;
+		/* if no instruction from job -> select load */
+		if (job_args.prg_type == Device::PRG_NONE)
+			job_args.prg_type = Device::WR_SRAM;
+
+		printInfo("Job line " + std::to_string(job.line) + ": " +
+			job.operation + " device " + std::to_string(job.index) +
+			((job.filename.empty()) ? "" : " with " + job.filename));
+		if (program_device(job_args, jtag) != EXIT_SUCCESS) {
+			printError("Error: job line " + std::to_string(job.line) +
+				" failed");
+			return EXIT_FAILURE;
+		}
+	}
+	return EXIT_SUCCESS;
+}
+
+/* boundary scan operations, pins are (device, pin) pairs */
+static int boundary_scan_ops(const struct arguments &args, BoundaryScan &bs)
+{
+	vector<pair<int, int>> pins;
+	int dev, pin;
+	if (args.bs_pins.empty()) {
+		for (auto &d : bs.devices())
+			for (size_t p = 0; d.bsdl && p < d.bsdl->pins().size(); p++)
+				pins.push_back(make_pair(d.index, static_cast<int>(p)));
+	} else {
+		for (const string &name : args.bs_pins) {
+			if (!bs.find_pin(name, &dev, &pin)) {
+				printError("Error: boundary scan: unknown pin " + name);
+				return EXIT_FAILURE;
+			}
+			pins.push_back(make_pair(dev, pin));
+		}
+	}
+
+	if (!args.bs_extest.empty()) {
+		for (const string &drive : args.bs_extest) {
+			size_t eq = drive.find_last_of('=');
+			string val = (eq == string::npos) ? "" : drive.substr(eq + 1);
+			if (val != "0" && val != "1" && val != "z" && val != "Z") {
+				printError("Error: boundary scan: " + drive +
+					" must be pin=0|1|z");
+				return EXIT_FAILURE;
+			}
+			if (!bs.find_pin(drive.substr(0, eq), &dev, &pin)) {
+				printError("Error: boundary scan: unknown pin " +
+					drive.substr(0, eq));
+				return EXIT_FAILURE;
+			}
+			if (!bs.set_pin(dev, pin, (val == "z" || val == "Z") ? -1 :
+					std::stoi(val)))
+				return EXIT_FAILURE;
+		}
+		if (!bs.extest())
+			return EXIT_FAILURE;
+	} else if (args.bs_sample > 1) {
+		vector<uint8_t> captures;
+		auto start = chrono::steady_clock::now();
+		if (!bs.sample_stream(args.bs_sample, captures))
+			return EXIT_FAILURE;
+		double elapsed = chrono::duration<double>(
+			chrono::steady_clock::now() - start).count();
+
+		char mess[256];
+		snprintf(mess, sizeof(mess), "%u captures in %.3f s: %.1f "
+			"captures/s (%d bits each)", args.bs_sample, elapsed,
+			args.bs_sample / elapsed, bs.dr_length());
+		printInfo(mess);
+
+		/* pins activity: transitions between successive captures */
+		const size_t stride = (bs.dr_length() + 7) / 8;
+		for (auto &p : pins) {
+			const string &name =
+				bs.devices()[p.first].bsdl->pins()[p.second].name;
+			int last = bs.get_pin(p.first, p.second, captures.data());
+			if (last == -1)
+				continue;
+			uint32_t toggle = 0;
+			for (uint32_t i = 1; i < args.bs_sample; i++) {
+				int val = bs.get_pin(p.first, p.second, &captures[i * stride]);
+				if (val != last)
+					toggle++;
+				last = val;
+			}
+			printf("%d:%-24s %d %u transitions\n", p.first, name.c_str(),
+				last, toggle);
+		}
+		return EXIT_SUCCESS;
+	} else if (!bs.sample()) {
+		return EXIT_FAILURE;
+	}
+
+	for (auto &p : pins) {
+		const string &name =
+			bs.devices()[p.first].bsdl->pins()[p.second].name;
+		int val = bs.get_pin(p.first, p.second);
+		printf("%d:%-24s %c\n", p.first, name.c_str(),
+			(val == -1) ? '-' : '0' + val);
+	}
+	return EXIT_SUCCESS;
+}
+
+int run_boundary_scan(const struct arguments &args, Jtag *jtag)
+{
+	vector<BsdlParser *> bsdl;
+	int ret = EXIT_FAILURE;
+	try {
+		for (const string &filename : args.bsdl)
+			bsdl.push_back(new BsdlParser(filename, args.verbose));
+		BoundaryScan bs(jtag, bsdl, args.verbose);
+		ret = boundary_scan_ops(args, bs);
+	} catch (std::exception &e) {
+		printError(e.what());
+	}
+	for (BsdlParser *b : bsdl)
+		delete b;
+
+	/* leave EXTEST: devices back to functional mode */
+	if (!args.bs_extest.empty())
+		jtag->go_test_logic_reset();
+	return ret;
+}
+
+static void watch_sigint(int sig)
+{
+	(void)sig;
+	UsbWatch::request_stop();
+	std::signal(SIGINT, SIG_DFL);
+}
+
+int run_watch(const struct arguments &args, const cable_t &cable,
+	jtag_pins_conf_t *pins_config, const JobFile *jobs)
+{
+	if (cable.vid == 0 || cable.pid == 0) {
+		printError("Error: --watch is only for USB probes");
+		return EXIT_FAILURE;
+	}
+	/* bus/device addresses change each time the probe is plugged */
+	if (cable.bus_addr != 0 || cable.device_addr != 0) {
+		printError("Error: --busdev-num can't be used with --watch");
+		return EXIT_FAILURE;
+	}
+
+	/* read (and uncompress) files once: units are programmed without
+	 * accessing them again (stdin is only readable once)
+	 */
+	bool use_file = (!jobs && args.prg_type != Device::RD_FLASH &&
+		args.file_type != "svf" &&
+		args.bit_file.find(".svf") == string::npos);
+	try {
+		if (use_file && (!args.bit_file.empty() || !args.file_type.empty()))
+			ConfigBitstreamParser::preload(args.bit_file);
+		if (use_file && !args.secondary_bit_file.empty())
+			ConfigBitstreamParser::preload(args.secondary_bit_file);
+		if (!args.mcufw.empty())
+			ConfigBitstreamParser::preload(args.mcufw);
+	} catch (std::exception &e) {
+		printError(e.what());
+		return EXIT_FAILURE;
+	}
+
+	UsbWatch *watch;
+	try {
+		watch = new UsbWatch(cable.vid, cable.pid, args.ftdi_serial,
+			args.verbose);
+	} catch (std::exception &e) {
+		printError("USB watch init failed with: " + string(e.what()));
+		return EXIT_FAILURE;
+	}
+
+	/* Ctrl-C: current unit is completed before leaving, a second
+	 * Ctrl-C kills the process
+	 */
+	std::signal(SIGINT, watch_sigint);
+
+	uint32_t nb_unit = 0, nb_fail = 0;
+	char mess[128];
+	while (!UsbWatch::stop_requested()) {
+		printInfo("Waiting for probe (Ctrl-C to stop)");
+		if (!watch->wait_arrival())
+			break;
+
+		nb_unit++;
+		int ret = run_jtag(args, cable, pins_config, jobs);
+		if (ret != EXIT_SUCCESS)
+			nb_fail++;
+		snprintf(mess, sizeof(mess), "unit %u: %s (%u passed, %u failed)",
+			nb_unit, (ret == EXIT_SUCCESS) ? "PASS" : "FAIL",
+			nb_unit - nb_fail, nb_fail);
+		if (ret == EXIT_SUCCESS)
+			printSuccess(mess);
+		else
+			printError(mess);
+
+		printInfo("Unplug probe to continue with next unit");
+		if (!watch->wait_departure())
+			break;
+	}
+	std::signal(SIGINT, SIG_DFL);
+
+	/* leaving without stop request: USB error */
+	bool stopped = UsbWatch::stop_requested();
+	delete watch;
+
+	snprintf(mess, sizeof(mess), "%u units: %u passed, %u failed",
+		nb_unit, nb_unit - nb_fail, nb_fail);
+	if (stopped && nb_fail == 0) {
+		printSuccess(mess);
+		return EXIT_SUCCESS;
+	}
+	printError(mess);
+	return EXIT_FAILURE;
 }
 
 #ifdef ENABLE_XVC
@@ -707,6 +1077,18 @@ int parse_opt(int argc, char **argv, struct arguments *args,
 				cxxopts::value<std::string>(args->secondary_bit_file))
 			("b,board",     "board name, may be used instead of cable",
 				cxxopts::value<string>(args->board))
+			("bsdl", "boundary scan: BSDL files of chain devices (comma "
+				"separated), displays pins state with SAMPLE",
+				cxxopts::value<vector<string>>(args->bsdl))
+			("bs-extest", "boundary scan: drive pins with EXTEST "
+				"(pin=0|1|z comma separated, pin may be prefixed by device "
+				"index: 2:A1=1) and display pins state",
+				cxxopts::value<vector<string>>(args->bs_extest))
+			("bs-pins", "boundary scan: pins to display (default: all)",
+				cxxopts::value<vector<string>>(args->bs_pins))
+			("bs-sample", "boundary scan: number of back-to-back SAMPLE "
+				"captures, displays pins activity when more than one",
+				cxxopts::value<uint32_t>(args->bs_sample))
 			("B,bridge",    "disable spiOverJtag model detection by providing "
 				"bitstream(intel/xilinx)",
 				cxxopts::value<string>(args->bridge_path))
@@ -752,6 +1134,9 @@ int parse_opt(int argc, char **argv, struct arguments *args,
 			("file-type",
 				"provides file type instead of let's deduced by using extension",
 				cxxopts::value<string>(args->file_type))
+			("flash-layout", "write only changed partitions described "
+				"by a manifest (offset length file [sha256] per line)",
+				cxxopts::value<string>(args->flash_layout))
 			("flash-sector", "flash sector (Lattice parts only)",
 				cxxopts::value<string>(args->flash_sector))
 			("fpga-part",   "fpga model flavor + package",
@@ -763,6 +1148,15 @@ int parse_opt(int argc, char **argv, struct arguments *args,
 				cxxopts::value<int>(args->index_chain))
 			("ip", "IP address (XVC and remote bitbang client)",
 				cxxopts::value<string>(args->ip_adr))
+			("job-file", "JTAG mode: run operations listed in this file "
+				"(index operation [file] [key=value]) in one session",
+				cxxopts::value<string>(args->job_file))
+			("jtag-record", "log all JTAG probe accesses (with TDO and "
+				"timings) to this file",
+				cxxopts::value<string>(args->jtag_record))
+			("jtag-replay", "use a JTAG log as probe (no hardware), "
+				"display accesses compared to the recorded run",
+				cxxopts::value<string>(args->jtag_replay))
 			("list-boards", "list all supported boards",
 				cxxopts::value<bool>(args->list_boards))
 			("list-cables", "list all supported cables",
@@ -777,6 +1171,8 @@ int parse_opt(int argc, char **argv, struct arguments *args,
 				cxxopts::value<vector<string>>(pins))
 			("probe-firmware", "firmware for JTAG probe (usbBlasterII)",
 				cxxopts::value<string>(args->probe_firmware))
+			("progress-fd", "write progress as JSON lines to this file descriptor",
+				cxxopts::value<int>(args->progress_fd))
 			("protect-flash",   "protect SPI flash area",
 				cxxopts::value<uint32_t>(args->protect_flash))
 			("quiet", "Produce quiet output (no progress bar)",
@@ -799,6 +1195,12 @@ int parse_opt(int argc, char **argv, struct arguments *args,
 			("h,help", "Give this help list")
 			("verify", "Verify write operation (SPI Flash only)",
 				cxxopts::value<bool>(args->verify))
+			("verify-repair", "Verify write operation and rewrite "
+				"mismatched sectors (SPI Flash only)",
+				cxxopts::value<bool>(args->verify_repair))
+			("watch", "JTAG mode: wait for the probe to be plugged, program "
+				"and loop for next unit (production fixtures)",
+				cxxopts::value<bool>(args->watch))
 #ifdef ENABLE_XVC
 			("xvc",   "Xilinx Virtual Cable Functions",
 				cxxopts::value<bool>(args->xvc))
@@ -837,6 +1239,10 @@ int parse_opt(int argc, char **argv, struct arguments *args,
 			args->verbose = verbose_level;
 		}
 
+		/* repair needs verify to find mismatched sectors */
+		if (args->verify_repair)
+			args->verify = true;
+
 		if (result.count("Version")) {
 			cout << "openFPGALoader " << VERSION << endl;
 			return 1;
@@ -963,9 +1369,16 @@ int parse_opt(int argc, char **argv, struct arguments *args,
 			args->scan_usb)
 			args->is_list_command = true;
 
+		/* a flash layout targets non volatile memory */
+		if (!args->flash_layout.empty())
+			args->prg_type = Device::WR_FLASH;
+
 		if (args->bit_file.empty() &&
 			args->secondary_bit_file.empty() &&
+			args->flash_layout.empty() &&
 			args->file_type.empty() &&
+			args->job_file.empty() &&
+			args->bsdl.empty() &&
 			!args->is_list_command &&
 			!args->detect &&
 			!args->protect_flash &&
@@ -0,0 +1,517 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "altera.hpp"
+#include "anlogic.hpp"
+#include "board.hpp"
+#include "cable.hpp"
+#include "colognechip.hpp"
+#include "configBitstreamParser.hpp"
+#include "device.hpp"
+#include "display.hpp"
+#include "efinix.hpp"
+#include "gowin.hpp"
+#include "jtag.hpp"
+#include "jtagStream.hpp"
+#include "lattice.hpp"
+#include "part.hpp"
+#include "xilinx.hpp"
+
+#include "openfpgaloader.h"
+
+#define DEFAULT_FREQ 	6000000
+
+/* a handle owns the JTAG instance (cable + chain): devices are instantiated
+ * per operation, as done by openFPGALoader. Bitstream buffers are given to
+ * parsers as preloaded content, flash dumps are file based and use a
+ * temporary file
+ */
+struct ofl_ctx {
+	Jtag *jtag;
+	std::string cable;
+	std::string board;
+	std::string fpga_part;
+	int8_t verbose;
+	int index;           /**< selected device, -1: not selected */
+	std::string error;
+	Device *stream_dev;  /**< driver owning stream */
+	JtagStream *stream;  /**< opened by first ofl_stream_xxx */
+	int stream_channel;
+};
+
+static int set_error(ofl_ctx *ctx, const std::string &mess)
+{
+	ctx->error = mess;
+	if (ctx->verbose >= 0)
+		printError(mess);
+	return -1;
+}
+
+/*!
+ * \brief create an empty temporary file with ext extension
+ * \return file path, empty string on error
+ */
+static std::string tmp_file(const std::string &ext)
+{
+#ifdef _WIN32
+	char name[L_tmpnam];
+	if (!tmpnam(name))
+		return "";
+	std::string path = std::string(name) + "." + ext;
+	FILE *fd = fopen(path.c_str(), "wb");
+	if (!fd)
+		return "";
+	fclose(fd);
+	return path;
+#else
+	const char *dir = getenv("TMPDIR");
+	std::string tmpl = std::string((dir) ? dir : "/tmp") +
+		"/openFPGALoader_XXXXXX." + ext;
+	std::vector<char> path(tmpl.begin(), tmpl.end());
+	path.push_back('\0');
+	int fd = mkstemps(path.data(), ext.size() + 1);
+	if (fd < 0)
+		return "";
+	close(fd);
+	return std::string(path.data());
+#endif
+}
+
+static void close_stream(ofl_ctx *ctx)
+{
+	delete ctx->stream;
+	delete ctx->stream_dev;
+	ctx->stream = NULL;
+	ctx->stream_dev = NULL;
+}
+
+/*!
+ * \brief select a device in the chain: the only FPGA when index is -1
+ */
+static int select_device(ofl_ctx *ctx, int index)
+{
+	close_stream(ctx);
+	std::vector<int> listDev = ctx->jtag->get_devices_list();
+	int found = listDev.size();
+
+	if (found == 0)
+		return set_error(ctx, "no device found");
+
+	if (index == -1) {
+		for (int i = 0; i < found; i++) {
+			if (fpga_list.find(listDev[i]) == fpga_list.end())
+				continue;
+			if (index != -1)
+				return set_error(ctx, "more than one FPGA found");
+			index = i;
+		}
+		if (index == -1)
+			return set_error(ctx, "no supported FPGA found");
+	} else if (index >= found || index < 0) {
+		return set_error(ctx, "wrong index for device in JTAG chain");
+	}
+
+	ctx->jtag->device_select(index);
+	ctx->index = index;
+	return 0;
+}
+
+/*!
+ * \brief instantiate device driver for selected device
+ * \return NULL on error (ctx->error filled)
+ */
+static Device *new_device(ofl_ctx *ctx, const std::string &filename,
+		const std::string &file_type, Device::prog_type_t prg_type)
+{
+	/* drivers may reconfigure the TAP (virtual IR, USER register) */
+	close_stream(ctx);
+	if (ctx->index == -1 && select_device(ctx, -1) != 0)
+		return NULL;
+
+	uint32_t idcode = ctx->jtag->get_target_device_id();
+	if (fpga_list.find(idcode) == fpga_list.end()) {
+		char mess[64];
+		snprintf(mess, sizeof(mess), "device 0x%08x not supported", idcode);
+		set_error(ctx, mess);
+		return NULL;
+	}
+
+	std::string fab = fpga_list[idcode].manufacturer;
+	const bool verify = true;
+	/* previous driver may have used this TAP */
+	ctx->jtag->invalidate_ir();
+
+	try {
+		if (fab == "xilinx") {
+			return new Xilinx(ctx->jtag, filename, "", file_type, prg_type,
+				ctx->fpga_part, "", "primary", verify, ctx->verbose,
+				false, false);
+		} else if (fab == "altera") {
+			return new Altera(ctx->jtag, filename, file_type, prg_type,
+				ctx->fpga_part, "", verify, ctx->verbose, false, false);
+		} else if (fab == "anlogic") {
+			return new Anlogic(ctx->jtag, filename, file_type, prg_type,
+				verify, ctx->verbose);
+		} else if (fab == "efinix") {
+			return new Efinix(ctx->jtag, filename, file_type, prg_type,
+				ctx->board, ctx->fpga_part, "", verify, ctx->verbose);
+		} else if (fab == "Gowin") {
+			return new Gowin(ctx->jtag, filename, file_type, "", prg_type,
+				false, verify, ctx->verbose);
+		} else if (fab == "lattice") {
+			return new Lattice(ctx->jtag, filename, file_type, prg_type,
+				"", verify, ctx->verbose);
+		} else if (fab == "colognechip") {
+			return new CologneChip(ctx->jtag, filename, file_type, prg_type,
+				ctx->board, ctx->cable, verify, ctx->verbose);
+		}
+	} catch (std::exception &e) {
+		set_error(ctx, "Failed to claim FPGA device: " + std::string(e.what()));
+		return NULL;
+	}
+
+	set_error(ctx, "manufacturer " + fab + " not supported");
+	return NULL;
+}
+
+/*!
+ * \brief stream with selected device, kept opened between calls
+ * \return NULL on error (ctx->error filled)
+ */
+static JtagStream *get_stream(ofl_ctx *ctx, int channel)
+{
+	if (ctx->stream && ctx->stream_channel == channel)
+		return ctx->stream;
+	close_stream(ctx);
+
+	Device *dev = new_device(ctx, "", "", Device::WR_SRAM);
+	if (!dev)
+		return NULL;
+	ctx->error.clear();
+	try {
+		ctx->stream = dev->open_stream(channel);
+	} catch (std::exception &e) {
+		set_error(ctx, "JTAG stream: " + std::string(e.what()));
+	}
+	if (!ctx->stream) {
+		if (ctx->error.empty())
+			set_error(ctx, "JTAG stream not supported");
+		delete dev;
+		return NULL;
+	}
+	ctx->stream_dev = dev;
+	ctx->stream_channel = channel;
+	return ctx->stream;
+}
+
+extern "C" {
+
+int ofl_api_version(void)
+{
+	return OFL_API_VERSION;
+}
+
+int ofl_open(ofl_ctx **ctx, const char *cable, const char *board,
+		const char *serial, uint32_t freq, int verbose)
+{
+	if (!ctx)
+		return -1;
+	*ctx = NULL;
+
+	ofl_ctx *c = new ofl_ctx;
+	c->jtag = NULL;
+	c->cable = (cable) ? cable : "";
+	c->board = (board) ? board : "";
+	c->verbose = (verbose < -1) ? -1 : ((verbose > 1) ? 1 : verbose);
+	c->index = -1;
+	c->stream_dev = NULL;
+	c->stream = NULL;
+	c->stream_channel = 0;
+
+	jtag_pins_conf_t pins_config = {0, 0, 0, 0};
+
+	/* same cable resolution as openFPGALoader: board provides default
+	 * cable, pins and frequency
+	 */
+	if (!c->board.empty()) {
+		auto b = board_list.find(c->board);
+		if (b == board_list.end()) {
+			set_error(c, "cannot find board '" + c->board + "'");
+			*ctx = c;
+			return -1;
+		}
+		target_board_t *brd = &b->second;
+		pins_config = brd->jtag_pins_config;
+		if (c->cable.empty())
+			c->cable = brd->cable_name;
+		c->fpga_part = brd->fpga_part;
+		if (freq == 0)
+			freq = brd->default_freq;
+	}
+	if (c->cable.empty())
+		c->cable = "ft2232";
+	if (freq == 0)
+		freq = DEFAULT_FREQ;
+
+	auto t = cable_list.find(c->cable);
+	if (t == cable_list.end()) {
+		set_error(c, "cable " + c->cable + " not found");
+		*ctx = c;
+		return -1;
+	}
+	cable_t cbl = t->second;
+	cbl.bus_addr = 0;
+	cbl.device_addr = 0;
+	cbl.config.index = -1;
+	cbl.config.status_pin = -1;
+
+	try {
+		c->jtag = new Jtag(cbl, &pins_config, "", (serial) ? serial : "",
+			freq, c->verbose, "127.0.0.1", 0, false, "");
+	} catch (std::exception &e) {
+		set_error(c, "JTAG init failed with: " + std::string(e.what()));
+		*ctx = c;
+		return -1;
+	}
+
+	*ctx = c;
+	return 0;
+}
+
+void ofl_close(ofl_ctx *ctx)
+{
+	if (!ctx)
+		return;
+	close_stream(ctx);
+	delete ctx->jtag;
+	delete ctx;
+}
+
+const char *ofl_last_error(const ofl_ctx *ctx)
+{
+	if (!ctx)
+		return "no context";
+	return ctx->error.c_str();
+}
+
+int ofl_detect(ofl_ctx *ctx, uint32_t *idcodes, int max_dev)
+{
+	if (!ctx || !ctx->jtag)
+		return -1;
+
+	int found;
+	try {
+		found = ctx->jtag->detectChain(5);
+	} catch (std::exception &e) {
+		return set_error(ctx, "chain detection failed: " +
+			std::string(e.what()));
+	}
+	/* chain may have changed */
+	close_stream(ctx);
+	ctx->index = -1;
+
+	std::vector<int> listDev = ctx->jtag->get_devices_list();
+	for (int i = 0; idcodes && i < found && i < max_dev; i++)
+		idcodes[i] = listDev[i];
+	return found;
+}
+
+int ofl_select(ofl_ctx *ctx, int index)
+{
+	if (!ctx || !ctx->jtag)
+		return -1;
+	return select_device(ctx, index);
+}
+
+int ofl_set_fpga_part(ofl_ctx *ctx, const char *fpga_part)
+{
+	if (!ctx)
+		return -1;
+	ctx->fpga_part = (fpga_part) ? fpga_part : "";
+	return 0;
+}
+
+int ofl_load(ofl_ctx *ctx, const uint8_t *data, size_t len,
+		const char *file_type, int target, uint32_t offset)
+{
+	if (!ctx || !ctx->jtag)
+		return -1;
+	if (!data || len == 0)
+		return set_error(ctx, "empty bitstream");
+	const std::string type = (file_type) ? file_type : "";
+	/* svf player reads the file itself */
+	if (type == "svf")
+		return set_error(ctx, "svf can't be loaded from memory");
+
+	Device::prog_type_t prg_type;
+	if (target == OFL_TARGET_SRAM)
+		prg_type = Device::WR_SRAM;
+	else if (target == OFL_TARGET_FLASH)
+		prg_type = Device::WR_FLASH;
+	else
+		return set_error(ctx, "unknown target");
+
+	/* parsers built by the driver with this name use the buffer
+	 * (no dot: without file_type, type is deduced from content)
+	 */
+	char name[64];
+	snprintf(name, sizeof(name), "ofl_buffer_%p", (void *)ctx);
+	ConfigBitstreamParser::preload(name, data, len);
+
+	int ret = 0;
+	Device *fpga = new_device(ctx, name, type, prg_type);
+	if (!fpga) {
+		ConfigBitstreamParser::unload(name);
+		return -1;
+	}
+
+	try {
+		if (!fpga->program(offset, false))
+			ret = set_error(ctx, "Failed to program FPGA");
+	} catch (std::exception &e) {
+		ret = set_error(ctx, "Failed to program FPGA: " +
+			std::string(e.what()));
+	}
+
+	delete fpga;
+	ConfigBitstreamParser::unload(name);
+	return ret;
+}
+
+int ofl_flash_write(ofl_ctx *ctx, uint32_t offset, const uint8_t *data,
+		size_t len)
+{
+	return ofl_load(ctx, data, len, "bin", OFL_TARGET_FLASH, offset);
+}
+
+int ofl_flash_read(ofl_ctx *ctx, uint32_t offset, uint8_t *data, size_t len)
+{
+	if (!ctx || !ctx->jtag)
+		return -1;
+	if (!data || len == 0)
+		return set_error(ctx, "empty buffer");
+
+	std::string filename = tmp_file("bin");
+	if (filename.empty())
+		return set_error(ctx, "can't create temporary file");
+
+	Device *fpga = new_device(ctx, filename, "bin", Device::RD_FLASH);
+	if (!fpga) {
+		remove(filename.c_str());
+		return -1;
+	}
+
+	int ret = 0;
+	bool dump_ok;
+	try {
+		dump_ok = fpga->dumpFlash(offset, len);
+	} catch (std::exception &e) {
+		ctx->error = e.what();
+		dump_ok = false;
+	}
+	delete fpga;
+
+	if (!dump_ok) {
+		ret = set_error(ctx, "Failed to read flash" +
+			((ctx->error.empty()) ? "" : ": " + ctx->error));
+	} else {
+		std::ifstream in(filename, std::ios::binary);
+		in.read(reinterpret_cast<char *>(data), len);
+		if ((size_t)in.gcount() != len)
+			ret = set_error(ctx, "short flash read");
+	}
+
+	remove(filename.c_str());
+	return ret;
+}
+
+int ofl_shift_ir(ofl_ctx *ctx, const uint8_t *tdi, uint8_t *tdo, int irlen)
+{
+	if (!ctx || !ctx->jtag)
+		return -1;
+	if (!tdi || irlen <= 0)
+		return set_error(ctx, "wrong instruction");
+	if (ctx->index == -1 && select_device(ctx, -1) != 0)
+		return -1;
+
+	std::vector<uint8_t> tx(tdi, tdi + (irlen + 7) / 8);
+	try {
+		ctx->jtag->shiftIR(tx.data(), tdo, irlen);
+	} catch (std::exception &e) {
+		return set_error(ctx, "IR scan failed: " + std::string(e.what()));
+	}
+	return 0;
+}
+
+int ofl_shift_dr(ofl_ctx *ctx, const uint8_t *tdi, uint8_t *tdo, int drlen)
+{
+	if (!ctx || !ctx->jtag)
+		return -1;
+	if (drlen <= 0)
+		return set_error(ctx, "wrong data length");
+	if (ctx->index == -1 && select_device(ctx, -1) != 0)
+		return -1;
+
+	std::vector<uint8_t> tx;
+	if (tdi)
+		tx.assign(tdi, tdi + (drlen + 7) / 8);
+	try {
+		ctx->jtag->shiftDR((tdi) ? tx.data() : NULL, tdo, drlen);
+	} catch (std::exception &e) {
+		return set_error(ctx, "DR scan failed: " + std::string(e.what()));
+	}
+	return 0;
+}
+
+int ofl_stream_write(ofl_ctx *ctx, int channel, const uint8_t *data,
+		size_t len, uint32_t timeout_ms)
+{
+	if (!ctx || !ctx->jtag)
+		return -1;
+	JtagStream *stream = get_stream(ctx, channel);
+	if (!stream)
+		return -1;
+	try {
+		return stream->write(data, len, timeout_ms);
+	} catch (std::exception &e) {
+		return set_error(ctx, "stream write failed: " + std::string(e.what()));
+	}
+}
+
+int ofl_stream_read(ofl_ctx *ctx, int channel, uint8_t *data, size_t len,
+		uint32_t timeout_ms)
+{
+	if (!ctx || !ctx->jtag)
+		return -1;
+	JtagStream *stream = get_stream(ctx, channel);
+	if (!stream)
+		return -1;
+	try {
+		return stream->read(data, len, timeout_ms);
+	} catch (std::exception &e) {
+		return set_error(ctx, "stream read failed: " + std::string(e.what()));
+	}
+}
+
+double ofl_stream_throughput(const ofl_ctx *ctx)
+{
+	if (!ctx || !ctx->stream)
+		return 0;
+	return ctx->stream->throughput();
+}
+
+}  // extern "C"
@@ -0,0 +1,159 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#ifndef SRC_OPENFPGALOADER_H_
+#define SRC_OPENFPGALOADER_H_
+
+/*!
+ * \file openfpgaloader.h
+ * \brief C interface to libopenfpgaloader: keeps cable opened and JTAG
+ *        chain detected between operations. All functions return 0 (or a
+ *        positive value) when success and a negative value on error,
+ *        ofl_last_error() gives the reason
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* bumped when an existing prototype changes */
+#define OFL_API_VERSION 1
+
+/* opaque handle: cable + JTAG chain */
+typedef struct ofl_ctx ofl_ctx;
+
+/* ofl_load targets */
+#define OFL_TARGET_SRAM  0
+#define OFL_TARGET_FLASH 1
+
+/*!
+ * \brief library API version (OFL_API_VERSION used at build time)
+ */
+int ofl_api_version(void);
+
+/*!
+ * \brief open a cable and detect JTAG chain
+ * \param[out] ctx: new handle, to release with ofl_close
+ * \param[in] cable: cable name (see openFPGALoader --list-cables), NULL to
+ *            use board default cable
+ * \param[in] board: board name or NULL
+ * \param[in] serial: FTDI serial number or NULL
+ * \param[in] freq: JTAG clock frequency (Hz), 0 for board/default
+ * \param[in] verbose: -1 quiet, 0 normal, 1 verbose
+ * \return 0 when success. On error ctx is still allocated (if not NULL)
+ *         to query ofl_last_error, and must be released with ofl_close
+ */
+int ofl_open(ofl_ctx **ctx, const char *cable, const char *board,
+		const char *serial, uint32_t freq, int verbose);
+
+/*!
+ * \brief close cable and release handle
+ */
+void ofl_close(ofl_ctx *ctx);
+
+/*!
+ * \brief last error message for this handle ("" if none)
+ */
+const char *ofl_last_error(const ofl_ctx *ctx);
+
+/*!
+ * \brief rescan JTAG chain
+ * \param[out] idcodes: filled with up to max_dev idcodes (may be NULL)
+ * \param[in] max_dev: idcodes capacity
+ * \return number of devices found, negative on error
+ */
+int ofl_detect(ofl_ctx *ctx, uint32_t *idcodes, int max_dev);
+
+/*!
+ * \brief select device used by next operations
+ * \param[in] index: position in the chain, -1 to use the only FPGA found
+ * \return 0 when success
+ */
+int ofl_select(ofl_ctx *ctx, int index);
+
+/*!
+ * \brief set fpga part (package) required to write flash on some devices
+ *        (Xilinx, Altera, Efinix: select the spiOverJtag bridge)
+ */
+int ofl_set_fpga_part(ofl_ctx *ctx, const char *fpga_part);
+
+/*!
+ * \brief load a bitstream from a memory buffer
+ * \param[in] data: bitstream content
+ * \param[in] len: data length (Byte)
+ * \param[in] file_type: bitstream format (bit, bin, rbf, jed, fs, ...),
+ *            NULL to deduce it from content (raw binary when unknown).
+ *            svf is not supported
+ * \param[in] target: OFL_TARGET_SRAM or OFL_TARGET_FLASH
+ * \param[in] offset: flash offset (OFL_TARGET_FLASH only)
+ * \return 0 when success
+ */
+int ofl_load(ofl_ctx *ctx, const uint8_t *data, size_t len,
+		const char *file_type, int target, uint32_t offset);
+
+/*!
+ * \brief write raw data into configuration flash
+ * \return 0 when success
+ */
+int ofl_flash_write(ofl_ctx *ctx, uint32_t offset, const uint8_t *data,
+		size_t len);
+
+/*!
+ * \brief read raw data from configuration flash
+ * \return 0 when success
+ */
+int ofl_flash_read(ofl_ctx *ctx, uint32_t offset, uint8_t *data, size_t len);
+
+/*!
+ * \brief raw instruction register scan on selected device, TAP ends
+ *        in Run-Test/Idle
+ * \param[in] tdi: irlen bits to send (LSB first)
+ * \param[out] tdo: irlen bits read (may be NULL)
+ * \return 0 when success
+ */
+int ofl_shift_ir(ofl_ctx *ctx, const uint8_t *tdi, uint8_t *tdo, int irlen);
+
+/*!
+ * \brief raw data register scan on selected device, TAP ends
+ *        in Run-Test/Idle
+ * \param[in] tdi: drlen bits to send (LSB first, may be NULL)
+ * \param[out] tdo: drlen bits read (may be NULL)
+ * \return 0 when success
+ */
+int ofl_shift_dr(ofl_ctx *ctx, const uint8_t *tdi, uint8_t *tdo, int drlen);
+
+/*!
+ * \brief send data to the selected FPGA through a user data register
+ *        (spiOverJtag/jtagStream.v), bytes sent by the FPGA meanwhile
+ *        are kept for ofl_stream_read
+ * \param[in] channel: Xilinx USER register (3 for xilinx_jtagStream.v),
+ *            not used by Intel devices (virtual JTAG)
+ * \param[in] timeout_ms: max time without any byte accepted by the FPGA
+ * \return number of Bytes accepted, negative on error
+ */
+int ofl_stream_write(ofl_ctx *ctx, int channel, const uint8_t *data,
+		size_t len, uint32_t timeout_ms);
+
+/*!
+ * \brief receive data from the selected FPGA through a user data register
+ * \param[in] timeout_ms: max time without any byte received
+ * \return number of Bytes read, negative on error
+ */
+int ofl_stream_read(ofl_ctx *ctx, int channel, uint8_t *data, size_t len,
+		uint32_t timeout_ms);
+
+/*!
+ * \brief sustained stream throughput (MB/s, both directions)
+ */
+double ofl_stream_throughput(const ofl_ctx *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* SRC_OPENFPGALOADER_H_ */
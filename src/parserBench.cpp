@@ -0,0 +1,742 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+/* parsers micro benchmark: for each supported format a synthetic file
+ * is generated (or an existing file is used) then loaded and parsed
+ * several times. Load (constructor) and parse times, peak RSS and
+ * allocations are reported. Each run is done in a dedicated process
+ * (when fork is available) so peak RSS and static caches don't depend
+ * on previous runs
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "anlogicBitParser.hpp"
+#include "bitparser.hpp"
+#include "checksum.hpp"
+#include "colognechipCfgParser.hpp"
+#include "configBitstreamParser.hpp"
+#include "cxxopts.hpp"
+#include "dfuFileParser.hpp"
+#include "efinixHexParser.hpp"
+#include "feaparser.hpp"
+#include "fsparser.hpp"
+#include "ihexParser.hpp"
+#include "jedParser.hpp"
+#include "latticeBitParser.hpp"
+#include "mcsParser.hpp"
+#include "pofParser.hpp"
+#include "rawParser.hpp"
+#include "xilinxMapParser.hpp"
+
+using namespace std;
+
+/* ---------------------- */
+/*   allocations counter  */
+/* ---------------------- */
+
+static size_t alloc_count = 0;
+static size_t alloc_bytes = 0;
+
+#if defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#elif defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+/* not inlined: compiler must not see malloc/free paired with new/delete */
+BENCH_NOINLINE void *operator new(size_t size)
+{
+	alloc_count++;
+	alloc_bytes += size;
+	void *ptr = malloc((size) ? size : 1);
+	if (!ptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void *operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+BENCH_NOINLINE void operator delete(void *ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+	operator delete(ptr);
+}
+
+/* ---------------------- */
+/*    files generators    */
+/* ---------------------- */
+
+/* xorshift64: reproducible content */
+class Rng {
+ public:
+	Rng(): _state(0x9e3779b97f4a7c15ULL) {}
+	uint64_t next() {
+		_state ^= _state << 13;
+		_state ^= _state >> 7;
+		_state ^= _state << 17;
+		return _state;
+	}
+	void fill(uint8_t *buf, size_t len) {
+		for (size_t i = 0; i < len; i++)
+			buf[i] = static_cast<uint8_t>(next() >> 32);
+	}
+	string bytes(size_t len) {
+		string s(len, 0);
+		fill(reinterpret_cast<uint8_t *>(&s[0]), len);
+		return s;
+	}
+	string bits(size_t len) {
+		string s(len, '0');
+		for (size_t i = 0; i < len; i++)
+			if ((next() >> 40) & 0x01)
+				s[i] = '1';
+		return s;
+	}
+
+ private:
+	uint64_t _state;
+};
+
+static bool write_file(const string &filename, const string &content)
+{
+	ofstream f(filename, ios::binary);
+	f.write(content.data(), content.size());
+	return f.good();
+}
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
+static void append_hex8(string &s, uint8_t v)
+{
+	s += hex_digits[v >> 4];
+	s += hex_digits[v & 0x0f];
+}
+
+static string bits_of(uint64_t val, int len)
+{
+	string s(len, '0');
+	for (int i = 0; i < len; i++)
+		if ((val >> (len - 1 - i)) & 0x01)
+			s[i] = '1';
+	return s;
+}
+
+static void gen_raw(const string &filename, size_t size, Rng &rng)
+{
+	write_file(filename, rng.bytes(size));
+}
+
+/* Xilinx .bit: misc header, a/b/c/d strings, e length and data */
+static void gen_bit(const string &filename, size_t size, Rng &rng)
+{
+	string s;
+	const string magic("\x0f\xf0\x0f\xf0\x0f\xf0\x0f\xf0\x00", 9);
+	s += string("\x00\x09", 2) + magic + string("\x00\x01", 2);
+	const char *fields[] = {"top;UserID=0XFFFFFFFF;Version=2022.2",
+		"7a35tcpg236", "2024/01/01", "12:00:00"};
+	for (int i = 0; i < 4; i++) {
+		size_t len = strlen(fields[i]) + 1;
+		s += static_cast<char>('a' + i);
+		s += static_cast<char>(len >> 8);
+		s += static_cast<char>(len & 0xff);
+		s += string(fields[i], len);
+	}
+	s += 'e';
+	for (int i = 3; i >= 0; i--)
+		s += static_cast<char>((size >> (8 * i)) & 0xff);
+	s += rng.bytes(size);
+	write_file(filename, s);
+}
+
+/* Anlogic .bit: '#' header, empty line, then blocks (16 bits length in
+ * bits + content). First block is short (length MSB must be 0)
+ */
+static void gen_anlogic(const string &filename, size_t size, Rng &rng)
+{
+	string s = "# Tool: TD\n# Device: EG4S20BG256\n\n";
+	size_t len = 8;
+	while (size > 0) {
+		size_t l = min(len, size);
+		s += static_cast<char>((l * 8) >> 8);
+		s += static_cast<char>((l * 8) & 0xff);
+		s += rng.bytes(l);
+		size -= l;
+		len = 552;
+	}
+	write_file(filename, s);
+}
+
+/* Intel hex: 16 Bytes records, extended linear address every 64KB
+ * (mcs) or limited to 64KB without extended address (ihex: MCU
+ * firmwares)
+ */
+static void gen_intel_hex(const string &filename, size_t size, Rng &rng,
+		bool extended)
+{
+	size_t data_len = size * 16 / 44;
+	if (!extended)
+		data_len = min<size_t>(data_len, 0x10000);
+	string s;
+	s.reserve(size + 64);
+	uint8_t data[16];
+	for (size_t addr = 0; addr < data_len; addr += 16) {
+		if (extended && (addr & 0xffff) == 0) {
+			uint8_t sum = 0x02 + 0x04 + (addr >> 24) + ((addr >> 16) & 0xff);
+			s += ":02000004";
+			append_hex8(s, addr >> 24);
+			append_hex8(s, (addr >> 16) & 0xff);
+			append_hex8(s, (~sum + 1) & 0xff);
+			s += "\r\n";
+		}
+		uint8_t len = min<size_t>(16, data_len - addr);
+		rng.fill(data, len);
+		uint8_t sum = len + ((addr >> 8) & 0xff) + (addr & 0xff);
+		s += ':';
+		append_hex8(s, len);
+		append_hex8(s, (addr >> 8) & 0xff);
+		append_hex8(s, addr & 0xff);
+		s += "00";
+		for (int i = 0; i < len; i++) {
+			append_hex8(s, data[i]);
+			sum += data[i];
+		}
+		append_hex8(s, (~sum + 1) & 0xff);
+		s += "\r\n";
+	}
+	s += ":00000001FF\r\n";
+	write_file(filename, s);
+}
+
+static void gen_mcs(const string &filename, size_t size, Rng &rng)
+{
+	gen_intel_hex(filename, size, rng, true);
+}
+
+static void gen_ihex(const string &filename, size_t size, Rng &rng)
+{
+	gen_intel_hex(filename, size, rng, false);
+}
+
+/* one hexadecimal Byte by line, optional comments */
+static void gen_hex_lines(const string &filename, size_t size, Rng &rng,
+		bool comments)
+{
+	string s;
+	s.reserve(size + 64);
+	size_t nb = size / 3;
+	for (size_t i = 0; i < nb; i++) {
+		if (comments && (i % 1024) == 0)
+			s += "// frame " + to_string(i / 1024) + "\n";
+		append_hex8(s, static_cast<uint8_t>(rng.next() >> 32));
+		s += '\n';
+	}
+	write_file(filename, s);
+}
+
+static void gen_efinix(const string &filename, size_t size, Rng &rng)
+{
+	gen_hex_lines(filename, size, rng, false);
+}
+
+static void gen_gatemate(const string &filename, size_t size, Rng &rng)
+{
+	gen_hex_lines(filename, size, rng, true);
+}
+
+/* DFU: payload followed by a 16 Bytes suffix */
+static void gen_dfu(const string &filename, size_t size, Rng &rng)
+{
+	string s = rng.bytes(size);
+	const uint8_t suffix[12] = {0x00, 0x01, 0x14, 0x60, 0x09, 0x12,
+		0x1a, 0x01, 'U', 'F', 'D', 16};
+	s.append(reinterpret_cast<const char *>(suffix), sizeof(suffix));
+	uint32_t crc = CRC32::compute(0xffffffff,
+		reinterpret_cast<const uint8_t *>(s.data()), s.size());
+	for (int i = 0; i < 4; i++)
+		s += static_cast<char>((crc >> (8 * i)) & 0xff);
+	write_file(filename, s);
+}
+
+/* JEDEC: fuses by rows of 128 with fuse checksum */
+static string jed_content(size_t nb_fuses, Rng &rng)
+{
+	const size_t row = 128;
+	nb_fuses = (nb_fuses / row) * row;
+	string fuses = rng.bits(nb_fuses);
+	Sum16 sum;
+	for (size_t i = 0; i < nb_fuses; i += 8) {
+		uint8_t val = 0;
+		for (int b = 0; b < 8; b++)
+			val |= (fuses[i + b] == '1') << b;
+		sum.update(&val, 1);
+	}
+
+	string s = "openFPGALoader bench\n\x02*\nQF" + to_string(nb_fuses) +
+		"*\nF0*\nL0000000\n";
+	s.reserve(nb_fuses + nb_fuses / row + 64);
+	for (size_t i = 0; i < nb_fuses; i += row) {
+		s.append(fuses, i, row);
+		s += '\n';
+	}
+	s += "*\nC";
+	char cs[8];
+	snprintf(cs, sizeof(cs), "%04X", sum.value());
+	s += string(cs) + "*\n\x03" "0000\n";
+	return s;
+}
+
+static void gen_jed(const string &filename, size_t size, Rng &rng)
+{
+	write_file(filename, jed_content(size * 128 / 129, rng));
+}
+
+/* Gowin .fs: ASCII bits lines, header (idcode, options, length) then
+ * configuration lines for a GW2A-18 (1342 lines)
+ */
+static void gen_fs(const string &filename, size_t size, Rng &rng)
+{
+	const int nb_line = 1342;
+	size_t line_len = max<size_t>(((size / nb_line) / 8) * 8, 128);
+	string s = "//Gowin bench\n";
+	s.reserve(size + 1024);
+	s += bits_of((0x06ULL << 56) | 0x0000081b, 64) + "\n";
+	s += bits_of(0x10ULL << 56, 64) + "\n";
+	s += bits_of((0x3bULL << 24) | nb_line, 32) + "\n";
+	for (int i = 0; i < nb_line; i++)
+		s += rng.bits(line_len) + "\n";
+	write_file(filename, s);
+}
+
+/* Lattice ECP5 .bit: comments, preamble, VERIFY_ID then data */
+static void gen_lattice(const string &filename, size_t size, Rng &rng)
+{
+	string s("\xff\x00", 2);
+	s += string("Part: LFE5U-85F-6BG381C", 24);
+	s += string("Date: Jan 01 2024", 18);
+	s += string("\xff\xff\xff\xbd\xb3", 5);
+	s += string("\xe2\x00\x00\x00\x41\x11\x30\x43", 8);
+	s += rng.bytes(size);
+	write_file(filename, s);
+}
+
+/* MachXO3D feature row and feabits */
+static void gen_fea(const string &filename, size_t size, Rng &rng)
+{
+	(void)size;
+	write_file(filename, "Feature Row\n" + rng.bits(96) + "\n" +
+		rng.bits(32) + "*\n");
+}
+
+/* Intel POF: sections (flag, size, content) */
+static void gen_pof(const string &filename, size_t size, Rng &rng)
+{
+	string s("POF\0\0\0\0\0\x06\0\0\0", 12);
+	auto section = [&s](uint16_t flag, const string &content) {
+		s += static_cast<char>(flag & 0xff);
+		s += static_cast<char>(flag >> 8);
+		for (int i = 0; i < 4; i++)
+			s += static_cast<char>((content.size() >> (8 * i)) & 0xff);
+		s += content;
+	};
+	section(0x01, "Quartus Prime");
+	section(0x02, "10M08SAU169C8G");
+	section(0x03, "bench");
+	section(0x11, rng.bytes(size));
+	char sect[128];
+	snprintf(sect, sizeof(sect), "\x01" "CFM0 %zx %zx;\x02" "UFM 0 %x;"
+		"\x03" "ICB 0 %x", size / 2, size / 2, 1024, 64);
+	section(0x1a, string(12, 0) + sect);
+	section(0x08, string("\x12\x34", 2));
+	write_file(filename, s);
+}
+
+/* CoolRunner-II map: one line by column, one field by row, each field
+ * a fuse index or a special bit. Jed with all fuses is filename.jed
+ */
+#define XMAP_NB_COL 1364
+
+static int xmap_nb_row(size_t size)
+{
+	return max<size_t>(size / 6 / XMAP_NB_COL, 1);
+}
+
+static void gen_xmap(const string &filename, size_t size, Rng &rng)
+{
+	const int nb_row = xmap_nb_row(size);
+	string s;
+	s.reserve(size + 1024);
+	int fuse = 0;
+	for (int col = 0; col < XMAP_NB_COL; col++) {
+		for (int row = 0; row < nb_row; row++) {
+			if (row)
+				s += '\t';
+			uint32_t r = (rng.next() >> 32) % 100;
+			if (r < 90)
+				s += to_string(fuse++);
+			else if (r < 94)
+				s += "spare";
+			else if (r < 96)
+				s += "user_" + to_string(r % 32);
+			else if (r < 97)
+				s += "done_0";
+			/* else: transfer bit */
+		}
+		s += '\n';
+	}
+	write_file(filename, s);
+	write_file(filename + ".jed", jed_content(fuse + 128, rng));
+}
+
+/* ---------------------- */
+/*      formats list      */
+/* ---------------------- */
+
+/* parser and objects it depends on */
+typedef struct {
+	std::unique_ptr<ConfigBitstreamParser> aux;
+	std::unique_ptr<ConfigBitstreamParser> parser;
+} bench_parser_t;
+
+typedef struct {
+	string name;
+	string description;
+	function<void(const string &, size_t, Rng &)> generate;
+	function<void(const string &, bench_parser_t &)> create;
+} bench_format_t;
+
+static const vector<bench_format_t> &bench_formats()
+{
+	static const vector<bench_format_t> formats = {
+		{"anlogic", "Anlogic .bit", gen_anlogic,
+			[](const string &f, bench_parser_t &p) {
+				p.parser.reset(new AnlogicBitParser(f, true, false));}},
+		{"bit", "Xilinx .bit", gen_bit,
+			[](const string &f, bench_parser_t &p) {
+				p.parser.reset(new BitParser(f, true, false));}},
+		{"cfg", "Cologne Chip .cfg", gen_gatemate,
+			[](const string &f, bench_parser_t &p) {
+				p.parser.reset(new CologneChipCfgParser(f));}},
+		{"dfu", "DFU file", gen_dfu,
+			[](const string &f, bench_parser_t &p) {
+				p.parser.reset(new DFUFileParser(f, false));}},
+		{"fea", "MachXO3D feature row", gen_fea,
+			[](const string &f, bench_parser_t &p) {
+				p.parser.reset(new FeaParser(f, false));}},
+		{"fs", "Gowin .fs", gen_fs,
+			[](const string &f, bench_parser_t &p) {
+				p.parser.reset(new FsParser(f, true, false));}},
+		{"hex", "Efinix .hex", gen_efinix,
+			[](const string &f, bench_parser_t &p) {
+				p.parser.reset(new EfinixHexParser(f));}},
+		{"ihex", "Intel hex (64KB max)", gen_ihex,
+			[](const string &f, bench_parser_t &p) {
+				p.parser.reset(new IhexParser(f, false, false));}},
+		{"jed", "JEDEC fuses", gen_jed,
+			[](const string &f, bench_parser_t &p) {
+				p.parser.reset(new JedParser(f, false));}},
+		{"lattice", "Lattice .bit", gen_lattice,
+			[](const string &f, bench_parser_t &p) {
+				p.parser.reset(new LatticeBitParser(f, false, false));}},
+		{"mcs", "Xilinx .mcs", gen_mcs,
+			[](const string &f, bench_parser_t &p) {
+				p.parser.reset(new McsParser(f, true, false));}},
+		{"pof", "Intel .pof", gen_pof,
+			[](const string &f, bench_parser_t &p) {
+				p.parser.reset(new POFParser(f, false));}},
+		{"raw", "raw binary", gen_raw,
+			[](const string &f, bench_parser_t &p) {
+				p.parser.reset(new RawParser(f, true));}},
+		/* map size is deduced from file size, jed parse is part of load */
+		{"xmap", "CoolRunner-II map (+ .jed)", gen_xmap,
+			[](const string &f, bench_parser_t &p) {
+				ifstream map(f, ios::binary | ios::ate);
+				int nb_row = xmap_nb_row(map.tellg());
+				JedParser *jed = new JedParser(f + ".jed", false);
+				p.aux.reset(jed);
+				if (jed->parse() != EXIT_SUCCESS)
+					throw std::runtime_error("jed parse failed");
+				p.parser.reset(new XilinxMapParser(f, nb_row, XMAP_NB_COL,
+					jed, 0x12345678, false));}},
+	};
+	return formats;
+}
+
+/* ---------------------- */
+/*        measure         */
+/* ---------------------- */
+
+typedef struct {
+	int ret;             /**< 0: success, 1: parse failed, 2: exception */
+	double load_ms;      /**< file read (constructor) */
+	double parse_ms;
+	long peak_rss_kb;    /**< process peak RSS, -1: unknown */
+	long delta_rss_kb;   /**< peak RSS increase during load and parse */
+	size_t allocs;       /**< operator new calls during parse */
+	size_t alloc_bytes;  /**< Bytes requested during parse */
+	int bit_length;      /**< parse result length (bits) */
+} bench_result_t;
+
+static long peak_rss_kb()
+{
+#ifdef _WIN32
+	return -1;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;  /* Bytes */
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+}
+
+static double ms_since(const chrono::steady_clock::time_point &start)
+{
+	return chrono::duration<double, milli>(
+		chrono::steady_clock::now() - start).count();
+}
+
+static void run_once(const bench_format_t &fmt, const string &filename,
+		bench_result_t &res)
+{
+	memset(&res, 0, sizeof(res));
+	long rss_start = peak_rss_kb();
+	try {
+		bench_parser_t p;
+		auto start = chrono::steady_clock::now();
+		fmt.create(filename, p);
+		res.load_ms = ms_since(start);
+
+		size_t count = alloc_count, bytes = alloc_bytes;
+		start = chrono::steady_clock::now();
+		int ret = p.parser->parse();
+		res.parse_ms = ms_since(start);
+		res.allocs = alloc_count - count;
+		res.alloc_bytes = alloc_bytes - bytes;
+		res.ret = (ret == 0) ? 0 : 1;
+		res.bit_length = p.parser->getLength();
+	} catch (std::exception &e) {
+		fprintf(stderr, "%s: %s\n", fmt.name.c_str(), e.what());
+		res.ret = 2;
+	}
+	res.peak_rss_kb = peak_rss_kb();
+	res.delta_rss_kb = (res.peak_rss_kb < 0) ? -1 :
+		res.peak_rss_kb - rss_start;
+}
+
+/* one run in a child process: fresh heap, RSS high-water mark and
+ * parsers caches
+ */
+static void run_isolated(const bench_format_t &fmt, const string &filename,
+		bench_result_t &res)
+{
+#ifdef _WIN32
+	run_once(fmt, filename, res);
+#else
+	int fds[2];
+	if (pipe(fds) != 0) {
+		run_once(fmt, filename, res);
+		return;
+	}
+	fflush(stdout);
+	pid_t pid = fork();
+	if (pid < 0) {
+		close(fds[0]);
+		close(fds[1]);
+		run_once(fmt, filename, res);
+		return;
+	}
+	if (pid == 0) {
+		close(fds[0]);
+		/* parsers may be verbose */
+		if (!freopen("/dev/null", "w", stdout))
+			_exit(1);
+		run_once(fmt, filename, res);
+		ssize_t len = write(fds[1], &res, sizeof(res));
+		_exit((len == sizeof(res)) ? 0 : 1);
+	}
+	close(fds[1]);
+	ssize_t len = read(fds[0], &res, sizeof(res));
+	close(fds[0]);
+	waitpid(pid, NULL, 0);
+	if (len != sizeof(res)) {
+		memset(&res, 0, sizeof(res));
+		res.ret = 2;
+	}
+#endif
+}
+
+static long file_size(const string &filename)
+{
+	ifstream f(filename, ios::binary | ios::ate);
+	return (f) ? static_cast<long>(f.tellg()) : -1;
+}
+
+int main(int argc, char **argv)
+{
+	size_t size_mb = 8;
+	int iterations = 5;
+	string dir = "/tmp";
+	bool keep = false;
+	vector<string> selected, files;
+
+	try {
+		cxxopts::Options options(argv[0], "parserBench -- bitstream "
+			"parsers micro benchmark",
+			"<gwenhael.goavec-merou@trabucayre.com>");
+		options
+			.positional_help("[FORMAT...]")
+			.show_positional_help();
+
+		options
+			.add_options()
+			("d,dir", "directory for generated files (default /tmp)",
+				cxxopts::value<string>(dir))
+			("f,file", "benchmark an existing file instead of a generated "
+				"one (format=path)",
+				cxxopts::value<vector<string>>(files))
+			("formats", "formats", cxxopts::value<vector<string>>(selected))
+			("h,help", "Give this help list")
+			("k,keep", "keep generated files", cxxopts::value<bool>(keep))
+			("l,list", "list supported formats")
+			("n,iterations", "runs by format (default 5)",
+				cxxopts::value<int>(iterations))
+			("s,size", "generated files size in MB (default 8)",
+				cxxopts::value<size_t>(size_mb));
+		options.parse_positional({"formats"});
+		auto result = options.parse(argc, argv);
+
+		if (result.count("help")) {
+			cout << options.help() << endl;
+			return EXIT_SUCCESS;
+		}
+		if (result.count("list")) {
+			for (const bench_format_t &fmt : bench_formats())
+				printf("%-8s %s\n", fmt.name.c_str(),
+					fmt.description.c_str());
+			return EXIT_SUCCESS;
+		}
+	} catch (const cxxopts::OptionException &e) {
+		cerr << "Error parsing options: " << e.what() << endl;
+		return EXIT_FAILURE;
+	}
+
+	if (iterations < 1)
+		iterations = 1;
+
+	/* (format, file, generated) */
+	vector<pair<const bench_format_t *, pair<string, bool>>> jobs;
+	auto find_format = [](const string &name) -> const bench_format_t * {
+		for (const bench_format_t &fmt : bench_formats())
+			if (fmt.name == name)
+				return &fmt;
+		return NULL;
+	};
+
+	for (const string &f : files) {
+		size_t sep = f.find('=');
+		const bench_format_t *fmt = (sep == string::npos) ? NULL :
+			find_format(f.substr(0, sep));
+		if (!fmt) {
+			cerr << "Error: " << f << ": unknown format (use format=path)"
+				<< endl;
+			return EXIT_FAILURE;
+		}
+		jobs.push_back(make_pair(fmt, make_pair(f.substr(sep + 1), false)));
+	}
+	if (files.empty() && selected.empty())
+		for (const bench_format_t &fmt : bench_formats())
+			selected.push_back(fmt.name);
+	for (const string &name : selected) {
+		const bench_format_t *fmt = find_format(name);
+		if (!fmt) {
+			cerr << "Error: unknown format " << name << endl;
+			return EXIT_FAILURE;
+		}
+		jobs.push_back(make_pair(fmt, make_pair(dir + "/parserBench_" +
+			fmt->name, true)));
+	}
+
+	printf("%-8s %9s %9s %9s %9s %10s %10s %9s %10s\n", "format", "size(MB)",
+		"load(ms)", "parse(ms)", "MB/s", "peak(MB)", "+RSS(MB)", "allocs",
+		"alloc(MB)");
+
+	int errors = 0;
+	for (auto &job : jobs) {
+		const bench_format_t &fmt = *job.first;
+		const string &filename = job.second.first;
+		if (job.second.second) {
+			Rng rng;
+			fmt.generate(filename, size_mb << 20, rng);
+		}
+
+		/* best time of all runs, worst memory usage */
+		bench_result_t best, res;
+		memset(&best, 0, sizeof(best));
+		for (int i = 0; i < iterations; i++) {
+			run_isolated(fmt, filename, res);
+			if (res.ret != 0)
+				break;
+			if (i == 0) {
+				best = res;
+				continue;
+			}
+			best.load_ms = min(best.load_ms, res.load_ms);
+			best.parse_ms = min(best.parse_ms, res.parse_ms);
+			best.peak_rss_kb = max(best.peak_rss_kb, res.peak_rss_kb);
+			best.delta_rss_kb = max(best.delta_rss_kb, res.delta_rss_kb);
+		}
+
+		double size = file_size(filename) / (1024.0 * 1024.0);
+		if (res.ret != 0) {
+			printf("%-8s %9.2f %s\n", fmt.name.c_str(), size,
+				(res.ret == 1) ? "parse failed" : "error");
+			errors++;
+		} else {
+			printf("%-8s %9.2f %9.2f %9.2f %9.1f %10.1f %10.1f %9zu %10.1f\n",
+				fmt.name.c_str(), size, best.load_ms, best.parse_ms,
+				(best.parse_ms > 0) ? size * 1000.0 / best.parse_ms : 0.0,
+				best.peak_rss_kb / 1024.0, best.delta_rss_kb / 1024.0,
+				best.allocs, best.alloc_bytes / (1024.0 * 1024.0));
+		}
+
+		if (job.second.second && !keep) {
+			remove(filename.c_str());
+			if (fmt.name == "xmap")
+				remove((filename + ".jed").c_str());
+		}
+	}
+
+	return (errors) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -42,6 +42,15 @@ int POFParser::getLength(const std::string &section_name)
 	return mem_section[section_name].len;
 }
 
+uint8_t *POFParser::getFlashData(int *len)
+{
+	*len = 0;
+	if (_bit_data.size() <= POF_CFG_HDR_LEN)
+		return NULL;
+	*len = _bit_data.size() - POF_CFG_HDR_LEN;
+	return (uint8_t *)&_bit_data[POF_CFG_HDR_LEN];
+}
+
 void POFParser::displayHeader()
 {
 	ConfigBitstreamParser::displayHeader();
@@ -85,14 +94,19 @@ int POFParser::parse()
 		pos += 2;
 		uint32_t size = ARRAY2INT32((&_raw_data.data()[pos]));
 		pos += 4;
+		if (pos > static_cast<uint32_t>(_file_size) ||
+				size > static_cast<uint32_t>(_file_size) - pos) {
+			printError("POF: packet exceeds file size");
+			return EXIT_FAILURE;
+		}
 		pos += parseSection(flag, pos, size);
 	}
 
 	/* update pointers to memory area */
 	ptr = (uint8_t *)_bit_data.data();
-	mem_section["CFM0"].data = &ptr[mem_section["CFM0"].offset + 0x0C];
-	mem_section["UFM"].data = &ptr[mem_section["UFM"].offset + 0x0C];
-	mem_section["ICB"].data = &ptr[mem_section["ICB"].offset + 0x0C];
+	mem_section["CFM0"].data = &ptr[mem_section["CFM0"].offset + POF_CFG_HDR_LEN];
+	mem_section["UFM"].data = &ptr[mem_section["UFM"].offset + POF_CFG_HDR_LEN];
+	mem_section["ICB"].data = &ptr[mem_section["ICB"].offset + POF_CFG_HDR_LEN];
 
 	return EXIT_SUCCESS;
 }
@@ -132,7 +146,7 @@ uint32_t POFParser::parseSection(uint16_t flag, uint32_t pos, uint32_t size)
 			_hdr["maybeCRC"] = std::to_string(ARRAY2INT16((&_raw_data.data()[pos])));
 			break;
 		case 0x11:  // cfg data
-					// 12 Bytes unknown
+					// POF_CFG_HDR_LEN Bytes unknown
 					// followed by UFM/CFM/DSM data
 			_bit_data.resize(size);
 			std::copy(_raw_data.begin() + pos, _raw_data.begin() + pos + size,
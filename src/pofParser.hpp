@@ -23,6 +23,12 @@
 	(static_cast<uint16_t>(_array_[2] & 0x00ff) << 16) | \
 	(static_cast<uint16_t>(_array_[3] & 0x00ff) << 24))
 
+/* cfg data packet (flag 0x11) starts with 3 x 32bits (not documented,
+ * same size as the flag 0x1A packet header) before the flash content.
+ * Offsets listed in the flag 0x1A packet are relative to the content
+ */
+#define POF_CFG_HDR_LEN 0x0C
+
 /*!
  * \file pofParser.hpp
  * \class POFParser
@@ -50,6 +56,14 @@ class POFParser: public ConfigBitstreamParser {
 		 */
 		int getLength(const std::string &section_name);
 
+		/*!
+		 * \brief return flash content stored in the cfg data packet
+		 *        (packet without its POF_CFG_HDR_LEN Bytes header)
+		 * \param[out] len: content length (Byte)
+		 * \return a pointer, NULL when the file has no flash content
+		 */
+		uint8_t *getFlashData(int *len);
+
 		/**
          * \brief display header informations
          */
@@ -5,30 +5,54 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 #include <chrono>
 #include <string>
 #include "progressBar.hpp"
 #include "display.hpp"
 
+int ProgressBar::_json_fd = -1;
+
 ProgressBar::ProgressBar(const std::string &mess, int maxValue,
 		int progressLen, bool quiet): _mess(mess), _maxValue(maxValue),
-		_progressLen(progressLen), last_time(std::chrono::system_clock::now()),
-		_quiet(quiet), _first(true)
+		_progressLen(progressLen), last_time(std::chrono::steady_clock::now()),
+		_start_time(last_time), _phase_time(last_time),
+		_phase_start(0.0f), _phase_weight(1.0f),
+		_quiet(quiet), _first(true), _show_rate(false), _failed(false)
 {
 }
 
-void ProgressBar::display(int value, char force)
+void ProgressBar::phase(const std::string &mess, int maxValue, float start,
+		float weight)
 {
-	if (_quiet) {
-		if (_first) {
-			printInfo(_mess + ": ", false);
-			_first = false;
+	/* terminate previous phase line */
+	if (!_first) {
+		if (_quiet) {
+			printSuccess("Done");
+		} else {
+			display(_maxValue, true);
+			fputc('\n', stdout);
 		}
-		return;
 	}
+	_mess = mess;
+	_maxValue = maxValue;
+	_phase_start = start;
+	_phase_weight = weight;
+	_phase_time = std::chrono::steady_clock::now();
+	_first = true;
+}
 
-	std::chrono::time_point<std::chrono::system_clock> this_time;
-	this_time = std::chrono::system_clock::now();
+void ProgressBar::display(int value, char force)
+{
+	if (_quiet && _first) {
+		printInfo(_mess + ": ", false);
+		_first = false;
+	}
+	if (_quiet && _json_fd < 0)
+		return;
+
+	std::chrono::time_point<std::chrono::steady_clock> this_time;
+	this_time = std::chrono::steady_clock::now();
 	std::chrono::duration<double> diff = this_time - last_time;
 
 	if (!force && diff.count() < 1)
@@ -36,21 +60,78 @@ void ProgressBar::display(int value, char force)
 		return;
 	}
 	last_time = this_time;
-	float percent = ((float)value * 100.0f)/(float)_maxValue;
+	_first = false;
+
+	if (value > _maxValue)
+		value = _maxValue;
+
+	/* position in the whole operation: a phase covers only a part */
+	float ratio = (_maxValue == 0) ? 1.0f : (float)value / (float)_maxValue;
+	ratio = _phase_start + ratio * _phase_weight;
+	float percent = ratio * 100.0f;
 	float nbEq = (percent * (float) _progressLen)/100.0f;
 
+	/* live throughput for current phase, remaining time from
+	 * elapsed time of the whole operation
+	 */
+	std::chrono::duration<double> phase_elapsed = this_time - _phase_time;
+	std::chrono::duration<double> elapsed = this_time - _start_time;
+	double rate = (phase_elapsed.count() > 0) ?
+		(double)value / phase_elapsed.count() : 0;
+	double eta = -1;
+	if (ratio > 0.0f && ratio < 1.0f)
+		eta = elapsed.count() * (1.0 - ratio) / ratio;
+
+	if (_json_fd >= 0)
+		json(_failed ? "fail" : (ratio >= 1.0f) ? "done" : "running",
+				value, percent, rate, eta);
+	if (_quiet)
+		return;
+
 	printInfo("\r" + _mess + ": [", false);
 	for (int z=0; z < nbEq; z++) {
 		fputc('=', stdout);
 	}
 	fprintf(stdout, "%*s", (int)(_progressLen-nbEq), "");
-	char perc_str[11];
-	snprintf(perc_str, sizeof(perc_str), "] %3.2f%%", percent);
+	char perc_str[64];
+	int len = snprintf(perc_str, sizeof(perc_str), "] %3.2f%%", percent);
+	if (_show_rate && rate > 0) {
+		if (rate >= 1048576)
+			len += snprintf(perc_str + len, sizeof(perc_str) - len,
+					" %.2f MB/s", rate / 1048576);
+		else
+			len += snprintf(perc_str + len, sizeof(perc_str) - len,
+					" %.2f KB/s", rate / 1024);
+	}
+	if (eta >= 0) {
+		int sec = (int)(eta + 0.5);
+		len += snprintf(perc_str + len, sizeof(perc_str) - len,
+				" ETA %d:%02d", sec / 60, sec % 60);
+	}
+	/* clear remaining chars from a previous longer line */
+	snprintf(perc_str + len, sizeof(perc_str) - len, "    ");
 	printInfo(perc_str, false);
 }
+
+void ProgressBar::json(const char *state, int value, float percent,
+		double rate, double eta)
+{
+	char line[512];
+	int len = snprintf(line, sizeof(line),
+			"{\"operation\": \"%s\", \"state\": \"%s\", \"value\": %d, "
+			"\"max\": %d, \"percent\": %.2f, \"rate\": %.0f, \"eta\": %.1f}\n",
+			_mess.c_str(), state, value, _maxValue, percent, rate, eta);
+	if (len > (int)sizeof(line))
+		len = sizeof(line);
+	if (write(_json_fd, line, len) != len)
+		_json_fd = -1;  // stop on broken stream
+}
+
 void ProgressBar::done()
 {
 	if (_quiet) {
+		if (_json_fd >= 0)
+			json("done", _maxValue, 100.0f, 0, 0);
 		printSuccess("Done");
 	} else {
 		display(_maxValue, true);
@@ -59,7 +140,10 @@ void ProgressBar::done()
 }
 void ProgressBar::fail()
 {
+	_failed = true;
 	if (_quiet) {
+		if (_json_fd >= 0)
+			json("fail", _maxValue, 100.0f, 0, -1);
 		printError("Fail");
 	} else {
 		display(_maxValue, true);
@@ -15,14 +15,53 @@ class ProgressBar {
 		void display(int value, char force = 0);
 		void done();
 		void fail();
+
+		/*!
+		 * \brief switch to a new step of a multi-phase operation:
+		 *        the bar, percentage and ETA cover the whole operation
+		 *        and each phase fills its own part of the bar
+		 * \param[in] mess: phase name
+		 * \param[in] maxValue: phase max value (value given to display
+		 *            is relative to the phase)
+		 * \param[in] start: ratio (0.0 - 1.0) of the whole operation
+		 *            already done when this phase starts
+		 * \param[in] weight: ratio (0.0 - 1.0) of the whole operation
+		 *            covered by this phase (from a timing model)
+		 */
+		void phase(const std::string &mess, int maxValue, float start,
+				float weight);
+
+		/*!
+		 * \brief display throughput (values are bytes)
+		 */
+		void showRate(bool show_rate) {_show_rate = show_rate;}
+
+		/*!
+		 * \brief write progress as JSON lines on fd (-1 to disable).
+		 *        Shared by all progress bars, independent of quiet mode
+		 * \param[in] fd: file descriptor
+		 */
+		static void setJsonFd(int fd) {_json_fd = fd;}
+
 	private:
+		void json(const char *state, int value, float percent,
+				double rate, double eta);
+
 		std::string _mess;
 		int _maxValue;
 		int _progressLen;
 		//records the time of last progress bar update
-		std::chrono::time_point<std::chrono::system_clock> last_time;
+		std::chrono::time_point<std::chrono::steady_clock> last_time;
+		//records the time of operation/phase start (rate and ETA)
+		std::chrono::time_point<std::chrono::steady_clock> _start_time;
+		std::chrono::time_point<std::chrono::steady_clock> _phase_time;
+		float _phase_start;
+		float _phase_weight;
 		bool _quiet;
 		bool _first;
+		bool _show_rate;
+		bool _failed;
+		static int _json_fd;
 };
 
 #endif
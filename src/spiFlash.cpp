@@ -13,6 +13,7 @@
 #include <iostream>
 
 #include "progressBar.hpp"
+#include "bufferPool.hpp"
 #include "display.hpp"
 #include "spiFlash.hpp"
 #include "spiFlashdb.hpp"
@@ -80,13 +81,27 @@
 /* Global Block Protection unlock */
 #define FLASH_ULBPR 0x98
 
+/* generic typical timings used when flash model is unknown
+ * or has no timings
+ */
+#define FLASH_DEFAULT_BE64_MS 300
+#define FLASH_DEFAULT_SE_MS   60
+#define FLASH_DEFAULT_PP_US   700
+
 SPIFlash::SPIFlash(SPIInterface *spi, bool unprotect, int8_t verbose):
+	SPIFlash(spi, unprotect, verbose, true)
+{}
+
+SPIFlash::SPIFlash(SPIInterface *spi, bool unprotect, int8_t verbose,
+		bool probe):
 	_spi(spi), _verbose(verbose), _jedec_id(0),
 	_flash_model(NULL), _unprotect(unprotect)
 {
-	reset();
-	power_up();
-	read_id();
+	if (probe) {
+		reset();
+		power_up();
+		read_id();
+	}
 }
 
 int SPIFlash::bulk_erase()
@@ -176,7 +191,7 @@ int SPIFlash::block64_erase(int addr)
 	return 0;
 }
 
-int SPIFlash::sectors_erase(int base_addr, int size)
+int SPIFlash::sectors_erase(int base_addr, int size, ProgressBar *ext_progress)
 {
 
 	// check if chip support sector and subsector erase
@@ -193,11 +208,11 @@ int SPIFlash::sectors_erase(int base_addr, int size)
 	int end_addr = (base_addr + size + 0xfff) & ~0xfff;
 	if (!subsector_rdy)
 		end_addr = (base_addr + size + 0xffff) & ~0xffff;
-	ProgressBar progress("Erasing", end_addr, 50, _verbose < 0);
-	/* start with block size (64Kb) */
-	int step = 0x10000;
-	if (!sector_rdy)
-		step = 0x1000;
+	ProgressBar local_progress("Erasing", end_addr - start_addr, 50,
+			_verbose < 0);
+	ProgressBar *progress = (ext_progress) ? ext_progress : &local_progress;
+	local_progress.showRate(true);
+	int step;
 
 	for (int addr = start_addr; addr < end_addr; addr += step) {
 		if (write_enable() == -1) {
@@ -205,11 +220,16 @@ int SPIFlash::sectors_erase(int base_addr, int size)
 			break;
 		}
 
-		/* if block erase + addr end out of end_addr -> use sector_erase (4Kb) */
-		if (!sector_rdy || (addr + step > end_addr && subsector_rdy)) {
+		/* block erase (64Kb) only when addr is block aligned and the whole
+		 * block is in range, otherwise use sector_erase (4Kb) to avoid
+		 * wiping bytes outside [base_addr, end_addr)
+		 */
+		if (!sector_rdy || (subsector_rdy &&
+				((addr & 0xffff) != 0 || addr + 0x10000 > end_addr))) {
 			step = 0x1000;
 			ret = sector_erase(addr);
 		} else {
+			step = 0x10000;
 			ret = block64_erase(addr);
 		}
 
@@ -220,12 +240,15 @@ int SPIFlash::sectors_erase(int base_addr, int size)
 			ret = -1;
 			break;
 		}
-		progress.display(addr);
+		progress->display(addr - start_addr);
 	}
+	/* with an external progress bar caller is in charge of final state */
+	if (ext_progress)
+		return ret;
 	if (ret == 0)
-		progress.done();
+		local_progress.done();
 	else
-		progress.fail();
+		local_progress.fail();
 
 	return ret;
 }
@@ -244,7 +267,7 @@ int SPIFlash::write_page(int addr, uint8_t *data, int len)
 		write_cmd = FLASH_4PP;
 	}
 
-	uint8_t tx[len+addr_len];
+	BufferPool::Buffer tx(len + addr_len);
 
 	if (write_cmd == FLASH_4PP)
 		tx[i++] = (uint8_t)(0xff & (addr >> 24));
@@ -275,8 +298,8 @@ int SPIFlash::read(int base_addr, uint8_t *data, int len)
 		read_cmd = FLASH_4READ;
 	}
 
-	uint8_t tx[len+addr_len];
-	uint8_t rx[len+addr_len];
+	BufferPool::Buffer tx(len + addr_len);
+	BufferPool::Buffer rx(len + addr_len);
 
 	if (read_cmd == FLASH_4READ)
 		tx[i++] = (uint8_t)(0xff & (base_addr >> 24));
@@ -298,7 +321,7 @@ bool SPIFlash::dump(const std::string &filename, const int &base_addr,
 	if (rd_burst == 0)
 		rd_burst = len;
 
-	/* segfault with buffer > 1M */
+	/* keep bursts in buffer pool biggest class */
 	if (rd_burst > 0x100000)
 		rd_burst = 0x100000;
 
@@ -317,6 +340,7 @@ bool SPIFlash::dump(const std::string &filename, const int &base_addr,
 	}
 
 	ProgressBar progress("Read flash ", len, 50, false);
+	progress.showRate(true);
 	for (int i = 0; i < len; i += rd_burst) {
 		if (rd_burst + i > len)
 			rd_burst = len - i;
@@ -337,7 +361,8 @@ bool SPIFlash::dump(const std::string &filename, const int &base_addr,
 	return true;
 }
 
-int SPIFlash::erase_and_prog(int base_addr, uint8_t *data, int len)
+int SPIFlash::unlock_area(int base_addr, int len, bool *relock,
+		uint8_t *lock_status)
 {
 	if (_jedec_id == 0) {
 		try {
@@ -427,11 +452,46 @@ int SPIFlash::erase_and_prog(int base_addr, uint8_t *data, int len)
 		}
 	}
 
-	/* Now we can erase sector and write new data */
-	ProgressBar progress("Writing", len, 50, _verbose < 0);
-	if (sectors_erase(base_addr, len) == -1)
+	*relock = must_relock;
+	*lock_status = status;
+	return 0;
+}
+
+int SPIFlash::erase_and_prog(int base_addr, uint8_t *data, int len)
+{
+	bool must_relock;  // used to relock after write;
+	uint8_t status;
+	if (unlock_area(base_addr, len, &must_relock, &status) != 0)
+		return -1;
+
+	/* Now we can erase sector and write new data:
+	 * both steps share the same progress bar, each step
+	 * weighted by its expected duration
+	 */
+	float erase_ratio = erase_prog_ratio(base_addr, len);
+	ProgressBar progress("Erasing", len, 50, _verbose < 0);
+	progress.showRate(true);
+	progress.phase("Erasing", len, 0.0f, erase_ratio);
+	if (sectors_erase(base_addr, len, &progress) == -1) {
+		progress.fail();
 		return -1;
+	}
+	progress.phase("Writing", len, erase_ratio, 1.0f - erase_ratio);
+	if (write_pages(base_addr, data, len, progress) == -1)
+		return -1;
+
+	/* and if required: relock blocks */
+	if (must_relock) {
+		enable_protection(status);
+		if (_verbose > 0)
+			display_status_reg(read_status_reg());
+	}
+	return 0;
+}
 
+int SPIFlash::write_pages(int base_addr, uint8_t *data, int len,
+		ProgressBar &progress)
+{
 	uint8_t *ptr = data;
 	int size = 0;
 	for (int addr = 0; addr < len; addr += size, ptr+=size) {
@@ -439,23 +499,18 @@ int SPIFlash::erase_and_prog(int base_addr, uint8_t *data, int len)
 		if ((_jedec_id >> 8) == 0xbf258d) {
 			size = 1;
 		}
-		if (write_page(base_addr + addr, ptr, size) == -1)
+		if (write_page(base_addr + addr, ptr, size) == -1) {
+			progress.fail();
 			return -1;
+		}
 		progress.display(addr);
 	}
 	progress.done();
-
-	/* and if required: relock blocks */
-	if (must_relock) {
-		enable_protection(status);
-		if (_verbose > 0)
-			display_status_reg(read_status_reg());
-	}
 	return 0;
 }
 
 bool SPIFlash::verify(const int &base_addr, const uint8_t *data,
-		const int &len, int rd_burst)
+		const int &len, int rd_burst, std::vector<flash_area_t> *bad_areas)
 {
 	if (rd_burst == 0) {
 		rd_burst = len;
@@ -468,7 +523,14 @@ bool SPIFlash::verify(const int &base_addr, const uint8_t *data,
 	std::string verify_data;
 	verify_data.resize(rd_burst);
 
+	/* mismatches are tracked with erase granularity: this is the
+	 * smallest area that can be rewritten
+	 */
+	const uint32_t sect_size = erase_granularity();
+	std::vector<flash_area_t> areas;
+
 	ProgressBar progress("Read flash ", len, 50, false);
+	progress.showRate(true);
 	for (int i = 0; i < len; i += rd_burst) {
 		if (rd_burst + i > len)
 			rd_burst = len - i;
@@ -478,23 +540,104 @@ bool SPIFlash::verify(const int &base_addr, const uint8_t *data,
 			return false;
 		}
 
-
-		for (int ii = 0; ii < rd_burst; ii++) {
-			if ((uint8_t)verify_data[ii] != data[i+ii]) {
-				progress.fail();
-				printError("Verification failed at " +
-						std::to_string(base_addr + i + ii));
-				return false;
+		/* compare sector by sector with memcmp (vectorized by libc)
+		 * and only fallback to per sector bookkeeping on mismatch
+		 */
+		int pos = 0;
+		while (pos < rd_burst) {
+			uint32_t addr = base_addr + i + pos;
+			uint32_t sect_start = addr & ~(sect_size - 1);
+			int cmp_len = sect_start + sect_size - addr;
+			if (cmp_len > rd_burst - pos)
+				cmp_len = rd_burst - pos;
+			if (memcmp(&verify_data[pos], &data[i + pos], cmp_len) != 0) {
+				/* a sector may be split across two bursts */
+				if (!areas.empty() &&
+						areas.back().start + areas.back().len > sect_start) {
+					/* already registered */
+				} else if (!areas.empty() &&
+						areas.back().start + areas.back().len == sect_start) {
+					areas.back().len += sect_size;
+				} else {
+					areas.push_back({sect_start, sect_size});
+				}
 			}
+			pos += cmp_len;
 		}
 		progress.display(i);
 	}
 
+	if (!areas.empty()) {
+		progress.fail();
+		uint32_t nb_sect = 0;
+		for (auto area : areas)
+			nb_sect += area.len / sect_size;
+		printError("Verification failed: " + std::to_string(nb_sect) +
+				" sector(s) mismatch");
+		char mess[64];
+		for (auto area : areas) {
+			snprintf(mess, sizeof(mess), "\t0x%08x - 0x%08x",
+					area.start, area.start + area.len - 1);
+			printError(mess);
+		}
+		if (bad_areas)
+			*bad_areas = areas;
+		return false;
+	}
+
 	progress.done();
 
 	return true;
 }
 
+bool SPIFlash::repair(const int &base_addr, const uint8_t *data,
+		const int &len, const std::vector<flash_area_t> &bad_areas,
+		int rd_burst)
+{
+	const uint32_t img_start = base_addr;
+	const uint32_t img_end = base_addr + len;
+	/* rewrite window must match what sectors_erase really wipes */
+	const uint32_t gran = erase_granularity();
+
+	std::string sect;
+	for (auto area : bad_areas) {
+		uint32_t area_start = area.start & ~(gran - 1);
+		uint32_t area_end = (area.start + area.len + gran - 1) & ~(gran - 1);
+		uint32_t area_len = area_end - area_start;
+		uint32_t start = (area_start < img_start) ? img_start : area_start;
+		uint32_t end = (area_end > img_end) ? img_end : area_end;
+		if (start >= end)
+			continue;
+
+		char mess[64];
+		snprintf(mess, sizeof(mess), "Rewrite 0x%08x - 0x%08x",
+				area_start, area_end - 1);
+		printInfo(mess);
+
+		/* rebuild full sector content: bytes outside the image
+		 * are read back to be preserved after erase
+		 */
+		sect.resize(area_len);
+		if (area_start < start && read(area_start, (uint8_t *)&sect[0],
+					start - area_start) != 0)
+			return false;
+		if (end < area_end && read(end, (uint8_t *)&sect[end - area_start],
+					area_end - end) != 0)
+			return false;
+		memcpy(&sect[start - area_start], &data[start - img_start],
+				end - start);
+
+		if (erase_and_prog(area_start, (uint8_t *)&sect[0], area_len) != 0)
+			return false;
+		/* check the whole erased window, preserved bytes included */
+		if (!verify(area_start, (const uint8_t *)sect.data(), area_len,
+					rd_burst))
+			return false;
+	}
+
+	return true;
+}
+
 void SPIFlash::reset()
 {
 	uint8_t data[8];
@@ -875,6 +1018,49 @@ uint8_t SPIFlash::get_bp()
 	return (status & mask);
 }
 
+uint32_t SPIFlash::erase_granularity()
+{
+	if (_flash_model && _flash_model->subsector_erase)
+		return 0x1000;
+	return 0x10000;
+}
+
+float SPIFlash::erase_prog_ratio(int base_addr, int len)
+{
+	uint32_t be64_ms = FLASH_DEFAULT_BE64_MS;
+	uint32_t se_ms = FLASH_DEFAULT_SE_MS;
+	uint32_t pp_us = FLASH_DEFAULT_PP_US;
+	bool subsector_rdy = false, sector_rdy = true;
+	if (_flash_model) {
+		subsector_rdy = _flash_model->subsector_erase;
+		sector_rdy = _flash_model->sector_erase;
+		if (_flash_model->sector_erase_ms)
+			be64_ms = _flash_model->sector_erase_ms;
+		if (_flash_model->subsector_erase_ms)
+			se_ms = _flash_model->subsector_erase_ms;
+		if (_flash_model->page_prog_us)
+			pp_us = _flash_model->page_prog_us;
+	}
+
+	/* same split as sectors_erase: 64KB blocks and 4KB for the tail */
+	uint32_t end_addr = (base_addr + len + 0xfff) & ~0xfff;
+	uint32_t nb_blk = (end_addr - base_addr) / 0x10000;
+	uint32_t nb_sect = ((end_addr - base_addr) % 0x10000) / 0x1000;
+	if (!sector_rdy) {
+		nb_sect += nb_blk * 16;
+		nb_blk = 0;
+	} else if (!subsector_rdy && nb_sect) {
+		nb_blk++;
+		nb_sect = 0;
+	}
+	double erase_ms = nb_blk * be64_ms + nb_sect * se_ms;
+	double prog_ms = ((len + 255) / 256) * pp_us / 1000.0;
+
+	if (erase_ms + prog_ms == 0)
+		return 0.5f;
+	return static_cast<float>(erase_ms / (erase_ms + prog_ms));
+}
+
 /* convert bp area (status register) to len in byte */
 std::map<std::string, uint32_t> SPIFlash::bp_to_len(uint8_t bp, uint8_t tb)
 {
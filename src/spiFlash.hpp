@@ -8,13 +8,26 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "spiInterface.hpp"
 #include "spiFlashdb.hpp"
 
+class ProgressBar;
+
+/*!
+ * \brief flash area, aligned on erase granularity, whose content
+ *        doesn't match expected data
+ */
+typedef struct {
+	uint32_t start; /**< first address */
+	uint32_t len;   /**< area length (in Byte) */
+} flash_area_t;
+
 class SPIFlash {
 	public:
 		SPIFlash(SPIInterface *spi, bool unprotect, int8_t verbose);
+		virtual ~SPIFlash() {}
 		/* power */
 		virtual void power_up();
 		virtual void power_down();
@@ -61,12 +74,17 @@ class SPIFlash {
 		int block64_erase(int addr);
 		/*!
 		 * \brief erase n sectors starting at base_addr
+		 *        64Kb block erase is only used on 64Kb aligned blocks
+		 *        fully inside the range when 4Kb erase is available
+		 * \param[in] progress: when not NULL, report erase progress
+		 *            to this bar instead of a dedicated one
 		 */
-		int sectors_erase(int base_addr, int len);
+		virtual int sectors_erase(int base_addr, int len,
+				ProgressBar *progress = NULL);
 		/* write */
 		int write_page(int addr, uint8_t *data, int len);
 		/* read */
-		int read(int base_addr, uint8_t *data, int len);
+		virtual int read(int base_addr, uint8_t *data, int len);
 		/*!
 		 * \brief read len Byte starting at base_addr and store
 		 *        into filename
@@ -87,10 +105,34 @@ class SPIFlash {
 		 * \param[in] data: theoretical area content
 		 * \param[in] len: length (in Byte) to area and data
 		 * \param[in] rd_burst: size of packet to read
+		 * \param[out] bad_areas: when not NULL, filled with the list of
+		 *             sectors (erase granularity) with a content mismatch
 		 * \return false if read fails or content didn't match, true otherwise
 		 */
 		bool verify(const int &base_addr, const uint8_t *data,
-				const int &len, int rd_burst = 0);
+				const int &len, int rd_burst = 0,
+				std::vector<flash_area_t> *bad_areas = NULL);
+		/*!
+		 * \brief erase and write again only areas reported by verify
+		 *        then check these areas again. Bytes outside
+		 *        base_addr to base_addr + len, but in the same sector,
+		 *        are read back and preserved
+		 * \param[in] base_addr: base address used to write data
+		 * \param[in] data: theoretical area content
+		 * \param[in] len: length (in Byte) of data
+		 * \param[in] bad_areas: list of areas to rewrite
+		 * \param[in] rd_burst: size of packet to read
+		 * \return false if write fails or content still mismatch
+		 */
+		bool repair(const int &base_addr, const uint8_t *data,
+				const int &len, const std::vector<flash_area_t> &bad_areas,
+				int rd_burst = 0);
+		/*!
+		 * \brief smallest erase size supported by the flash
+		 *        (same policy as sectors_erase)
+		 * \return erase size in byte
+		 */
+		virtual uint32_t erase_granularity();
 		/* return status register value */
 		uint8_t read_status_reg();
 		/* display/info */
@@ -101,6 +143,35 @@ class SPIFlash {
 		uint16_t readVolatileCfgReg();
 
 	protected:
+		/*!
+		 * \brief constructor for subclasses overriding reset, power_up
+		 *        or read_id: virtual calls done by the base constructor
+		 *        use SPIFlash methods, so the flash is only probed
+		 *        when probe is set and subclass constructor has to call
+		 *        them otherwise
+		 * \param[in] probe: reset, power up and identify flash
+		 */
+		SPIFlash(SPIInterface *spi, bool unprotect, int8_t verbose,
+			bool probe);
+
+		/*!
+		 * \brief check block protection for base_addr to base_addr + len
+		 *        and unlock if allowed
+		 * \param[out] relock: true when protection must be restored
+		 * \param[out] lock_status: status register to restore
+		 * \return -1 when area is locked and can't be unlocked
+		 */
+		int unlock_area(int base_addr, int len, bool *relock,
+				uint8_t *lock_status);
+
+		/*!
+		 * \brief write len Byte by page, without erase
+		 * \param[in] progress: bar updated (done/fail) by this method
+		 * \return -1 if write fails, 0 otherwise
+		 */
+		int write_pages(int base_addr, uint8_t *data, int len,
+				ProgressBar &progress);
+
 		/*!
 		 * \brief retrieve TB (Top/Bottom) bit from one register
 		 *        (depends on flash)
@@ -114,6 +185,15 @@ class SPIFlash {
 		 */
 		uint8_t get_bp();
 
+		/*!
+		 * \brief estimate, with flash typical timings, the part of
+		 *        erase in an erase + program sequence
+		 * \param[in] base_addr: first address to write
+		 * \param[in] len: length (in Byte) to write
+		 * \return erase duration / total duration (0.0 - 1.0)
+		 */
+		float erase_prog_ratio(int base_addr, int len);
+
 	public:
 		/*!
 		 * \brief convert block protect to len in byte
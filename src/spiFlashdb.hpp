@@ -31,6 +31,10 @@ typedef struct {
 	tb_loc_t tb_register;     /**< TOP/BOTTOM location (register) */
 	uint8_t bp_len;           /**< BPx length */
 	uint8_t bp_offset[4];     /**< BP[0:3] bit offset */
+	/* typical timings (0: unknown, use generic value) */
+	uint16_t sector_erase_ms;    /**< 64KB erase time (ms) */
+	uint16_t subsector_erase_ms; /**< 4KB erase time (ms) */
+	uint16_t page_prog_us;       /**< 256B page program time (us) */
 } flash_t;
 
 static std::map <uint32_t, flash_t> flash_list = {
@@ -45,7 +49,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 5),
 		.tb_register = CONFR,
 		.bp_len = 3,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0x010219, {
 		.manufacturer = "spansion",
@@ -58,7 +65,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 5),
 		.tb_register = CONFR,
 		.bp_len = 3,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0x010220, {
 		.manufacturer = "spansion",
@@ -71,7 +81,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 5),
 		.tb_register = CONFR,
 		.bp_len = 3,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0x012018, {
 		.manufacturer = "spansion",
@@ -84,7 +97,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 5),
 		.tb_register = CONFR,
 		.bp_len = 3,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0x016019, {
 		.manufacturer = "spansion",
@@ -97,7 +113,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 6),
 		.tb_register = STATR,
 		.bp_len = 4,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 5)}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 5)},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	/* https://datasheet.octopart.com/M25P16-VME6G-STMicroelectronics-datasheet-7623188.pdf */
 	{0x00202015, {
@@ -111,7 +130,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = 0, // unused
 		.tb_register = STATR,
 		.bp_len = 3,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0x0020ba16, {
 		.manufacturer = "micron",
@@ -124,7 +146,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 5),
 		.tb_register = STATR,
 		.bp_len = 3,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0},
+		.sector_erase_ms = 700,
+		.subsector_erase_ms = 250,
+		.page_prog_us = 500}
 	},
 	{0x0020ba17, {
 		.manufacturer = "micron",
@@ -137,7 +162,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 5),
 		.tb_register = STATR,
 		.bp_len = 4,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 6)}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 6)},
+		.sector_erase_ms = 700,
+		.subsector_erase_ms = 250,
+		.page_prog_us = 500}
 	},
 	{0x0020ba18, {
 		.manufacturer = "micron",
@@ -150,7 +178,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 5),
 		.tb_register = STATR,
 		.bp_len = 4,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 6)}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 6)},
+		.sector_erase_ms = 700,
+		.subsector_erase_ms = 250,
+		.page_prog_us = 500}
 	},
 	{0x0020ba19, {
 		.manufacturer = "micron",
@@ -163,7 +194,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 5),
 		.tb_register = STATR,
 		.bp_len = 4,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 6)}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 6)},
+		.sector_erase_ms = 700,
+		.subsector_erase_ms = 250,
+		.page_prog_us = 500}
 	},
 	{0x0020bb21, {
 		.manufacturer = "micron",
@@ -176,7 +210,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 5),
 		.tb_register = STATR,
 		.bp_len = 4,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 6)}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 6)},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0x0020bb22, {
 		.manufacturer = "micron",
@@ -189,7 +226,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 5),
 		.tb_register = STATR,
 		.bp_len = 4,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 6)}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 6)},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0xbf258d, {
 		.manufacturer = "microchip",
@@ -202,7 +242,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = 0,
 		.tb_register = NONER,
 		.bp_len = 4,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 5)}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 5)},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0xBF2642, {
 		.manufacturer = "microchip",
@@ -215,7 +258,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = 0,
 		.tb_register = NONER,
 		.bp_len = 0,
-		.bp_offset = {0, 0, 0, 0}}
+		.bp_offset = {0, 0, 0, 0},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0xBF2643, {
 		.manufacturer = "microchip",
@@ -228,7 +274,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = 0,
 		.tb_register = NONER,
 		.bp_len = 0,
-		.bp_offset = {0, 0, 0, 0}}
+		.bp_offset = {0, 0, 0, 0},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0x9d6016, {
 		.manufacturer = "ISSI",
@@ -241,7 +290,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 1),
 		.tb_register = FUNCR,
 		.bp_len = 4,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 5)}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 5)},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0x9d6017, {
 		.manufacturer = "ISSI",
@@ -254,7 +306,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 1),
 		.tb_register = FUNCR,
 		.bp_len = 4,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 5)}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 5)},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0x9d6018, {
 		.manufacturer = "ISSI",
@@ -267,7 +322,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 1),
 		.tb_register = FUNCR,
 		.bp_len = 4,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 5)}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 5)},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0xc22018, {
 	/* https://www.macronix.com/Lists/Datasheet/Attachments/8934/MX25L12833F,%203V,%20128Mb,%20v1.0.pdf */
@@ -281,7 +339,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 3),
 		.tb_register = CONFR,
 		.bp_len = 5,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 5)}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), (1 << 5)},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0xef4014, {
 	/* https://cdn-shop.adafruit.com/datasheets/W25Q80BV.pdf */
@@ -295,7 +356,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 5),
 		.tb_register = STATR,
 		.bp_len = 3,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0xef4015, {
 		.manufacturer = "Winbond",
@@ -308,7 +372,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 5),
 		.tb_register = STATR,
 		.bp_len = 3,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0},
+		.sector_erase_ms = 0,
+		.subsector_erase_ms = 0,
+		.page_prog_us = 0}
 	},
 	{0xef4016, {
 		.manufacturer = "Winbond",
@@ -321,7 +388,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 5),
 		.tb_register = STATR,
 		.bp_len = 3,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0},
+		.sector_erase_ms = 150,
+		.subsector_erase_ms = 45,
+		.page_prog_us = 400}
 	},
 	{0xef4017, {
 		.manufacturer = "Winbond",
@@ -334,7 +404,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 5),
 		.tb_register = STATR,
 		.bp_len = 3,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0},
+		.sector_erase_ms = 150,
+		.subsector_erase_ms = 45,
+		.page_prog_us = 400}
 	},
 	{0xef4018, {
 		.manufacturer = "Winbond",
@@ -347,7 +420,10 @@ static std::map <uint32_t, flash_t> flash_list = {
 		.tb_offset = (1 << 5),
 		.tb_register = STATR,
 		.bp_len = 3,
-		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0}}
+		.bp_offset = {(1 << 2), (1 << 3), (1 << 4), 0},
+		.sector_erase_ms = 150,
+		.subsector_erase_ms = 45,
+		.page_prog_us = 400}
 	},
 };
 
@@ -4,24 +4,32 @@
  */
 
 #include <iostream>
+#include <memory>
 #include <vector>
 
 #include "display.hpp"
+#include "flashLayout.hpp"
 #include "spiInterface.hpp"
 #include "spiFlash.hpp"
 
 SPIInterface::SPIInterface():_spif_verbose(0), _spif_rd_burst(0),
-	_spif_verify(false), _skip_load_bridge(false)
+	_spif_verify(false), _spif_repair(false), _skip_load_bridge(false)
 {}
 
 SPIInterface::SPIInterface(const std::string &filename, uint8_t verbose,
 		uint32_t rd_burst, bool verify, bool skip_load_bridge,
 		bool skip_reset):
 	_spif_verbose(verbose), _spif_rd_burst(rd_burst),
-	_spif_verify(verify), _skip_load_bridge(skip_load_bridge),
+	_spif_verify(verify), _spif_repair(false),
+	_skip_load_bridge(skip_load_bridge),
 	_skip_reset(skip_reset), _spif_filename(filename)
 {}
 
+SPIFlash *SPIInterface::new_flash(bool unprotect)
+{
+	return new SPIFlash(this, unprotect, _spif_verbose);
+}
+
 /* spiFlash generic acces */
 bool SPIInterface::protect_flash(uint32_t len)
 {
@@ -36,10 +44,10 @@ bool SPIInterface::protect_flash(uint32_t len)
 
 	/* spi flash access */
 	try {
-		SPIFlash flash(this, false, _spif_verbose);
+		std::unique_ptr<SPIFlash> flash(new_flash(false));
 
 		/* configure flash protection */
-		ret = (flash.enable_protection(len) == 0);
+		ret = (flash->enable_protection(len) == 0);
 		if (!ret)
 			printError("Fail");
 		else
@@ -66,11 +74,11 @@ bool SPIInterface::unprotect_flash()
 
 	/* spi flash access */
 	try {
-		SPIFlash flash(this, false, _spif_verbose);
+		std::unique_ptr<SPIFlash> flash(new_flash(false));
 
 		/* configure flash protection */
 		printInfo("unprotect_flash: ", false);
-		ret = (flash.disable_protection() == 0);
+		ret = (flash->disable_protection() == 0);
 		if (!ret)
 			printError("Fail");
 		else
@@ -98,10 +106,10 @@ bool SPIInterface::bulk_erase_flash()
 
 	/* spi flash access */
 	try {
-		SPIFlash flash(this, false, _spif_verbose);
+		std::unique_ptr<SPIFlash> flash(new_flash(false));
 
 		/* bulk erase flash */
-		ret = (flash.bulk_erase() == 0);
+		ret = (flash->bulk_erase() == 0);
 		if (!ret)
 			printError("Fail");
 		else
@@ -125,12 +133,44 @@ bool SPIInterface::write(uint32_t offset, uint8_t *data, uint32_t len,
 
 	/* test SPI */
 	try {
-		SPIFlash flash(this, unprotect_flash, _spif_verbose);
-		flash.read_status_reg();
-		if (flash.erase_and_prog(offset, data, len) == -1)
+		std::unique_ptr<SPIFlash> flash(new_flash(unprotect_flash));
+		flash->read_status_reg();
+		if (flash->erase_and_prog(offset, data, len) == -1)
 			ret = false;
 		if (_spif_verify && ret)
-			ret = flash.verify(offset, data, len, _spif_rd_burst);
+			ret = verify_and_repair(*flash, offset, data, len);
+	} catch (std::exception &e) {
+		printError(e.what());
+		ret = false;
+	}
+
+	bool ret2 = post_flash_access();
+	return ret && ret2;
+}
+
+bool SPIInterface::verify_and_repair(SPIFlash &flash, uint32_t offset,
+		uint8_t *data, uint32_t len)
+{
+	std::vector<flash_area_t> bad_areas;
+	if (flash.verify(offset, data, len, _spif_rd_burst, &bad_areas))
+		return true;
+	/* only rewrite mismatched sectors */
+	if (!_spif_repair || bad_areas.empty())
+		return false;
+	printWarn("Rewrite mismatched sectors");
+	return flash.repair(offset, data, len, bad_areas, _spif_rd_burst);
+}
+
+bool SPIInterface::write(FlashLayout &layout, bool unprotect_flash)
+{
+	bool ret = true;
+	if (!prepare_flash_access())
+		return false;
+
+	try {
+		std::unique_ptr<SPIFlash> flash(new_flash(unprotect_flash));
+		ret = layout.write(*flash, _spif_verify, _spif_repair,
+				_spif_rd_burst);
 	} catch (std::exception &e) {
 		printError(e.what());
 		ret = false;
@@ -148,8 +188,8 @@ bool SPIInterface::read(uint8_t *data, uint32_t base_addr, uint32_t len)
 		return false;
 
 	try {
-		SPIFlash flash(this, false, _spif_verbose);
-		ret = flash.read(base_addr, data, len);
+		std::unique_ptr<SPIFlash> flash(new_flash(false));
+		ret = flash->read(base_addr, data, len);
 	} catch (std::exception &e) {
 		printError(e.what());
 		ret = false;
@@ -167,8 +207,8 @@ bool SPIInterface::dump(uint32_t base_addr, uint32_t len)
 		return false;
 
 	try {
-		SPIFlash flash(this, false, _spif_verbose);
-		ret = flash.dump(_spif_filename, base_addr, len, _spif_rd_burst);
+		std::unique_ptr<SPIFlash> flash(new_flash(false));
+		ret = flash->dump(_spif_filename, base_addr, len, _spif_rd_burst);
 	} catch (std::exception &e) {
 		printError(e.what());
 		ret = false;
@@ -11,6 +11,9 @@
 #include <string>
 #include <vector>
 
+class FlashLayout;
+class SPIFlash;
+
 /*!
  * \file SPIInterface.hpp
  * \class SPIInterface
@@ -30,6 +33,11 @@ class SPIInterface {
 	bool unprotect_flash();
 	bool bulk_erase_flash();
 	void set_filename(const std::string &filename) {_spif_filename = filename;}
+	/*!
+	 * \brief when verify fails rewrite mismatched sectors instead
+	 *        of only reporting them
+	 */
+	void set_spif_repair(bool repair) {_spif_repair = repair;}
 
 	/*!
 	 * \brief write len byte into flash starting at offset,
@@ -47,6 +55,15 @@ class SPIInterface {
 	bool write(uint32_t offset, uint8_t *data, uint32_t len,
 		bool unprotect_flash);
 
+	/*!
+	 * \brief write each partition of a flash layout with a content
+	 *        different from the flash, optionally verify after write
+	 * \param[in] layout: partitions list
+	 * \param[in] unprotect_flash: unprotect blocks if allowed and required
+	 * \return false when something fails
+	 */
+	bool write(FlashLayout &layout, bool unprotect_flash);
+
 	/*!
 	 * \brief read flash offset byte starting at base_addr and
 	 *        store into data buffer
@@ -110,10 +127,27 @@ class SPIInterface {
 	 * \brief end of SPI flash access
 	 */
 	virtual bool post_flash_access() {return false;}
+	/*!
+	 * \brief instantiate flash driver used for all flash accesses.
+	 *        Default is generic SPIFlash, devices with a specific
+	 *        flash family override it
+	 * \param[in] unprotect: allows to unprotect memory before write
+	 * \return a new flash instance, owned by caller
+	 */
+	virtual SPIFlash *new_flash(bool unprotect);
+
+	/*!
+	 * \brief verify and, when repair is enabled, rewrite mismatched
+	 *        sectors
+	 * \return false when content mismatch (after rewrite if enabled)
+	 */
+	bool verify_and_repair(SPIFlash &flash, uint32_t offset,
+		uint8_t *data, uint32_t len);
 
 	uint8_t _spif_verbose;
 	uint32_t _spif_rd_burst;
 	bool _spif_verify;
+	bool _spif_repair; /**< rewrite sectors with a verify mismatch */
 	bool _skip_load_bridge;
 	bool _skip_reset; /*!< don't reset the device after write */
 
@@ -16,6 +16,7 @@
 #include <map>
 #include <vector>
 
+#include "bufferPool.hpp"
 #include "jtag.hpp"
 
 using namespace std;
@@ -37,10 +38,9 @@ void SVF_jtag::clear_XYR(svf_XYR &t)
 	t.smask.clear();
 }
 
-static unsigned char *parse_hex(string const &in, size_t byte_length,
-		bool default_value)
+static void parse_hex(string const &in, size_t byte_length,
+		bool default_value, unsigned char *txbuf)
 {
-	unsigned char *txbuf = new unsigned char[byte_length];
 	char c;
 	ssize_t last_iter = in.size() - (2 * byte_length);
 	for (ssize_t i = (in.size() - 1), pos = 0; i >= last_iter; i--, pos++) {
@@ -57,7 +57,6 @@ static unsigned char *parse_hex(string const &in, size_t byte_length,
 		else
 			txbuf[pos / 2] |= c << 4;
 	}
-	return txbuf;
 }
 
 /* pas clair:
@@ -142,28 +141,30 @@ void SVF_jtag::parse_XYR(vector<string> const &vstr, svf_XYR &t)
 	}
 	if (write_data != -1) {
 		size_t byte_len = (t.len + 7) / 8;
-		unsigned char *write_buffer = parse_hex(t.tdi, byte_len, 0);
+		BufferPool::Buffer write_buffer(byte_len);
+		parse_hex(t.tdi, byte_len, 0, write_buffer);
 		if (!t.smask.empty()) {
-			unsigned char *smaskbuff = parse_hex(t.smask, byte_len, 0);
+			BufferPool::Buffer smaskbuff(byte_len);
+			parse_hex(t.smask, byte_len, 0, smaskbuff);
 			for (unsigned int b = 0; b < byte_len; b++) {
 				write_buffer[b] &= smaskbuff[b];
 			}
-			delete smaskbuff;
 		}
+		BufferPool::Buffer rd_buf(byte_len);
 		unsigned char *read_buffer = NULL;
 		if (!t.tdo.empty()) {
-			read_buffer = new unsigned char[byte_len];
+			read_buffer = rd_buf.data();
 			read_buffer[byte_len - 1] = 0;  // clear the last byte which may not be full;
-		} else {
-			read_buffer = NULL;
 		}
 		if (write_data == 0)
 			_jtag->shiftIR(write_buffer, read_buffer, t.len, _endir);
 		else
 			_jtag->shiftDR(write_buffer, read_buffer, t.len, _enddr);
 		if (!t.tdo.empty()) {
-			unsigned char *tdobuf = parse_hex(t.tdo, byte_len, 0);
-			unsigned char *maskbuf = parse_hex(t.mask, byte_len, t.mask.empty() ? 1 : 0);
+			BufferPool::Buffer tdobuf(byte_len);
+			BufferPool::Buffer maskbuf(byte_len);
+			parse_hex(t.tdo, byte_len, 0, tdobuf);
+			parse_hex(t.mask, byte_len, t.mask.empty() ? 1 : 0, maskbuf);
 			for (size_t i = 0; i < byte_len; i++) {
 				if ((read_buffer[i] ^ tdobuf[i]) & maskbuf[i]) {
 					cerr << "TDO value ";
@@ -174,11 +175,7 @@ void SVF_jtag::parse_XYR(vector<string> const &vstr, svf_XYR &t)
 					throw exception();
 				}
 			}
-			delete tdobuf;
-			delete maskbuf;
 		}
-		delete write_buffer;
-		delete read_buffer;
 	}
 }
 
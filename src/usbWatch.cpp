@@ -0,0 +1,236 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#include <libusb.h>
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "display.hpp"
+#include "usbWatch.hpp"
+
+/* polling period when hotplug is not supported and hotplug events timeout */
+#define WATCH_PERIOD_MS 100
+/* time given to the OS to make a new device accessible */
+#define OPEN_RETRY      20
+#define OPEN_RETRY_MS   50
+
+volatile std::sig_atomic_t UsbWatch::_stop_requested = 0;
+
+UsbWatch::UsbWatch(uint16_t vid, uint16_t pid, const std::string &serial,
+		int8_t verbose): _usb_ctx(NULL), _vid(vid), _pid(pid),
+		_serial(serial), _verbose(verbose), _hotplug(false), _cb_handle(0),
+		_current(NULL), _departed(false)
+{
+	if (libusb_init(&_usb_ctx) < 0)
+		throw std::runtime_error("libusb_init failed");
+
+	_hotplug = libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG) != 0;
+	if (_hotplug) {
+		int ret = libusb_hotplug_register_callback(_usb_ctx,
+			(libusb_hotplug_event)(LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED |
+				LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT),
+			(libusb_hotplug_flag)0, _vid, _pid, LIBUSB_HOTPLUG_MATCH_ANY,
+			hotplug_cb, this, &_cb_handle);
+		if (ret != LIBUSB_SUCCESS) {
+			printWarn("USB hotplug registration failed: polling devices");
+			_hotplug = false;
+		}
+	} else if (_verbose > 0) {
+		printInfo("USB hotplug not supported: polling devices");
+	}
+}
+
+UsbWatch::~UsbWatch()
+{
+	if (_hotplug)
+		libusb_hotplug_deregister_callback(_usb_ctx, _cb_handle);
+	for (auto dev : _arrived)
+		libusb_unref_device(dev);
+	if (_current)
+		libusb_unref_device(_current);
+	libusb_exit(_usb_ctx);
+}
+
+/* only bookkeeping here: libusb forbids synchronous requests in callback */
+int LIBUSB_CALL UsbWatch::hotplug_cb(libusb_context *ctx, libusb_device *dev,
+		libusb_hotplug_event event, void *user_data)
+{
+	(void)ctx;
+	UsbWatch *self = static_cast<UsbWatch *>(user_data);
+
+	if (event == LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED) {
+		self->_arrived.push_back(libusb_ref_device(dev));
+	} else {
+		auto it = std::find(self->_arrived.begin(), self->_arrived.end(), dev);
+		if (it != self->_arrived.end()) {
+			libusb_unref_device(*it);
+			self->_arrived.erase(it);
+		}
+		if (dev == self->_current)
+			self->_departed = true;
+	}
+	return 0;  // keep callback registered
+}
+
+bool UsbWatch::match(libusb_device *dev)
+{
+	struct libusb_device_descriptor desc;
+	if (libusb_get_device_descriptor(dev, &desc) != 0)
+		return false;
+	if (desc.idVendor != _vid || desc.idProduct != _pid)
+		return false;
+
+	libusb_device_handle *handle = NULL;
+	int ret = LIBUSB_ERROR_OTHER;
+	for (int i = 0; i < OPEN_RETRY; i++) {
+		ret = libusb_open(dev, &handle);
+		/* removed or not a candidate */
+		if (ret == LIBUSB_SUCCESS || ret == LIBUSB_ERROR_NO_DEVICE)
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(OPEN_RETRY_MS));
+	}
+	if (ret != LIBUSB_SUCCESS) {
+		if (_verbose > 0)
+			printWarn("USB watch: can't open device: " +
+				std::string(libusb_error_name(ret)));
+		return false;
+	}
+
+	bool found = true;
+	if (!_serial.empty()) {
+		unsigned char serial[256];
+		int len = 0;
+		if (desc.iSerialNumber != 0)
+			len = libusb_get_string_descriptor_ascii(handle,
+				desc.iSerialNumber, serial, sizeof(serial));
+		found = len > 0 &&
+			_serial == std::string(reinterpret_cast<char *>(serial), len);
+	}
+	libusb_close(handle);
+	return found;
+}
+
+libusb_device *UsbWatch::scan()
+{
+	libusb_device **dev_list;
+	libusb_device *found = NULL;
+
+	ssize_t list_size = libusb_get_device_list(_usb_ctx, &dev_list);
+	for (ssize_t i = 0; i < list_size && !found; i++) {
+		if (match(dev_list[i]))
+			found = libusb_ref_device(dev_list[i]);
+	}
+	if (list_size >= 0)
+		libusb_free_device_list(dev_list, 1);
+	return found;
+}
+
+bool UsbWatch::is_present(libusb_device *dev)
+{
+	libusb_device **dev_list;
+	bool found = false;
+
+	ssize_t list_size = libusb_get_device_list(_usb_ctx, &dev_list);
+	for (ssize_t i = 0; i < list_size && !found; i++)
+		found = dev_list[i] == dev;
+	if (list_size >= 0)
+		libusb_free_device_list(dev_list, 1);
+	return found;
+}
+
+bool UsbWatch::handle_events()
+{
+	if (stop_requested())
+		return false;
+
+	if (!_hotplug) {
+		std::this_thread::sleep_for(
+			std::chrono::milliseconds(WATCH_PERIOD_MS));
+		return true;
+	}
+
+	struct timeval tv = {0, WATCH_PERIOD_MS * 1000};
+	int ret = libusb_handle_events_timeout_completed(_usb_ctx, &tv, NULL);
+	if (ret < 0 && ret != LIBUSB_ERROR_INTERRUPTED) {
+		printError("USB watch: " + std::string(libusb_error_name(ret)));
+		return false;
+	}
+	return true;
+}
+
+bool UsbWatch::wait_arrival()
+{
+	if (_current) {
+		libusb_unref_device(_current);
+		_current = NULL;
+	}
+	_departed = false;
+
+	/* probe already plugged: events only report new devices */
+	_current = scan();
+
+	while (!_current) {
+		if (!handle_events())
+			return false;
+
+		if (!_hotplug) {
+			_current = scan();
+			continue;
+		}
+
+		while (!_arrived.empty() && !_current) {
+			libusb_device *dev = _arrived.front();
+			_arrived.erase(_arrived.begin());
+			if (match(dev))
+				_current = dev;
+			else
+				libusb_unref_device(dev);
+		}
+	}
+
+	/* already handled by scan() */
+	for (auto dev : _arrived)
+		libusb_unref_device(dev);
+	_arrived.clear();
+
+	if (_verbose > 0) {
+		char mess[64];
+		snprintf(mess, sizeof(mess), "USB watch: probe on bus %d device %d",
+			libusb_get_bus_number(_current),
+			libusb_get_device_address(_current));
+		printInfo(mess);
+	}
+	return true;
+}
+
+bool UsbWatch::wait_departure()
+{
+	if (!_current)
+		return true;
+
+	if (_hotplug) {
+		/* removal may have been reported during programming */
+		if (!is_present(_current))
+			_departed = true;
+		while (!_departed) {
+			if (!handle_events())
+				return false;
+		}
+	} else {
+		while (is_present(_current)) {
+			if (!handle_events())
+				return false;
+		}
+	}
+
+	libusb_unref_device(_current);
+	_current = NULL;
+	return true;
+}
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: Apache-2.0
+/*
+ * Copyright (C) 2026 openFPGALoader contributors
+ */
+
+#ifndef SRC_USBWATCH_HPP_
+#define SRC_USBWATCH_HPP_
+
+#include <libusb.h>
+
+#include <csignal>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*!
+ * \file usbWatch.hpp
+ * \class UsbWatch
+ * \brief wait for a probe to be plugged / unplugged (production fixtures).
+ *        Uses libusb hotplug events when available, device list polling
+ *        otherwise
+ */
+class UsbWatch {
+ public:
+	/*!
+	 * \brief constructor
+	 * \param[in] vid: probe vendor ID
+	 * \param[in] pid: probe product ID
+	 * \param[in] serial: probe serial number (empty: any)
+	 * \param[in] verbose: verbose level
+	 */
+	UsbWatch(uint16_t vid, uint16_t pid, const std::string &serial,
+			int8_t verbose);
+	~UsbWatch();
+
+	/*!
+	 * \brief wait until a matching probe is present and can be opened
+	 *        (returns immediately if already plugged)
+	 * \return false on libusb error or stop request
+	 */
+	bool wait_arrival();
+
+	/*!
+	 * \brief wait until probe returned by last wait_arrival is removed
+	 * \return false on libusb error or stop request
+	 */
+	bool wait_departure();
+
+	/*!
+	 * \brief make wait_arrival/wait_departure return. Async signal safe
+	 *        (called from SIGINT handler)
+	 */
+	static void request_stop() {_stop_requested = 1;}
+	/*!
+	 * \brief true when request_stop has been called
+	 */
+	static bool stop_requested() {return _stop_requested != 0;}
+
+ private:
+	static int LIBUSB_CALL hotplug_cb(libusb_context *ctx,
+			libusb_device *dev, libusb_hotplug_event event, void *user_data);
+	/*!
+	 * \brief check serial number and wait until device is accessible
+	 *        (kernel driver may still be binding after enumeration)
+	 */
+	bool match(libusb_device *dev);
+	/*!
+	 * \brief search a matching probe in current device list
+	 */
+	libusb_device *scan();
+	bool is_present(libusb_device *dev);
+	/*!
+	 * \brief process pending events (hotplug) or sleep (polling)
+	 */
+	bool handle_events();
+
+	libusb_context *_usb_ctx;
+	uint16_t _vid;
+	uint16_t _pid;
+	std::string _serial;
+	int8_t _verbose;
+	bool _hotplug;                           /**< hotplug supported */
+	libusb_hotplug_callback_handle _cb_handle;
+	std::vector<libusb_device *> _arrived;   /**< events not yet checked */
+	libusb_device *_current;                 /**< probe in use */
+	bool _departed;                          /**< _current removed */
+	static volatile std::sig_atomic_t _stop_requested;
+};
+
+#endif  // SRC_USBWATCH_HPP_
@@ -7,11 +7,14 @@
 
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "bufferPool.hpp"
 #include "jtag.hpp"
+#include "jtagStream.hpp"
 #include "bitparser.hpp"
 #include "common.hpp"
 #include "configBitstreamParser.hpp"
@@ -61,7 +64,10 @@ static std::map<std::string, std::map<std::string, std::vector<uint8_t>>>
 			{
 				{ "USER1",       {0x02} },
 				{ "USER2",       {0x03} },
+				{ "USER3",       {0x22} },
+				{ "USER4",       {0x23} },
 				{ "CFG_IN",      {0x05} },
+				{ "CFG_OUT",     {0x04} },
 				{ "USERCODE",    {0x08} },
 				{ "IDCODE",      {0x09} },
 				{ "ISC_ENABLE",  {0x10} },
@@ -80,7 +86,10 @@ static std::map<std::string, std::map<std::string, std::vector<uint8_t>>>
 			{
 				{ "USER1",       {0b00100100, 0b00101001, 0b00} },
 				{ "USER2",       {0b00100100, 0b00111001, 0b00} },
+				{ "USER3",       {0b00100100, 0b00101001, 0b10} },
+				{ "USER4",       {0b00100100, 0b00111001, 0b10} },
 				{ "CFG_IN",      {0b00100100, 0b01011001, 0b00} }, // CFG_IN_SLR1
+				{ "CFG_OUT",     {0b00100100, 0b01001001, 0b00} }, // CFG_OUT_SLR1
 				{ "USERCODE",    {0b00100100, 0b10001001, 0b00} },
 				{ "IDCODE",      {0b01001001, 0b10010010, 0b00} },
 				{ "ISC_ENABLE",  {0b00010000, 0b00000100, 0b01} },
@@ -222,6 +231,9 @@ Xilinx::Xilinx(Jtag *jtag, const std::string &filename,
 		if (_mode != Device::MEM_MODE) {
 			throw std::runtime_error("Error: Only load to mem is supported");
 		}
+		/* only USER1 and USER2 */
+		_ircode_map.erase("USER3");
+		_ircode_map.erase("USER4");
 	} else if (family == "xcf") {
 		_fpga_family = XCF_FAMILY;
 		if (_mode == Device::MEM_MODE) {
@@ -229,6 +241,8 @@ Xilinx::Xilinx(Jtag *jtag, const std::string &filename,
 		}
 	} else if (family == "spartan6") {
 		_fpga_family = SPARTAN6_FAMILY;
+		_ircode_map["USER3"] = {0x1A};
+		_ircode_map["USER4"] = {0x1B};
 	} else if (family == "xc2c") {
 		xc2c_init(idcode);
 	} else if (family == "xc9500xl") {
@@ -360,7 +374,7 @@ int Xilinx::idCode()
 	return id;
 }
 
-void Xilinx::program(unsigned int offset, bool unprotect_flash)
+bool Xilinx::program(unsigned int offset, bool unprotect_flash)
 {
 	ConfigBitstreamParser *bit = nullptr;
 	ConfigBitstreamParser *secondary_bit = nullptr;
@@ -368,7 +382,7 @@ void Xilinx::program(unsigned int offset, bool unprotect_flash)
 
 	/* nothing to do */
 	if (_mode == Device::NONE_MODE || _mode == Device::READ_MODE)
-		return;
+		return true;
 
 	if (_mode == Device::FLASH_MODE && _file_extension == "jed") {
 		JedParser *jed;
@@ -377,22 +391,27 @@ void Xilinx::program(unsigned int offset, bool unprotect_flash)
 		jed = new JedParser(_filename, _verbose);
 		if (jed->parse() == EXIT_FAILURE) {
 			printError("FAIL");
-			return;
+			delete jed;
+			return false;
 		}
 		printSuccess("DONE");
 
-		if (_fpga_family == XC95_FAMILY)
-			flow_program(jed);
-		else if (_fpga_family == XC2C_FAMILY)
-			xc2c_flow_program(jed);
-		else
+		bool ret;
+		if (_fpga_family == XC95_FAMILY) {
+			ret = flow_program(jed);
+		} else if (_fpga_family == XC2C_FAMILY) {
+			ret = xc2c_flow_program(jed);
+		} else {
+			delete jed;
 			throw std::runtime_error("Error: jed only supported for xc95 and xc2c");
-		return;
+		}
+		delete jed;
+		return ret;
 	}
 
 	if (_fpga_family == XC95_FAMILY) {
 		printError("Only jed file and flash mode supported for XC95 CPLD");
-		return;
+		return false;
 	}
 
 	if (_mode == Device::MEM_MODE || _fpga_family == XCF_FAMILY)
@@ -412,7 +431,7 @@ void Xilinx::program(unsigned int offset, bool unprotect_flash)
 			delete bit;
 		if (secondary_bit)
 			delete secondary_bit;
-		return;
+		return false;
 	}
 
 	if (_verbose) {
@@ -422,32 +441,38 @@ void Xilinx::program(unsigned int offset, bool unprotect_flash)
 			secondary_bit->displayHeader();
 	}
 
+	bool ret = true;
 	if (_fpga_family == XCF_FAMILY) {
-		xcf_program(bit);
+		ret = xcf_program(bit);
 		delete bit;
-		return;
+		return ret;
 	}
 
 	if (_mode == Device::SPI_MODE) {
 		if (_flash_chips & PRIMARY_FLASH) {
 			select_flash_chip(PRIMARY_FLASH);
-			program_spi(bit, offset, unprotect_flash);
+			ret = program_spi(bit, offset, unprotect_flash);
 		}
 		if (_flash_chips & SECONDARY_FLASH) {
 			select_flash_chip(SECONDARY_FLASH);
-			program_spi(secondary_bit, offset, unprotect_flash);
+			if (!program_spi(secondary_bit, offset, unprotect_flash))
+				ret = false;
 		}
 
 		reset();
 
 	} else {
 		if (_fpga_family == SPARTAN3_FAMILY)
-			xc3s_flow_program(bit);
+			ret = xc3s_flow_program(bit);
+		else if (bit->getHeader()["partial"] == "TRUE")
+			program_partial(bit);
 		else
 			program_mem(bit);
 	}
 
 	delete bit;
+	delete secondary_bit;
+	return ret;
 }
 
 bool Xilinx::post_flash_access()
@@ -505,19 +530,19 @@ bool Xilinx::load_bridge()
 	return true;
 }
 
-void Xilinx::program_spi(ConfigBitstreamParser * bit, unsigned int offset,
+bool Xilinx::program_spi(ConfigBitstreamParser * bit, unsigned int offset,
 		bool unprotect_flash)
 {
 	uint8_t *data = bit->getData();
 	int length = bit->getLength() / 8;
-	SPIInterface::write(offset, data, length, unprotect_flash);
+	return SPIInterface::write(offset, data, length, unprotect_flash);
 }
 
 void Xilinx::program_mem(ConfigBitstreamParser *bitfile)
 {
 	std::cout << "load program" << std::endl;
 	unsigned char *tx_buf;
-	unsigned char rx_buf[(_irlen >> 3) + 1];
+	BufferPool::Buffer rx_buf((_irlen >> 3) + 1);
 
 	/*            comment                                TDI   TMS TCK
 	 * 1: On power-up, place a logic 1 on the TMS,
@@ -568,13 +593,46 @@ void Xilinx::program_mem(ConfigBitstreamParser *bitfile)
 	 *     Bit0 (LSB) shifts on the transition to       bit0    1   1
 	 *     EXIT1-DR.
 	 */
-	/* GGM: TODO */
+	shift_cfg_data(bitfile, "Flash SRAM");
+	/*
+	 * 16: Move into RTI state.                           X     0   1
+	 */
+	_jtag->set_state(Jtag::RUN_TEST_IDLE);
+	/*
+	 * 17: Enter the SELECT-IR state.                     X     1   2
+	 * 18: Move to the SHIFT-IR state.                    X     0   2
+	 * 19: Start loading the JSTART instruction
+	 *     (optional). The JSTART instruction           01100   0   5
+	 *     initializes the startup sequence.
+	 * 20: Load the last bit of the JSTART instruction.   0     1   1
+	 * 21: Move to the UPDATE-IR state.                   X     1   1
+	 */
+	_jtag->shiftIR(get_ircode(_ircode_map, "JSTART"), NULL, _irlen, Jtag::UPDATE_IR);
+	/*
+	 * 22: Move to the RTI state and clock the
+	 *     startup sequence by applying a minimum         X     0   2000
+	 *     of 2000 clock cycles to the TCK.
+	 */
+	_jtag->set_state(Jtag::RUN_TEST_IDLE);
+	_jtag->toggleClk(2000);
+	/*
+	 * 23: Move to the TLR state. The device is
+	 * now functional.                                    X     1   3
+	 */
+	_jtag->go_test_logic_reset();
+}
+
+void Xilinx::shift_cfg_data(ConfigBitstreamParser *bitfile,
+		const std::string &mess)
+{
 	int byte_length = bitfile->getLength() / 8;
 	uint8_t *data = bitfile->getData();
 	int tx_len, tx_end;
 	int burst_len = byte_length / 100;
+	if (burst_len == 0)
+		burst_len = byte_length;
 
-	ProgressBar progress("Flash SRAM", byte_length, 50, _quiet);
+	ProgressBar progress(mess, byte_length, 50, _quiet);
 
 	for (int i=0; i < byte_length; i+=burst_len) {
 		if (i + burst_len > byte_length) {
@@ -595,32 +653,87 @@ void Xilinx::program_mem(ConfigBitstreamParser *bitfile)
 		progress.display(i);
 	}
 	progress.done();
-	/*
-	 * 16: Move into RTI state.                           X     0   1
-	 */
-	_jtag->set_state(Jtag::RUN_TEST_IDLE);
-	/*
-	 * 17: Enter the SELECT-IR state.                     X     1   2
-	 * 18: Move to the SHIFT-IR state.                    X     0   2
-	 * 19: Start loading the JSTART instruction
-	 *     (optional). The JSTART instruction           01100   0   5
-	 *     initializes the startup sequence.
-	 * 20: Load the last bit of the JSTART instruction.   0     1   1
-	 * 21: Move to the UPDATE-IR state.                   X     1   1
-	 */
-	_jtag->shiftIR(get_ircode(_ircode_map, "JSTART"), NULL, _irlen, Jtag::UPDATE_IR);
-	/*
-	 * 22: Move to the RTI state and clock the
-	 *     startup sequence by applying a minimum         X     0   2000
-	 *     of 2000 clock cycles to the TCK.
-	 */
-	_jtag->set_state(Jtag::RUN_TEST_IDLE);
-	_jtag->toggleClk(2000);
-	/*
-	 * 23: Move to the TLR state. The device is
-	 * now functional.                                    X     1   3
+}
+
+/* STAT register bits (UG470 table 5-25) */
+#define STAT_CRC_ERROR (1 << 0)
+#define STAT_DONE      (1 << 14)
+#define STAT_ID_ERROR  (1 << 15)
+#define STAT_DEC_ERROR (1 << 16)
+
+bool Xilinx::read_stat(uint32_t *stat)
+{
+	if (_ircode_map.find("CFG_OUT") == _ircode_map.end())
+		return false;
+
+	/* sync word, NOOP, type 1 read STAT (1 word), 2 x NOOP */
+	const uint32_t cmd[] = {0xAA995566, 0x20000000, 0x2800E001,
+		0x20000000, 0x20000000};
+	const int nb_words = sizeof(cmd) / sizeof(uint32_t);
+	uint8_t tx[nb_words * 4];
+	/* configuration words are sent MSB first */
+	for (int i = 0; i < nb_words; i++)
+		for (int b = 0; b < 4; b++)
+			tx[i * 4 + b] = ConfigBitstreamParser::reverseByte(
+					(cmd[i] >> (24 - 8 * b)) & 0xff);
+
+	_jtag->go_test_logic_reset();
+	_jtag->shiftIR(get_ircode(_ircode_map, "CFG_IN"), NULL, _irlen);
+	_jtag->shiftDR(tx, NULL, 8 * nb_words * 4);
+	_jtag->shiftIR(get_ircode(_ircode_map, "CFG_OUT"), NULL, _irlen);
+	uint8_t rx[4], dummy[4] = {0, 0, 0, 0};
+	_jtag->shiftDR(dummy, rx, 32);
+	_jtag->go_test_logic_reset();
+
+	/* first bit out is STAT[31] */
+	*stat = 0;
+	for (int b = 0; b < 4; b++)
+		*stat = (*stat << 8) | ConfigBitstreamParser::reverseByte(rx[b]);
+	return true;
+}
+
+void Xilinx::program_partial(ConfigBitstreamParser *bitfile)
+{
+	if (_fpga_family == SPARTAN6_FAMILY)
+		throw std::runtime_error("Error: partial bitstream not supported "
+				"for spartan6");
+
+	std::cout << "load partial bitstream" << std::endl;
+
+	/* no JPROGRAM: static region must keep running. The partial
+	 * bitstream has its own sync/desync and doesn't need JSTART
 	 */
 	_jtag->go_test_logic_reset();
+	_jtag->shiftIR(get_ircode(_ircode_map, "CFG_IN"), NULL, _irlen);
+	_jtag->set_state(Jtag::SELECT_DR_SCAN);
+	shift_cfg_data(bitfile, "Load partial");
+	_jtag->set_state(Jtag::RUN_TEST_IDLE);
+	_jtag->toggleClk(100);
+
+	uint32_t stat;
+	if (!read_stat(&stat)) {
+		printWarn("Partial bitstream loaded: status can't be checked");
+		return;
+	}
+
+	if (_verbose) {
+		char mess[64];
+		snprintf(mess, sizeof(mess), "STAT: 0x%08x", stat);
+		printInfo(mess);
+	}
+	if (stat & (STAT_CRC_ERROR | STAT_ID_ERROR | STAT_DEC_ERROR)) {
+		char mess[128];
+		snprintf(mess, sizeof(mess), "Error: partial load failed "
+				"(STAT 0x%08x:%s%s%s)", stat,
+				(stat & STAT_CRC_ERROR) ? " CRC_ERROR" : "",
+				(stat & STAT_ID_ERROR) ? " ID_ERROR" : "",
+				(stat & STAT_DEC_ERROR) ? " DEC_ERROR" : "");
+		throw std::runtime_error(mess);
+	}
+	if (!(stat & STAT_DONE))
+		printWarn("Partial bitstream loaded but DONE is low");
+	else
+		printSuccess("Partial bitstream loaded");
 }
 
 bool Xilinx::dumpFlash(uint32_t base_addr, uint32_t len)
@@ -674,6 +787,12 @@ bool Xilinx::dumpFlash(uint32_t base_addr, uint32_t len)
 	return true;
 }
 
+bool Xilinx::program_layout(FlashLayout &layout, bool unprotect_flash)
+{
+	select_flash_chip(PRIMARY_FLASH);
+	return SPIInterface::write(layout, unprotect_flash);
+}
+
 bool Xilinx::protect_flash(uint32_t len)
 {
 	if (_flash_chips & PRIMARY_FLASH) {
@@ -1436,20 +1555,21 @@ bool Xilinx::xc2c_flow_program(JedParser *jed)
 
 	/* map jed fuse using device map */
 	printInfo("Map jed fuses: ", false);
-	XilinxMapParser *map_parser;
+	std::unique_ptr<XilinxMapParser> map_parser;
 	try {
 		std::string mapname = ISE_DIR "/ISE_DS/ISE/xbr/data/" +
 			std::string(_cpld_base_name) + ".map";
-		map_parser = new XilinxMapParser(mapname, _cpld_nb_row, _cpld_nb_col,
-				jed, 0xffffffff, _verbose);
-		map_parser->parse();
+		map_parser.reset(new XilinxMapParser(mapname, _cpld_nb_row,
+				_cpld_nb_col, jed, 0xffffffff, _verbose));
+		if (map_parser->parse() != EXIT_SUCCESS)
+			throw std::runtime_error("Fail to apply map file");
 	} catch(std::exception &e) {
 		printError("FAIL");
 		throw std::runtime_error(e.what());
 	}
 	printSuccess("DONE");
 
-	std::vector<std::string> listfuse = map_parser->cfg_data();
+	const int row_bytes = map_parser->row_bytes();
 
 	/* erase internal flash */
 	printInfo("Erase Flash: ", false);
@@ -1465,38 +1585,31 @@ bool Xilinx::xc2c_flow_program(JedParser *jed)
 	_jtag->shiftIR(XC2C_ISC_ENABLE_OTF, 8);
 	_jtag->shiftIR(XC2C_ISC_PROGRAM, 8);
 
-	uint16_t iter = 0;
-	for (auto row : listfuse) {
-		uint16_t pos = 0;
-		uint8_t addr = _gray_code[iter] >> shift_addr;
-		for (auto col : row) {
-			if (col)
-				wr_buf[pos >> 3] |= (1 << (pos & 0x07));
-			else
-				wr_buf[pos >> 3] &= ~(1 << (pos & 0x07));
-			pos++;
-		}
+	for (uint16_t row = 0; row < _cpld_nb_row; row++) {
+		uint8_t addr = _gray_code[row] >> shift_addr;
+		/* rows are already packed in sending order */
+		memcpy(wr_buf, map_parser->cfg_row(row), row_bytes);
 		_jtag->shiftDR(wr_buf, NULL, _cpld_nb_col, Jtag::SHIFT_DR);
 		_jtag->shiftDR(&addr, NULL, _cpld_addr_size);
 		_jtag->toggleClk(delay_loop);
-
-		iter++;
+		progress.display(row);
 	}
+	progress.done();
 
-	/* done bit and usercode are shipped into listfuse
+	/* done bit and usercode are shipped into map
 	 * so only needs to send isc disable
 	 */
 	_jtag->shiftIR(XC2C_ISC_DISABLE, 8);
 
 	if (_verify) {
 		std::string rx_buffer = xc2c_flow_read();
-		iter = 0;
-		for (auto row : listfuse) {
-			for (auto col : row) {
-				if ((rx_buffer[iter >> 3] >> (iter & 0x07)) != col) {
+		uint32_t pos = 0;
+		for (uint16_t row = 0; row < _cpld_nb_row; row++) {
+			const uint8_t *cfg_row = map_parser->cfg_row(row);
+			for (int i = 0; i < _cpld_nb_col; i++, pos++) {
+				uint8_t bit = (cfg_row[i >> 3] >> (i & 0x07)) & 0x01;
+				if (((rx_buffer[pos >> 3] >> (pos & 0x07)) & 0x01) != bit)
 					throw std::runtime_error("Program: verify failed");
-				}
-				iter++;
 			}
 		}
 	}
@@ -1523,21 +1636,29 @@ int Xilinx::spi_put(uint8_t cmd,
 			uint8_t *tx, uint8_t *rx, uint32_t len)
 {
 	int xfer_len = len + 1 + ((rx == NULL) ? 0 : 1);
-	uint8_t jtx[xfer_len];
-	jtx[0] = McsParser::reverseByte(cmd);
-	/* uint8_t jtx[xfer_len] = {McsParser::reverseByte(cmd)}; */
-	uint8_t jrx[xfer_len];
+	uint8_t jcmd = McsParser::reverseByte(cmd);
+	BufferPool::Buffer jtx(len + 1);
+	BufferPool::Buffer jrx(xfer_len);
 	if (tx != NULL) {
 		for (uint32_t i=0; i < len; i++)
-			jtx[i+1] = McsParser::reverseByte(tx[i]);
+			jtx[i] = McsParser::reverseByte(tx[i]);
 	}
+	/* cmd, payload (bridge is MSB first) and, for read, one
+	 * more byte (rx is one bit late)
+	 */
+	uint8_t *rx_ptr = (rx == NULL) ? NULL : jrx.data();
+	jtag_seg_t segs[3] = {
+		{&jcmd, rx_ptr, 8, 0},
+		{(tx == NULL) ? NULL : jtx.data(), (rx_ptr) ? rx_ptr + 1 : NULL, 8 * len, 0},
+		{NULL, (rx_ptr) ? rx_ptr + 1 + len : NULL, (rx_ptr) ? 8u : 0u, 0},
+	};
 	/* addr BSCAN user1 */
-	_jtag->shiftIR(get_ircode(_ircode_map, _user_instruction), NULL, _irlen);
+	_jtag->shiftIR_cached(get_ircode(_ircode_map, _user_instruction), _irlen);
 	/* send first already stored cmd,
 	 * in the same time store each byte
 	 * to next
 	 */
-	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx, 8*xfer_len);
+	_jtag->shiftDR(segs, 3);
 
 	if (rx != NULL) {
 		for (uint32_t i=0; i < len; i++)
@@ -1549,19 +1670,25 @@ int Xilinx::spi_put(uint8_t cmd,
 int Xilinx::spi_put(uint8_t *tx, uint8_t *rx, uint32_t len)
 {
 	int xfer_len = len + ((rx == NULL) ? 0 : 1);
-	uint8_t jtx[xfer_len];
-	uint8_t jrx[xfer_len];
+	BufferPool::Buffer jtx(len + 1);
+	BufferPool::Buffer jrx(xfer_len);
 	if (tx != NULL) {
 		for (uint32_t i=0; i < len; i++)
 			jtx[i] = McsParser::reverseByte(tx[i]);
 	}
+	/* payload and, for read, one more byte (rx is one bit late) */
+	uint8_t *rx_ptr = (rx == NULL) ? NULL : jrx.data();
+	jtag_seg_t segs[2] = {
+		{(tx == NULL) ? NULL : jtx.data(), rx_ptr, 8 * len, 0},
+		{NULL, (rx_ptr) ? rx_ptr + len : NULL, (rx_ptr) ? 8u : 0u, 0},
+	};
 	/* addr BSCAN user1 */
-	_jtag->shiftIR(get_ircode(_ircode_map, _user_instruction), NULL, _irlen);
+	_jtag->shiftIR_cached(get_ircode(_ircode_map, _user_instruction), _irlen);
 	/* send first already stored cmd,
 	 * in the same time store each byte
 	 * to next
 	 */
-	_jtag->shiftDR(jtx, (rx == NULL)? NULL: jrx, 8*xfer_len);
+	_jtag->shiftDR(segs, 2);
 
 	if (rx != NULL) {
 		for (uint32_t i=0; i < len; i++)
@@ -1579,7 +1706,7 @@ int Xilinx::spi_wait(uint8_t cmd, uint8_t mask, uint8_t cond,
 	uint8_t tx = McsParser::reverseByte(cmd);
 	uint32_t count = 0;
 
-	_jtag->shiftIR(get_ircode(_ircode_map, _user_instruction), NULL, _irlen, Jtag::UPDATE_IR);
+	_jtag->shiftIR_cached(get_ircode(_ircode_map, _user_instruction), _irlen, Jtag::UPDATE_IR);
 	_jtag->shiftDR(&tx, NULL, 8, Jtag::SHIFT_DR);
 
 	do {
@@ -1606,6 +1733,19 @@ int Xilinx::spi_wait(uint8_t cmd, uint8_t mask, uint8_t cond,
 	}
 }
 
+JtagStream *Xilinx::open_stream(int channel)
+{
+	const std::string user = "USER" + std::to_string(channel);
+	if (_ircode_map.find(user) == _ircode_map.end()) {
+		printError("JTAG stream: no " + user + " instruction for this device");
+		return NULL;
+	}
+	uint8_t *ircode = get_ircode(_ircode_map, user);
+	return new JtagStream(_jtag, [this, ircode]() {
+			_jtag->shiftIR_cached(ircode, _irlen);
+		}, _verbose);
+}
+
 void Xilinx::select_flash_chip(xilinx_flash_chip_t flash_chip) {
 	switch (flash_chip) {
 	case SECONDARY_FLASH:
@@ -27,12 +27,27 @@ class Xilinx: public Device, SPIInterface {
 				bool skip_load_bridge, bool skip_reset);
 		~Xilinx();
 
-		void program(unsigned int offset, bool unprotect_flash) override;
-		void program_spi(ConfigBitstreamParser * bit, unsigned int offset,
+		bool program(unsigned int offset, bool unprotect_flash) override;
+		bool program_spi(ConfigBitstreamParser * bit, unsigned int offset,
 				bool unprotect_flash);
 		void program_mem(ConfigBitstreamParser *bitfile);
+		/*!
+		 * \brief load a partial bitstream (DFX): no JPROGRAM/JSTART,
+		 *        static part keeps running. STAT is checked after load
+		 * \param[in] bitfile: partial bitstream
+		 */
+		void program_partial(ConfigBitstreamParser *bitfile);
 		bool dumpFlash(uint32_t base_addr, uint32_t len) override;
 
+		/*!
+		 * \brief write partitions with a content different
+		 *        from SPI flash (primary flash only)
+		 */
+		bool program_layout(FlashLayout &layout,
+				bool unprotect_flash) override;
+		void set_verify_repair(bool repair) override {
+			set_spif_repair(repair);
+		}
 		/*!
 		 * \brief protect SPI flash blocks
 		 */
@@ -49,6 +64,12 @@ class Xilinx: public Device, SPIInterface {
 		int idCode() override;
 		void reset() override;
 
+		/*!
+		 * \brief open a byte stream through USER<channel> register
+		 *        (1 and 2 are used by spiOverJtag)
+		 */
+		JtagStream *open_stream(int channel) override;
+
 		/* -------------- */
 		/* xc3s management */
 		/* -------------- */
@@ -151,6 +172,20 @@ class Xilinx: public Device, SPIInterface {
 		virtual bool post_flash_access() override;
 
 	private:
+		/*!
+		 * \brief shift configuration data in DR (CFG_IN must be loaded)
+		 * \param[in] bitfile: bitstream
+		 * \param[in] mess: progress bar message
+		 */
+		void shift_cfg_data(ConfigBitstreamParser *bitfile,
+				const std::string &mess);
+		/*!
+		 * \brief read configuration STAT register
+		 * \param[out] stat: register content
+		 * \return false if CFG_OUT is unknown for this device
+		 */
+		bool read_stat(uint32_t *stat);
+
 		/* list of xilinx family devices */
 		enum xilinx_family_t {
 			XC95_FAMILY     = 0,
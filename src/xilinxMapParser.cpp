@@ -8,127 +8,187 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <sstream>
+#include <memory>
+#include <mutex>
 #include <vector>
 
+#include "display.hpp"
 #include "jedParser.hpp"
 #include "xilinxMapParser.hpp"
 
 using namespace std;
 
+std::map<std::string, std::shared_ptr<const std::vector<int32_t>>>
+	XilinxMapParser::_compiled;
+std::mutex XilinxMapParser::_compiled_mutex;
+
 XilinxMapParser::XilinxMapParser(const string &filename,
 		uint16_t num_row, uint16_t num_col,
 		JedParser *jed, const uint32_t usercode,
 		bool verbose): ConfigBitstreamParser(filename,
 			ConfigBitstreamParser::BIN_MODE, verbose),
-		_num_row(num_row), _num_col(num_col), _usercode(usercode)
+		_num_row(num_row), _num_col(num_col),
+		_row_bytes((num_col + 7) / 8), _usercode(usercode)
 {
 	_jed = jed;
-	_map_table.resize(_num_row);
-	for (int i = 0; i < _num_row; i++)
-		_map_table[i].resize(_num_col);
-	_bit_data.reserve(_num_row * _num_col);
+}
+
+/* the map is independent of jed and usercode: compile it once */
+int XilinxMapParser::parse()
+{
+	const std::string key = _filename + ":" + std::to_string(_num_row) +
+		"x" + std::to_string(_num_col);
+	{
+		std::lock_guard<std::mutex> lock(_compiled_mutex);
+		auto cache = _compiled.find(key);
+		if (cache != _compiled.end())
+			_map = cache->second;
+	}
+
+	if (!_map) {
+		std::shared_ptr<std::vector<int32_t>> map =
+			std::make_shared<std::vector<int32_t>>();
+		if (!compileMap(*map))
+			return EXIT_FAILURE;
+		std::lock_guard<std::mutex> lock(_compiled_mutex);
+		_compiled[key] = map;
+		_map = map;
+	}
+
+	return (jedApplyMap()) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 /* extract info from map file
  * see XILINX PROGRAMMER QUALIFICATION SPECIFICATION 4.4.1
+ * each line is a column, each tab separated field a row. Rows are
+ * sent last column first: compiled map is stored in sending order
  */
-int XilinxMapParser::parse()
+bool XilinxMapParser::compileMap(std::vector<int32_t> &map)
 {
+	map.assign(_num_row * _num_col, 0);
+
+	const char *p = _raw_data.data();
+	const char *end = p + _raw_data.size();
 	int col = 0;
-	std::stringstream ss;
-	ss.str(_raw_data);
-	std::string line;
 
-	while(std::getline(ss, line, '\n')) {
+	while (p < end) {
+		const char *eol = static_cast<const char *>(memchr(p, '\n', end - p));
+		if (!eol)
+			eol = end;
+		/* suppress potential '\r' (thanks windows) */
+		const char *line_end = (eol > p && eol[-1] == '\r') ? eol - 1 : eol;
+		if (col >= _num_col) {
+			printError("map: more columns than device size");
+			return false;
+		}
+
 		bool empty = true;  // to said if line contains only '\t' (empty)
 		                    // or one or more blank in a non empty line
-		size_t prev_pos = 0, next_pos;
 		int row = 0;
-		/* suppress potential '\r' (thanks windows) */
-		if (line.back() == '\r')
-			line.pop_back();
-
-		do {
-			int map_val = 0;
-			next_pos = line.find_first_of('\t', prev_pos);
-			size_t end_pos = (next_pos == std::string::npos) ? line.size():next_pos;
-			if (end_pos == prev_pos) { /* blank (transfer) bit ('\t') */
-				if (empty)  // no data before
-					map_val = BIT_ZERO;
-				else  // blank into non empty line
-					map_val = BIT_ONE;
+		const char *field = p;
+		while (true) {
+			const char *tab = static_cast<const char *>(
+				memchr(field, '\t', line_end - field));
+			const char *field_end = (tab) ? tab : line_end;
+			size_t len = field_end - field;
+			int32_t map_val;
+
+			if (len == 0) {  /* blank (transfer) bit ('\t') */
+				map_val = (empty) ? BIT_ZERO : BIT_ONE;
 			} else {
 				empty = false;  // current line is not fully empty
-				int len = end_pos - prev_pos;  // section len
-				string cnt = line.substr(prev_pos, len);  // line substring
-				if (cnt[0] <= '9' && cnt[0] >= '0') {  // numeric value (index)
-					map_val = std::stoi(cnt, nullptr, 10);
-				} else {  // information (done, spare, user, ...)
-					if (!strncmp(cnt.c_str(), "spare", 5)) {
-						map_val = BIT_ONE;
-					} else if (!strncmp(cnt.c_str(), "sec_", 4)) {
-						map_val = BIT_ONE;
-					/* done is known don't wait for fuse array construct */
-					} else if (!strncmp(cnt.c_str(), "done", 4)) {
-						map_val = (cnt[5] == '0') ? BIT_ONE: BIT_ZERO;
-					/* fill usercode now instead of waiting for fuse placement */
-					} else if (!strncmp(cnt.c_str(), "user", 4)) {
-						int idx = stoi(cnt.substr(5));
-						map_val = ((_usercode >> idx) & 0x01) ? BIT_ONE : BIT_ZERO;
-					} else {
-						printf("unknown %s %s\n", cnt.c_str(), line.c_str());
+				if (*field >= '0' && *field <= '9') {  // index
+					map_val = 0;
+					for (const char *c = field; c < field_end &&
+							*c >= '0' && *c <= '9'; c++)
+						map_val = map_val * 10 + (*c - '0');
+				} else if (len >= 5 && !strncmp(field, "spare", 5)) {
+					map_val = BIT_ONE;
+				} else if (len >= 4 && !strncmp(field, "sec_", 4)) {
+					map_val = BIT_ONE;
+				} else if (len >= 4 && !strncmp(field, "done", 4)) {
+					map_val = (len > 5 && field[5] == '0') ? BIT_ONE : BIT_ZERO;
+				} else if (len > 5 && !strncmp(field, "user", 4)) {
+					int idx = atoi(field + 5);
+					if (idx < 0 || idx > 31) {
+						printError("map: invalid usercode bit " +
+							string(field, len));
 						return false;
 					}
+					map_val = BIT_USER - idx;
+				} else {
+					printError("map: unknown " + string(field, len) + " in " +
+						string(p, line_end - p));
+					return false;
 				}
 			}
-			_map_table[row][col] = map_val;
+
+			if (row >= _num_row) {
+				printError("map: more rows than device size");
+				return false;
+			}
+			map[row * _num_col + (_num_col - 1 - col)] = map_val;
 			row++;
-			prev_pos = next_pos + 1;
-		} while (next_pos != std::string::npos);
+			if (!tab)
+				break;
+			field = tab + 1;
+		}
 
 		col++;  // update col after parsing each line
+		p = eol + 1;
 	}
 
-	return jedApplyMap();
+	return true;
 }
 
 /* cfg_data build.
- * for fuse(x,y) set to 0, 1 or jed value (when map_data contains offset)
- * usercode and done bits are set to 0 or 1 at parse step
+ * for fuse(x,y) set to 0, 1, usercode bit or jed value (when map
+ * contains an offset). Bits are gathered into a Byte before
+ * being stored
  */
 bool XilinxMapParser::jedApplyMap()
 {
-	std::string listfuse = _jed->get_fuselist();
-	std::string tmp;
-	int row = 0;
-
-	tmp.reserve(_map_table[0].size());
-	_cfg_data.clear();
-	_cfg_data.resize(_map_table.size());
-
-	for (auto & fuse_row : _map_table) {
-		tmp.clear();
-		for (auto &map_bit : fuse_row) {
-			int32_t map_val = map_bit;
-			uint8_t bit_val;
-			switch (map_val) {
-				case BIT_ZERO:
-					bit_val = 0;
-					break;
-				case BIT_ONE:
-					bit_val = 1;
-					break;
-				default:  // map_val is an offset: get bit value from jed
-					bit_val = listfuse[map_val] - '0';
+	const std::string &listfuse = _jed->get_fuselist();
+	const int32_t nb_fuses = listfuse.size();
+	const char *fuses = listfuse.data();
+
+	/* constant bits indexed by -map_val */
+	uint8_t consts[1 - BIT_USER + 32];
+	consts[0] = 0;
+	consts[-BIT_ZERO] = 0;
+	consts[-BIT_ONE] = 1;
+	for (int i = 0; i < 32; i++)
+		consts[-BIT_USER + i] = (_usercode >> i) & 0x01;
+
+	_cfg_data.assign(_num_row * _row_bytes, 0);
+	const int32_t *map = _map->data();
+
+	for (int row = 0; row < _num_row; row++) {
+		const int32_t *map_row = map + row * _num_col;
+		uint8_t *out = &_cfg_data[row * _row_bytes];
+		for (int col = 0; col < _num_col; col += 8) {
+			int nb = min(8, _num_col - col);
+			uint8_t byte = 0;
+			for (int i = 0; i < nb; i++) {
+				int32_t map_val = map_row[col + i];
+				uint8_t bit_val;
+				if (map_val >= 0) {
+					if (map_val >= nb_fuses) {
+						printError("map: fuse " + std::to_string(map_val) +
+							" not in jed");
+						return false;
+					}
+					/* '0' or '1' */
+					bit_val = fuses[map_val] & 0x01;
+				} else {
+					bit_val = consts[-map_val];
+				}
+				byte |= bit_val << i;
 			}
-			tmp += bit_val;
-			_bit_length++;
+			out[col >> 3] = byte;
 		}
-		/* insert each row in back order (last bit 1st to send) */
-		std::copy(tmp.rbegin(), tmp.rend(), std::back_inserter(_cfg_data[row]));
-		row++;
 	}
+	_bit_length = _num_row * _num_col;
 
 	return true;
 }
@@ -7,6 +7,9 @@
 
 #include <stdint.h>
 
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -16,7 +19,10 @@
 /*!
  * \file xilinxMapParser.hpp
  * \class XilinxMapParser (based on "XILINX PROGRAMMER QUALIFICATION SPECIFICATION ")
- * \brief xilinx map parser. Used to place jed content into flash memory order
+ * \brief xilinx map parser. Used to place jed content into flash memory order.
+ *        The map is compiled once by process (for a file and device size)
+ *        into a table giving, for each bit of each row in sending order,
+ *        a jed fuse offset or a constant/usercode bit
  * \author Gwenhael Goavec-Merou
  */
 
@@ -37,36 +43,57 @@ class XilinxMapParser: public ConfigBitstreamParser {
 				const uint32_t usercode, bool verbose = false);
 
 		/*!
-		 * \brief parse map file to construct _map_table and call jedApplyMap
-		 * \return false for unknown code, true otherwise
+		 * \brief compile map file (if not already done) and call jedApplyMap
+		 * \return EXIT_FAILURE for unknown code or out of range index,
+		 *         EXIT_SUCCESS otherwise
 		 */
 		int parse() override;
 
 		/*!
-		 * \brief return 2 dimension configuration data reorganized
-		 *        according to map file
-		 * \return configuration data array
+		 * \brief configuration data row reorganized according to map
+		 *        file: num_col bits packed LSB first, in sending order
+		 * \param[in] row: row index
+		 * \return row_bytes() Bytes
+		 */
+		const uint8_t *cfg_row(int row) const {
+			return &_cfg_data[row * _row_bytes];
+		}
+		/*!
+		 * \brief row size (Byte)
 		 */
-		std::vector<std::string> cfg_data() { return _cfg_data;}
+		int row_bytes() const {return _row_bytes;}
 
 	private:
 		/*!
-		 * \brief build _cfg_data by using cfg_data content.
-		 * \return false for unknown code in map, true otherwise
+		 * \brief build compiled map from map file content
+		 * \return false for unknown code, true otherwise
+		 */
+		bool compileMap(std::vector<int32_t> &map);
+		/*!
+		 * \brief build _cfg_data by using jed content and compiled map.
+		 * \return false when map refers to a fuse not in jed
 		 */
 		bool jedApplyMap();
 
+		/* compiled map values, >= 0: jed fuse offset */
 		enum {
 			BIT_ZERO  = -1,  /* empty bit with only blank before ie '\t' */
 			BIT_ONE   = -2,  /* empty bit with non blank before */
+			BIT_USER  = -3,  /* usercode bit n: BIT_USER - n */
 		};
 
-		std::vector<std::vector<int>> _map_table; /**< map array */
+		std::shared_ptr<const std::vector<int32_t>> _map; /**< compiled map */
 		JedParser *_jed; /**< raw jed content */
 		uint16_t _num_row; /**< bitstream number of row */
 		uint16_t _num_col; /**< bitsteam number of col */
+		int _row_bytes; /**< packed row size */
 		uint32_t _usercode; /**< usercode to add into corresponding area */
-		std::vector<std::string> _cfg_data; /**< fuse array after built */
+		std::vector<uint8_t> _cfg_data; /**< packed fuse array after built */
+
+		/* compiled maps: "filename:rowsxcols" -> map */
+		static std::map<std::string,
+			std::shared_ptr<const std::vector<int32_t>>> _compiled;
+		static std::mutex _compiled_mutex;
 };
 
 #endif  // SRC_XILINXMAPPARSER_HPP_